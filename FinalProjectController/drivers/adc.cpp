@@ -2,10 +2,20 @@
 /** @file adc.cpp
  *    This file contains a very simple A/D converter driver. This driver should be
  *
+ *    A list of channels can also be scanned by the A/D conversion complete
+ *    interrupt, which saves each result with a time stamp so that tasks never have
+ *    to wait for a conversion. Each scanned channel can be oversampled by adding up
+ *    many readings in the ISR, giving results with more bits of resolution.
+ *
  *  Revisions:
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR Added interrupt driven scanning of a list of channels
+ *    @li 10-16-2026 ERR Added oversampling and decimation of scanned channels
+ *    @li 10-16-2026 ERR read_once() converts directly until a scanned reading exists
+ *    @li 10-16-2026 ERR ADIF cleared before scanning; A/D clock 125 kHz in both modes
+ *    @li 10-16-2026 ERR Added read_full() to get oversampled readings at full width
  *
  *  License:
  *    This file is copyright 2015 by JR Ridgely and released under the Lesser GNU 
@@ -25,11 +35,56 @@
 
 #include <stdlib.h>                         // Include standard library header files
 #include <avr/io.h>
+#include <avr/interrupt.h>                  // For the A/D conversion complete ISR
+#include <avr/cpufunc.h>                    // For _MemoryBarrier()
 
 #include "rs232int.h"                       // Include header for serial port class
 #include "adc.h"                            // Include header for the A/D class
 
 
+/** @brief   The latest two readings from one channel which is being scanned.
+ *  @details The ISR writes each new reading into the half of the buffer which isn't
+ *           the latest one, then increments @c sequence, so the lowest bit of
+ *           @c sequence tells which half holds the latest reading. A task which was
+ *           interrupted while copying a reading sees that @c sequence has changed
+ *           and copies it again, as is done in @c TaskShare::get(). A @c sequence of
+ *           zero means the channel hasn't been read yet. When the channel is being
+ *           oversampled, readings are added into @c accumulator, and a result is only
+ *           put in the buffer when @c count reaches 4^extra_bits.
+ */
+
+struct adc_channel_buffer
+{
+    adc_sample sample[2];                   ///< The two halves of the buffer
+    volatile uint8_t sequence;              ///< Count of results put in the buffer
+    uint32_t accumulator;                   ///< Sum of readings for the next result
+    uint16_t count;                         ///< Number of readings in the sum
+    uint8_t extra_bits;                     ///< Extra bits of resolution, n
+};
+
+/// Buffers holding the latest reading from each channel, found by channel number
+static adc_channel_buffer scan_buffers[ADC_SCAN_MAX];
+
+/// The channels being scanned, in the order in which they're read
+static uint8_t scan_list[ADC_SCAN_MAX];
+
+/// The number of channels in @c scan_list, or zero if no scan is running
+static volatile uint8_t scan_count = 0;
+
+/// Index in @c scan_list of the channel whose conversion is in progress
+static volatile uint8_t scan_index = 0;
+
+/// What starts each conversion during the scan
+static volatile adc_trigger scan_trigger = ADC_SCAN_CONTINUOUS;
+
+/// The number of times the whole list of channels has been read
+static volatile uint32_t scan_passes = 0;
+
+/// Mask for the bits in @c ADMUX which select the channel
+#define ADC_MUX_MASK        ((1 << MUX4) | (1 << MUX3) | (1 << MUX2) | (1 << MUX1) \
+                             | (1 << MUX0))
+
+
 //-------------------------------------------------------------------------------------
 /** @brief This constructor sets up an A/D converter. 
  *  @details This constructor takes the pointer given to it and initializes itself. Also, here we set the voltage refrence and enable the A/D converter as well as set the prescaler to 32, through some bitshifting.
@@ -56,7 +111,7 @@ adc::adc (emstream* p_serial_port)
 
 //-------------------------------------------------------------------------------------
 /** @brief   This method takes one A/D reading from the given channel and returns it. 
- *  @details Given a channel, this method first checks to make sure only valid channels are accepted by setting any outside parameter to channel 0. Then we set the correct register to enable the A/D and use a while loop to wait until the completion bit is 0. At that point, the loop breaks and the results stored in ADCL and ADCH are concatenated into the 16 bit return value.
+ *  @details Given a channel, this method first checks to make sure only valid channels are accepted by setting any outside parameter to channel 0. Then we set the correct register to enable the A/D and use a while loop to wait until the completion bit is 0. At that point, the loop breaks and the results stored in ADCL and ADCH are concatenated into the 16 bit return value. If a scan is running, the latest scanned reading is returned right away instead, scaled to 10 bits if the channel is oversampled. A channel which isn't being scanned, or which hasn't been read by the scan yet (an oversampled channel takes 4^n conversions to give its first result, and none are made before interrupts are turned on), is read directly: the scan is stopped for the one conversion and then started again, which takes about 200 us.
  *  @param   ch The A/D channel which is being read must be from 0 to 7
  *  @return  ADC_value, the 16 bit returned value of the concatendated High and Low results.
  */
@@ -68,6 +123,25 @@ uint16_t adc::read_once (uint8_t ch)
 
     //channel entry valid check
     if(ch > 7){ ch = 0; }
+
+    // While a scan is running the converter belongs to the ISR, so give back the
+    // latest scanned reading if there is one
+    uint8_t paused_count = scan_count;
+    if (paused_count)
+    {
+        adc_sample sample;
+        if (is_scanned (ch) && get_latest (ch, sample))
+        {
+            // An oversampled result is scaled back to 10 bits for the old callers
+            ADC_value = sample.value >> sample.extra_bits;
+            return ADC_value;
+        }
+
+        // Otherwise take the converter back from the ISR for one direct reading.
+        // The list of channels isn't changed by stopping, so it's used to restart
+        stop_scan ();
+    }
+
     //clear the mux reg we're sure that it starts at 000
     ADMUX &= ~(7<<MUX0);
     //set the mux
@@ -85,12 +159,21 @@ uint16_t adc::read_once (uint8_t ch)
 
     //combine the high and low bits using casting technique shown in class
     ADC_value = ((uint16_t) ADCL | (uint16_t) ADCH<<8);
+
+    // The finished conversion set ADIF; clear it so the scan's ISR doesn't see it
+    ADCSRA |= 1<<ADIF;
+
+    if (paused_count)
+    {
+        start_scan (scan_list, paused_count, scan_trigger);
+    }
     return ADC_value;
 }
 
 
 //-------------------------------------------------------------------------------------
 /** @brief   This method takes multiple readings specified by an input parameter from a particular channel and return the average of those readings.
+ *  @details The readings are added in a 32-bit sum so that any number of them up to 255 can be averaged. While a scan is running this would only average the same scanned reading over and over, so the latest reading is returned at once; oversampling the channel with @c set_oversampling() does the averaging in the background instead.
  *  @param   channel this parameter specifies which channel we're going to be averaging
  *  @param   samples this specifies how many samples we're going to be taking and serves as the basis for our average division.
  *  @return  average_result, this is the average value read over that channel per those samples.
@@ -100,12 +183,15 @@ uint16_t adc::read_oversampled (uint8_t channel, uint8_t samples)
 {
     // DBG (ptr_to_serial, "All your readings are belong to us" << endl);
 
-    // 16 bits for the average result 
-    uint16_t total_result =0;
+    // 32 bits for the total so it can't overflow
+    uint32_t total_result =0;
     uint16_t average_result =0;
 
-    //setting the limit to not overflow our 16 bit variable
-    if(samples > 64){ samples = 64; }
+    //the scanner has already done the work, if it's running
+    if (scan_count || samples == 0)
+    {
+        return read_once(channel);
+    }
 
     //sum the values of each channel read over the entire sample area
     for(uint8_t i=0; i < samples; i++)
@@ -136,12 +222,293 @@ uint16_t adc::read_oversampled (uint8_t channel, uint8_t samples)
 emstream& operator << (emstream& serpt, adc& a2d)
 {
     // Prints info to the serial port
-    serpt << PMS ("Current Channel Readings: ")<<endl
-        
+    serpt << PMS ("Current Channel Readings: ")<<endl;
+
+    // Show the latest reading of each channel being scanned
+    adc_sample sample;
+    for (uint8_t ch = 0; ch < ADC_SCAN_MAX; ch++)
+    {
+        if (a2d.is_scanned (ch) && a2d.get_latest (ch, sample))
+        {
+            serpt << PMS ("  ch ") << ch << PMS (": ") << sample.value << PMS (" (")
+                  << (uint8_t)(10 + sample.extra_bits) << PMS (" bits)") << endl;
+        }
+    }
+    serpt << PMS ("Scans: ") << a2d.get_scan_count () << endl
           << PMS ("End Print Data")<<endl;
 
+    return (serpt);
+}
 
 
-    return (serpt);
+//-------------------------------------------------------------------------------------
+/** @brief   Begin scanning a list of channels from the A/D interrupt.
+ *  @details Each channel in the list is read in turn, over and over, by the A/D
+ *           conversion complete interrupt. With @c ADC_SCAN_CONTINUOUS, the ISR
+ *           starts the next conversion as soon as one finishes; the prescaler is set
+ *           to 128 for this, giving a 125 kHz A/D clock and a conversion about every
+ *           104 us, which is within the converter's rated 200 kHz clock for full
+ *           accuracy and keeps the ISR from taking too much of the processor's time.
+ *           With a timer trigger, one channel is read at each compare match, so the
+ *           timer sets the sample rate; the timer must already be running, and the
+ *           prescaler is set to 128 as well, so the timer can't ask for conversions
+ *           more often than about every 104 us. A scan
+ *           which is already running is stopped before the new one starts.
+ *  @param   channels An array of channel numbers from 0 to 7
+ *  @param   count The number of channels in the array, at most @c ADC_SCAN_MAX
+ *  @param   trigger What starts each conversion
+ */
+
+void adc::start_scan (const uint8_t* channels, uint8_t count, adc_trigger trigger)
+{
+    stop_scan ();
+
+    if (count > ADC_SCAN_MAX)
+    {
+        count = ADC_SCAN_MAX;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    for (uint8_t index = 0; index < count; index++)
+    {
+        scan_list[index] = channels[index] & 0x07;
+    }
+
+    portENTER_CRITICAL ();
+    scan_index = 0;
+    scan_trigger = trigger;
+    scan_count = count;
+
+    ADMUX = (ADMUX & ~ADC_MUX_MASK) | scan_list[0];
+    ADCSRB &= ~((1 << MUX5) | (1 << ADTS2) | (1 << ADTS1) | (1 << ADTS0));
+    ADCSRA |= (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+
+    // A conversion made before the scan leaves ADIF set, and the ISR would take its
+    // result as the first channel's; writing a one to the flag clears it
+    ADCSRA |= (1 << ADIF);
+    if (trigger == ADC_SCAN_CONTINUOUS)
+    {
+        ADCSRA |= (1 << ADIE) | (1 << ADSC);
+    }
+    else
+    {
+        ADCSRB |= trigger << ADTS0;
+        ADCSRA |= (1 << ADATE) | (1 << ADIE);
+    }
+    portEXIT_CRITICAL ();
+
+    DBG (ptr_to_serial, "A/D scanning " << count << " channels" << endl);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Stop scanning channels.
+ *  @details The interrupt and auto trigger are turned off, then this method waits for
+ *           any conversion in progress to finish, which takes at most about 100 us,
+ *           so that a following call to @c read_once() finds the converter idle. The
+ *           latest readings stay in their buffers.
+ */
+
+void adc::stop_scan (void)
+{
+    portENTER_CRITICAL ();
+    ADCSRA &= ~((1 << ADIE) | (1 << ADATE));
+    scan_count = 0;
+    portEXIT_CRITICAL ();
+
+    while (ADCSRA & (1 << ADSC))
+    {
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Check whether a channel is in the list being scanned.
+ *  @param   channel The channel number, from 0 to 7
+ *  @return  True if a scan is running and it includes the given channel
+ */
+
+bool adc::is_scanned (uint8_t channel)
+{
+    for (uint8_t index = 0; index < scan_count; index++)
+    {
+        if (scan_list[index] == channel)
+        {
+            return (true);
+        }
+    }
+    return (false);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get the latest scanned reading from a channel without waiting.
+ *  @details The reading is copied from whichever half of the channel's double buffer
+ *           holds the latest one. If the ISR puts a new reading in while it's being
+ *           copied, the copy is made again; the ISR only writes to the other half, so
+ *           this rarely happens and never more than once per conversion.
+ *  @param   channel The channel number, from 0 to 7
+ *  @param   sample A reference to a sample into which the reading is copied
+ *  @return  True if the channel has been read at least once, false if not
+ */
+
+bool adc::get_latest (uint8_t channel, adc_sample& sample)
+{
+    adc_channel_buffer& buffer = scan_buffers[channel & 0x07];
+    uint8_t sequence;
+
+    do
+    {
+        sequence = buffer.sequence;
+        _MemoryBarrier ();
+        sample = buffer.sample[sequence & 0x01];
+        _MemoryBarrier ();
+    }
+    while (sequence != buffer.sequence);
+
+    return (sequence != 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Read a channel with all the resolution which oversampling gives it.
+ *  @details @c read_once() scales oversampled readings back to 10 bits for the code
+ *           which was written before scanning, which throws away the extra bits.
+ *           This method returns the latest scanned result as it is, 10 + n bits
+ *           wide, and tells the caller what n is so the reading can be scaled once,
+ *           at the end of the caller's arithmetic. A channel which isn't being
+ *           scanned, or hasn't been read by the scan yet, is read by @c read_once()
+ *           and has no extra bits.
+ *  @param   channel The channel number, from 0 to 7
+ *  @param   extra_bits A reference to a byte which is set to the number of bits
+ *           of resolution the reading has above 10 bits
+ *  @return  The reading, from 0 to 2^(10 + @c extra_bits) - 1
+ */
+
+uint16_t adc::read_full (uint8_t channel, uint8_t& extra_bits)
+{
+    adc_sample sample;
+
+    if (is_scanned (channel) && get_latest (channel, sample))
+    {
+        extra_bits = sample.extra_bits;
+        return (sample.value);
+    }
+    extra_bits = 0;
+    return (read_once (channel));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Set the number of extra bits of resolution made by oversampling a channel.
+ *  @details To get n more bits of resolution, 4^n readings are added together and
+ *           the sum is shifted right by n bits; this works when there's at least a
+ *           little noise on the signal, as there nearly always is. The ISR does all
+ *           of this, so tasks just get 10 + n bit results from @c get_latest(). Each
+ *           result is published after 4^n readings of its channel, so a channel's
+ *           output rate is fixed by the conversion rate, the number of channels
+ *           scanned and n. For example, scanning two channels continuously at about
+ *           9600 conversions per second with n = 2 gives 12-bit results from each
+ *           channel about 300 times per second. Any partial sum is thrown away.
+ *  @param   channel The channel number, from 0 to 7
+ *  @param   extra_bits The number of extra bits, from 0 to @c ADC_MAX_EXTRA_BITS
+ */
+
+void adc::set_oversampling (uint8_t channel, uint8_t extra_bits)
+{
+    if (extra_bits > ADC_MAX_EXTRA_BITS)
+    {
+        extra_bits = ADC_MAX_EXTRA_BITS;
+    }
+
+    adc_channel_buffer& buffer = scan_buffers[channel & 0x07];
+    portENTER_CRITICAL ();
+    buffer.extra_bits = extra_bits;
+    buffer.accumulator = 0;
+    buffer.count = 0;
+    portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get the number of times the whole list of channels has been read.
+ *  @details This count can be used to check that a scan is running and to find the
+ *           actual sample rate.
+ *  @return  The number of complete passes through the list since the program began
+ */
+
+uint32_t adc::get_scan_count (void)
+{
+    portENTER_CRITICAL ();
+    uint32_t passes = scan_passes;
+    portEXIT_CRITICAL ();
+
+    return (passes);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Interrupt service routine for the A/D conversion complete interrupt.
+ *  @details The reading is added to its channel's accumulator. When enough readings
+ *           have been added up, their decimated sum is put into the free half of the
+ *           channel's buffer with the time of the last reading, and then, whether or
+ *           not a result was published, the multiplexer is set to the next
+ *           channel in the list. In continuous mode the next conversion is started
+ *           here; in timer triggered mode, the timer's compare flag is cleared so
+ *           that its next compare match starts the next conversion. A new channel
+ *           selected in @c ADMUX takes effect when the next conversion begins.
+ */
+
+ISR (ADC_vect)
+{
+    // ADCL must be read first; reading it locks ADCH until ADCH is read
+    uint16_t value = ADCL;
+    value |= (uint16_t)ADCH << 8;
+
+    adc_channel_buffer& buffer = scan_buffers[scan_list[scan_index]];
+    buffer.accumulator += value;
+
+    // Publish a result when 4^n readings, or 1 << 2n, have been added up
+    if (++buffer.count >= ((uint16_t)1 << (buffer.extra_bits << 1)))
+    {
+        uint8_t next = buffer.sequence + 1;
+
+        // Sequence zero means no readings; skip it when the count wraps around
+        if (next == 0)
+        {
+            next = 2;
+        }
+        adc_sample& sample = buffer.sample[next & 0x01];
+        sample.value = (uint16_t)(buffer.accumulator >> buffer.extra_bits);
+        sample.time = get_raw_time_ISR ();
+        sample.extra_bits = buffer.extra_bits;
+        _MemoryBarrier ();
+        buffer.sequence = next;
+
+        buffer.accumulator = 0;
+        buffer.count = 0;
+    }
+
+    if (++scan_index >= scan_count)
+    {
+        scan_index = 0;
+        scan_passes++;
+    }
+    ADMUX = (ADMUX & ~ADC_MUX_MASK) | scan_list[scan_index];
+
+    if (scan_trigger == ADC_SCAN_CONTINUOUS)
+    {
+        ADCSRA |= (1 << ADSC);
+    }
+    else if (scan_trigger == ADC_SCAN_TIMER0_COMPA)
+    {
+        TIFR0 = (1 << OCF0A);
+    }
+    else
+    {
+        TIFR1 = (1 << OCF1B);
+    }
 }
 
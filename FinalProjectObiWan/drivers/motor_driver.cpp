@@ -9,7 +9,9 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @ 4/23/2016 removed bitops.h library
+ *  Revisions: @ 10/16/2026 ERR set_power and brake made virtual for
+ *             motor_driver_pins
+ *             @ 4/23/2016 removed bitops.h library
  *             @ 4/16/2016 added bitops.h library for setting unsetting bits
  *             @ 4/12/2016 main structure created
  *  License:
@@ -8,7 +8,11 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @ 5/4/2016 <<EDD>> created.
+ *  Revisions: @ 10/16/2026 ERR pulse widths are committed once per PWM
+ *             period by the timer overflow ISR, with optional slew limiting
+ *             @ 10/16/2026 ERR setServoAngle made virtual for
+ *             servo_driver_pins
+ *             @ 5/4/2016 <<EDD>> created.
  *  License:
  *    This file is copyright 2016 by Eddie Ruano and released under the Lesser
  *    GNU
@@ -37,6 +41,7 @@
 // Include standard library header files
 #include <stdlib.h>
 #include <avr/io.h>
+#include <avr/interrupt.h>
 // Include header for serial port class
 #include "rs232int.h"
 // Include header for the driver class
@@ -47,6 +52,12 @@
 
 #define STOP 0
 #define CONTINUE 1
+
+// The servos whose pulse widths are updated by the Timer 3 overflow ISR
+static servo_driver* servo_list[SERVO_MAX];
+// How many servos are in servo_list
+static uint8_t servo_count = 0;
+
 /**
  * @brief      This is the constuctor for the imu_driver class.
  * @details    This constructor takes in several addresses and delivers them
@@ -91,6 +102,11 @@ servo_driver::servo_driver (
     local_top_ICR = top_ICR_inc;
     local_OCR_pin = OCR_pin_inc;
 
+    target_pulse = 0;
+    current_pulse = 0;
+    slew_limit = 0;
+    started = false;
+
     // Do all the cool stuff in this method.
 
     initializeServo();
@@ -151,6 +167,16 @@ void servo_driver::initializeServo(void)
     //set pin as output
     DDRE |= (1 << local_OCR_pin);
 
+    // join the servos updated by the overflow ISR, which runs once per period
+    // at BOTTOM, so every new pulse width starts with a whole pulse
+    portENTER_CRITICAL ();
+    if (servo_count < SERVO_MAX)
+    {
+        servo_list[servo_count++] = this;
+    }
+    TIMSK3 |= (1 << TOIE3);
+    portEXIT_CRITICAL ();
+
 
 
     // /// now need to initialize and get correct values of the joysticks
@@ -162,15 +188,99 @@ void servo_driver::initializeServo(void)
     // }
 }
 
+/**
+ * @brief      Asks for a new servo pulse width.
+ * @details    The pulse width isn't written to OCR here; the Timer 3 overflow
+ *             ISR does that once per 20 ms period, only when it has changed,
+ *             so tasks can call this as often as they like for free.
+ *
+ * @param[in]  angle  The pulse width in timer counts, 1000 to 2000 for 1 ms
+ *                    to 2 ms pulses
+ */
 void servo_driver::setServoAngle(int16_t angle)
 {
-    //going to change PWM
     //need to change OCR but keep between 1000 and 2000 for 1ms and 2ms pulses
-    *local_OCR_reg = angle;
+    //the ISR reads both bytes, so don't let it in halfway through
+    portENTER_CRITICAL ();
+    target_pulse = angle;
+    started = true;
+    portEXIT_CRITICAL ();
     return;
 }
 
 
+/**
+ * @brief      Sets the largest change in pulse width per PWM period.
+ * @details    A large step can make a servo slam into position and draw a big
+ *             current spike; with a limit the ISR moves the pulse width toward
+ *             the target a little each period instead.
+ *
+ * @param[in]  counts_per_period  The largest change per 20 ms, in timer
+ *                                counts, or 0 to jump straight to the target
+ */
+void servo_driver::set_slew (uint16_t counts_per_period)
+{
+    portENTER_CRITICAL ();
+    slew_limit = counts_per_period;
+    portEXIT_CRITICAL ();
+}
+
+
+/**
+ * @brief      Writes a pulse width to the compare register.
+ *
+ * @param[in]  pulse  The pulse width in timer counts
+ */
+void servo_driver::write_pulse (uint16_t pulse)
+{
+    *local_OCR_reg = pulse;
+}
+
+
+/**
+ * @brief      Moves the pulse width toward its target.
+ * @details    This is called only by the overflow ISR, once per period. If
+ *             the target hasn't changed nothing is written. The first target
+ *             is written straight away, since there's no old position to
+ *             slew from.
+ */
+void servo_driver::update_isr (void)
+{
+    if (!started || current_pulse == target_pulse)
+    {
+        return;
+    }
+
+    uint16_t next = target_pulse;
+    if (slew_limit != 0 && current_pulse != 0)
+    {
+        if (next > current_pulse + slew_limit)
+        {
+            next = current_pulse + slew_limit;
+        }
+        else if (next + slew_limit < current_pulse)
+        {
+            next = current_pulse - slew_limit;
+        }
+    }
+    current_pulse = next;
+    write_pulse (next);
+}
+
+
+/**
+ * @brief      This is the Timer 3 overflow interrupt, which commits the new
+ *             pulse widths of all the servos once per PWM period.
+ */
+ISR(TIMER3_OVF_vect)
+{
+    for (uint8_t index = 0; index < servo_count; index++)
+    {
+        servo_list[index]->update_isr ();
+    }
+}
+
+
 /**
  * @brief                     This overloaded operator prints information
  *                            about a imu driver.
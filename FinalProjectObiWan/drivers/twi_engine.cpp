@@ -0,0 +1,560 @@
+//*************************************************************************************
+/** \file twi_engine.cpp
+ *    This file contains the source code for an interrupt driven driver for the TWI
+ *    (I2C) port on an AVR. Transactions are kept in a queue and carried out, one
+ *    byte at a time, by the TWI interrupt service routine. 
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It is intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+
+#include <avr/io.h>                         // Port I/O for SFR's
+#include <avr/interrupt.h>                  // For using interrupt service routines
+#include <util/twi.h>                       // Names of TWI status codes
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // FreeRTOS task functions
+#include "twi_engine.h"                     // Header for this file
+
+
+/// The bits written to TWCR to go on to the next step with the interrupt enabled
+#define TWI_GO          ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+
+
+/// Pointer to the one TWI engine, used by the TWI interrupt service routine
+twi_engine* p_twi_engine = NULL;
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Create an empty transaction.
+ *  @details The transaction's semaphore is made here, because a task usually keeps
+ *           one transaction object and uses it over and over. Transactions which are
+ *           only ever checked with @c status don't need a semaphore.
+ *  @param   make_semaphore True (the default) to make a semaphore for @c transfer()
+ */
+
+twi_transaction::twi_transaction (bool make_semaphore)
+{
+	address = 0;
+	send_reg = false;
+	reg = 0;
+	write_count = 0;
+	p_write = NULL;
+	read_count = 0;
+	p_read = NULL;
+	one_byte = 0;
+	status = TWI_OK;
+	queue_time = start_time = end_time = 0;
+	p_next = NULL;
+
+	done = make_semaphore ? xSemaphoreCreateBinary () : NULL;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Set up a transaction which writes one byte to a register in a device.
+ *  @param   addr The 7-bit bus address of the device
+ *  @param   a_reg The address of the register within the device
+ *  @param   data The byte to be written, which is copied into the transaction
+ */
+
+void twi_transaction::set_write_reg (uint8_t addr, uint8_t a_reg, uint8_t data)
+{
+	one_byte = data;
+	set_write (addr, a_reg, &one_byte, 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Set up a transaction which writes bytes to consecutive registers.
+ *  @details Most devices step to the next register after each byte is written, so
+ *           this writes @c count registers beginning with @c a_reg.
+ *  @param   addr The 7-bit bus address of the device
+ *  @param   a_reg The address of the first register to be written
+ *  @param   p_data Pointer to the bytes to be written
+ *  @param   count The number of bytes to be written
+ */
+
+void twi_transaction::set_write (uint8_t addr, uint8_t a_reg, const uint8_t* p_data,
+								 uint8_t count)
+{
+	address = addr;
+	send_reg = true;
+	reg = a_reg;
+	p_write = p_data;
+	write_count = count;
+	p_read = NULL;
+	read_count = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Set up a transaction which reads bytes from consecutive registers.
+ *  @details The register address is written, then a repeated start turns the bus
+ *           around and @c count bytes are read, the last one with a NACK.
+ *  @param   addr The 7-bit bus address of the device
+ *  @param   a_reg The address of the first register to be read
+ *  @param   p_data Pointer to a buffer which will hold the bytes read
+ *  @param   count The number of bytes to be read, at least one
+ */
+
+void twi_transaction::set_read (uint8_t addr, uint8_t a_reg, uint8_t* p_data,
+								uint8_t count)
+{
+	address = addr;
+	send_reg = true;
+	reg = a_reg;
+	p_write = NULL;
+	write_count = 0;
+	p_read = p_data;
+	read_count = count;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Set up the TWI port and an empty queue of transactions.
+ *  @details The pull-up resistors on the SDA and SCL pins are turned on, the TWI 
+ *           module is powered up, and the bit rate is set with no prescaler. The 
+ *           interrupt isn't enabled until there's a transaction to run.
+ *  @param   bitrate The bit rate for the bus, in bits per second (default 400 kHz)
+ */
+
+twi_engine::twi_engine (uint32_t bitrate)
+{
+	p_head = NULL;
+	p_tail = NULL;
+	index = 0;
+	reg_next = false;
+	ok_count = 0;
+	error_count = 0;
+	last_error = TWI_OK;
+	max_transfer_us = 0;
+	task_woken = false;
+
+	// SDA is PD1 and SCL is PD0 on the ATmega1281
+	PORTD |= (1 << PD1) | (1 << PD0);
+	PRR0 &= ~(1 << PRTWI);
+
+	// SCL frequency = F_CPU / (16 + 2 * TWBR) with the prescaler set to one
+	TWSR &= ~((1 << TWPS1) | (1 << TWPS0));
+	TWBR = (uint8_t)((F_CPU / bitrate - 16) / 2);
+	TWCR = (1 << TWEN);
+
+	p_twi_engine = this;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Begin the transaction at the head of the queue with a start condition.
+ *  @details This method must be called with interrupts disabled. If a transaction
+ *           has just ended, a stop condition is sent first; the TWI module sends the
+ *           stop and then the start when both bits are set together.
+ *  @param   after_stop True to send a stop condition before the start
+ */
+
+void twi_engine::start_head (bool after_stop)
+{
+	twi_transaction* p_trans = p_head;
+
+	p_trans->status = TWI_BUSY;
+	p_trans->start_time = get_raw_time_ISR ();
+	index = 0;
+	reg_next = p_trans->send_reg;
+
+	TWCR = TWI_GO | (1 << TWSTA) | (after_stop ? (1 << TWSTO) : 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Finish the transaction at the head of the queue and start the next one.
+ *  @details This method must be called with interrupts disabled. The result and end
+ *           time are saved in the transaction, the statistics are updated, and the
+ *           transaction's semaphore is given to wake the task waiting for it, and
+ *           @c task_woken is set if that task should run before the one which was
+ *           interrupted. If no
+ *           more transactions are waiting, a stop condition is sent and the TWI
+ *           interrupt is turned off.
+ *  @param   result The status with which the transaction has finished
+ *  @param   stop_allowed False if the TWI module has just been reset, so it isn't
+ *                        the bus master and mustn't send a stop condition
+ */
+
+void twi_engine::finish_head (twi_status result, bool stop_allowed)
+{
+	twi_transaction* p_trans = p_head;
+	signed portBASE_TYPE task_awakened = pdFALSE;
+
+	p_trans->end_time = get_raw_time_ISR ();
+	p_trans->status = result;
+
+	if (result == TWI_OK)
+	{
+		ok_count++;
+		uint32_t transfer_us = p_trans->get_transfer_us ();
+		if (transfer_us > max_transfer_us)
+		{
+			max_transfer_us = transfer_us;
+		}
+	}
+	else
+	{
+		if (error_count < 0xFFFF)
+		{
+			error_count++;
+		}
+		last_error = result;
+	}
+
+	// After arbitration is lost this master isn't driving the bus, so it mustn't send
+	// a stop condition; it only waits for the bus to be free before starting again
+	bool send_stop = stop_allowed && (result != TWI_ARB_LOST);
+
+	p_head = p_trans->p_next;
+	if (p_head != NULL)
+	{
+		start_head (send_stop);
+	}
+	else
+	{
+		p_tail = NULL;
+		TWCR = (1 << TWINT) | (1 << TWEN) | (send_stop ? (1 << TWSTO) : 0);
+	}
+
+	if (p_trans->done != NULL)
+	{
+		xSemaphoreGiveFromISR (p_trans->done, &task_awakened);
+		if (task_awakened != pdFALSE)
+		{
+			task_woken = true;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put a transaction in the queue without waiting for it to finish.
+ *  @details If the bus is idle, the transaction is started right away. The caller 
+ *           must not change the transaction or its buffers until its status shows 
+ *           that it's finished or its semaphore has been given.
+ *  @param   p_trans Pointer to the transaction to be run
+ */
+
+void twi_engine::submit (twi_transaction* p_trans)
+{
+	p_trans->status = TWI_PENDING;
+	p_trans->p_next = NULL;
+	p_trans->queue_time = get_raw_time ();
+
+	portENTER_CRITICAL ();
+	if (p_head == NULL)
+	{
+		p_head = p_trans;
+		p_tail = p_trans;
+		start_head (false);
+	}
+	else
+	{
+		p_tail->p_next = p_trans;
+		p_tail = p_trans;
+	}
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Put a transaction in the queue and wait until it's done or timed out.
+ *  @details The calling task sleeps on the transaction's semaphore, so other tasks 
+ *           can run while the transaction is carried out. If it hasn't finished 
+ *           when the timeout runs out, it's taken out of the queue and its status is
+ *           set to @c TWI_TIMEOUT. The transaction must have a semaphore.
+ *  @param   p_trans Pointer to the transaction to be run
+ *  @param   timeout The longest time to wait, in RTOS ticks
+ *  @return  The status of the finished transaction, @c TWI_OK if it worked
+ */
+
+twi_status twi_engine::transfer (twi_transaction* p_trans, TickType_t timeout)
+{
+	submit (p_trans);
+
+	if (xSemaphoreTake (p_trans->done, timeout) != pdTRUE)
+	{
+		cancel (p_trans, TWI_TIMEOUT);
+
+		// If the transaction finished just before it was cancelled, its semaphore
+		// was given; take it so it isn't left over for the next transaction
+		xSemaphoreTake (p_trans->done, 0);
+	}
+
+	return (p_trans->status);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Take a transaction which hasn't finished out of the queue.
+ *  @details If the transaction is on the bus, a byte may still be moving and its
+ *           interrupt would be taken as a step of the next transaction; so the TWI
+ *           module is reset by turning it off, which drops the transfer and clears
+ *           the interrupt flag, and then the next transaction is started. If the
+ *           transaction is waiting in the queue, it's just unlinked. A transaction
+ *           which has already finished is left alone.
+ *  @param   p_trans Pointer to the transaction to be cancelled
+ *  @param   result The status to be given to the cancelled transaction
+ */
+
+void twi_engine::cancel (twi_transaction* p_trans, twi_status result)
+{
+	portENTER_CRITICAL ();
+	if (p_trans == p_head)
+	{
+		TWCR = (1 << TWINT);
+		TWCR = (1 << TWEN);
+		finish_head (result, false);
+
+		// This runs in a task, usually the one the transaction belonged to, so
+		// there's no switch to be made from an ISR
+		task_woken = false;
+	}
+	else if (p_trans->status == TWI_PENDING)
+	{
+		for (twi_transaction* p_prev = p_head; p_prev != NULL; p_prev = p_prev->p_next)
+		{
+			if (p_prev->p_next == p_trans)
+			{
+				p_prev->p_next = p_trans->p_next;
+				if (p_tail == p_trans)
+				{
+					p_tail = p_prev;
+				}
+				break;
+			}
+		}
+		p_trans->end_time = p_trans->start_time = get_raw_time_ISR ();
+		p_trans->status = result;
+		if (error_count < 0xFFFF)
+		{
+			error_count++;
+		}
+		last_error = result;
+	}
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Take the next step in the transaction at the head of the queue.
+ *  @details This method is called by the TWI interrupt service routine each time the
+ *           TWI module has finished sending a start condition or a byte, or has 
+ *           received a byte. The status code in @c TWSR tells what has just happened,
+ *           and that determines what is to be done next. 
+ */
+
+void twi_engine::isr (void)
+{
+	twi_transaction* p_trans = p_head;
+
+	// An interrupt with nothing in the queue can only be left over from a cancelled
+	// transaction; clear it and turn the interrupt off
+	if (p_trans == NULL)
+	{
+		TWCR = (1 << TWINT) | (1 << TWEN);
+		return;
+	}
+
+	switch (TWSR & TW_STATUS_MASK)
+	{
+		// After a start condition, address the device for writing if there's a
+		// register or data to write, or for reading if not
+		case TW_START:
+			if (p_trans->send_reg || p_trans->write_count > 0)
+			{
+				TWDR = (p_trans->address << 1) | TW_WRITE;
+			}
+			else
+			{
+				TWDR = (p_trans->address << 1) | TW_READ;
+			}
+			TWCR = TWI_GO;
+			break;
+
+		// A repeated start is only used to turn the bus around for reading
+		case TW_REP_START:
+			TWDR = (p_trans->address << 1) | TW_READ;
+			index = 0;
+			TWCR = TWI_GO;
+			break;
+
+		// The device took the last byte; send the next, turn around, or finish
+		case TW_MT_SLA_ACK:
+		case TW_MT_DATA_ACK:
+			if (reg_next)
+			{
+				TWDR = p_trans->reg;
+				reg_next = false;
+				TWCR = TWI_GO;
+			}
+			else if (index < p_trans->write_count)
+			{
+				TWDR = p_trans->p_write[index++];
+				TWCR = TWI_GO;
+			}
+			else if (p_trans->read_count > 0)
+			{
+				TWCR = TWI_GO | (1 << TWSTA);
+			}
+			else
+			{
+				finish_head (TWI_OK);
+			}
+			break;
+
+		// Some devices refuse the last byte written, which is fine; any other
+		// byte being refused is an error
+		case TW_MT_DATA_NACK:
+			if (!reg_next && index >= p_trans->write_count && p_trans->read_count == 0)
+			{
+				finish_head (TWI_OK);
+			}
+			else
+			{
+				finish_head (TWI_NACK_DATA);
+			}
+			break;
+
+		case TW_MT_SLA_NACK:
+		case TW_MR_SLA_NACK:
+			finish_head (TWI_NACK_ADDRESS);
+			break;
+
+		case TW_MT_ARB_LOST:
+			finish_head (TWI_ARB_LOST);
+			break;
+
+		// The device will send data; acknowledge every byte but the last one
+		case TW_MR_SLA_ACK:
+			if (p_trans->read_count > 1)
+			{
+				TWCR = TWI_GO | (1 << TWEA);
+			}
+			else
+			{
+				TWCR = TWI_GO;
+			}
+			break;
+
+		case TW_MR_DATA_ACK:
+			p_trans->p_read[index++] = TWDR;
+			if (index + 1 < p_trans->read_count)
+			{
+				TWCR = TWI_GO | (1 << TWEA);
+			}
+			else
+			{
+				TWCR = TWI_GO;
+			}
+			break;
+
+		// The last byte was read and not acknowledged, so the transaction is done
+		case TW_MR_DATA_NACK:
+			p_trans->p_read[index++] = TWDR;
+			finish_head (TWI_OK);
+			break;
+
+		// A bus error or a status which a master shouldn't see
+		default:
+			finish_head (TWI_BUS_ERROR);
+			break;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the number of transactions and errors and the longest transfer.
+ *  @param   p_ser_dev Pointer to a serial device on which to print the statistics
+ */
+
+void twi_engine::print_status (emstream* p_ser_dev)
+{
+	*p_ser_dev << PMS ("TWI: ") << ok_count << PMS (" OK, ") << error_count
+			   << PMS (" errors");
+	if (error_count)
+	{
+		*p_ser_dev << PMS (" (last ") << last_error << ')';
+	}
+	*p_ser_dev << PMS (", longest ") << max_transfer_us << PMS (" us") << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print a short name for the status of a transaction.
+ *  @param   serpt Reference to a serial port to which to print the name
+ *  @param   status The status whose name is to be printed
+ *  @return  A reference to the same serial device on which we write
+ */
+
+emstream& operator << (emstream& serpt, twi_status status)
+{
+	switch (status)
+	{
+		case TWI_PENDING:       serpt << PMS ("pending");       break;
+		case TWI_BUSY:          serpt << PMS ("busy");          break;
+		case TWI_OK:            serpt << PMS ("OK");            break;
+		case TWI_NACK_ADDRESS:  serpt << PMS ("address NACK");  break;
+		case TWI_NACK_DATA:     serpt << PMS ("data NACK");     break;
+		case TWI_ARB_LOST:      serpt << PMS ("arbitration");   break;
+		case TWI_BUS_ERROR:     serpt << PMS ("bus error");     break;
+		case TWI_TIMEOUT:       serpt << PMS ("timeout");       break;
+	}
+	return (serpt);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Interrupt service routine for the TWI port.
+ *  @details This ISR runs each time the TWI module has finished a step of a
+ *           transaction; all the work is done by the engine's @c isr() method.
+ */
+
+ISR (TWI_vect)
+{
+	if (p_twi_engine != NULL)
+	{
+		p_twi_engine->isr ();
+		p_twi_engine->yield_if_woken ();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Switch to a task woken by the transaction which has just finished.
+ *  @details This method is called by the TWI interrupt service routine after
+ *           @c isr(), and never from a task. If finishing a transaction
+ *           woke a task of higher priority than the one which was interrupted, the
+ *           context is switched before the ISR returns, as FreeRTOS's own AVR serial
+ *           port demonstration does, so the task runs now rather than at the next
+ *           RTOS tick.
+ */
+
+void twi_engine::yield_if_woken (void)
+{
+	if (task_woken)
+	{
+		task_woken = false;
+		portYIELD ();
+	}
+}
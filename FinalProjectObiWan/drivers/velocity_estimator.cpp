@@ -0,0 +1,143 @@
+//*************************************************************************************
+/** \file velocity_estimator.cpp
+ *    This file contains the methods of a class which estimates shaft speed from
+ *    encoder counts, timing the edges at low speed and counting them at high speed.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It is intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include "velocity_estimator.h"             // Header for this file
+
+
+/// One millisecond's worth of velocity, for turning counts per us into counts per ms
+#define VELOCITY_ONE_MS         ((int32_t)1000 << VELOCITY_FRAC_BITS)
+
+/// The largest velocity which fits the @c int16_t result
+#define VELOCITY_MAX            32767L
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Create an estimator which starts at zero velocity.
+ *  @details The first call to @c update() only records the count and times, since
+ *           there's nothing yet to compare them with.
+ */
+
+velocity_estimator::velocity_estimator (void)
+{
+	last_count = 0;
+	last_time = 0;
+	edge_count = 0;
+	edge_time = 0;
+	estimate = 0;
+	filtered = 0;
+	primed = false;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Find a velocity from a change in count over a time.
+ *  @details The result is limited to what fits in an @c int16_t, so a huge count
+ *           over a tiny time doesn't wrap around to a wrong sign.
+ *  @param   counts The change in count
+ *  @param   raw_time The time over which the count changed, in raw timer counts
+ *  @return  The velocity in counts per millisecond, with fractional bits
+ */
+
+int32_t velocity_estimator::rate (int32_t counts, uint32_t raw_time)
+{
+	int32_t time_us = (int32_t)raw_time_to_us (raw_time);
+	if (time_us <= 0)
+	{
+		return (0);
+	}
+
+	int32_t result = counts * VELOCITY_ONE_MS / time_us;
+	if (result > VELOCITY_MAX)
+	{
+		return (VELOCITY_MAX);
+	}
+	if (result < -VELOCITY_MAX)
+	{
+		return (-VELOCITY_MAX);
+	}
+	return (result);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Take the newest count and edge time and update the velocity.
+ *  @details This method should be called at a steady rate, usually once per run of a
+ *           task, with all the times taken from the same clock. Between calls the
+ *           count must change by less than about 130,000 so that the arithmetic
+ *           can't overflow.
+ *  @param   count The encoder count
+ *  @param   a_edge_time The raw time at which @c count last changed
+ *  @param   now The raw time at which @c count was read
+ *  @return  The filtered velocity in counts per millisecond, with fractional bits
+ */
+
+int16_t velocity_estimator::update (int32_t count, uint32_t a_edge_time, uint32_t now)
+{
+	if (!primed)
+	{
+		last_count = edge_count = count;
+		last_time = now;
+		edge_time = a_edge_time;
+		primed = true;
+		return (0);
+	}
+
+	int32_t counts = count - last_count;
+
+	if (counts >= VELOCITY_SWITCH_COUNTS || counts <= -VELOCITY_SWITCH_COUNTS)
+	{
+		// Fast: plenty of counts, so count them over the period
+		estimate = rate (counts, now - last_time);
+		edge_count = count;
+		edge_time = a_edge_time;
+	}
+	else if (count != edge_count)
+	{
+		// Slow: time the counts from the last edge used to the newest edge
+		estimate = rate (count - edge_count, a_edge_time - edge_time);
+		edge_count = count;
+		edge_time = a_edge_time;
+	}
+	else
+	{
+		// No edges: we can't be going faster than one count since the last edge
+		int32_t limit = rate (1, now - edge_time);
+		if (estimate > limit)
+		{
+			estimate = limit;
+		}
+		else if (estimate < -limit)
+		{
+			estimate = -limit;
+		}
+	}
+
+	last_count = count;
+	last_time = now;
+
+	// The filtered value keeps extra fractional bits so small steps aren't lost
+	filtered += estimate - (filtered >> VELOCITY_FILTER_SHIFT);
+
+	return (get_velocity ());
+}
@@ -4,10 +4,19 @@
  *    tasks at the same time. There is no protection from priority inversion, however,
  *    except for the priority elevation in the mutex.
  *
+ *    The driver can also scan a list of channels from the A/D interrupt, either
+ *    continuously or each time a timer triggers a conversion. Each result goes into
+ *    a double buffer for its channel along with the time it was taken, so tasks can
+ *    get the latest reading right away instead of waiting for a conversion. Channels
+ *    being scanned can be oversampled: the ISR adds up 4^n readings and publishes
+ *    their sum shifted right by n bits, a result with n more bits of resolution.
+ *
  *  Revisions:
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR Added interrupt driven scanning of a list of channels
+ *    @li 10-16-2026 ERR Added oversampling and decimation of scanned channels
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -34,12 +43,57 @@
 #include "task.h"                           // Header for FreeRTOS task functions
 #include "queue.h"                          // Header for FreeRTOS queues
 #include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "time_stamp.h"                     // Fast clock used to time readings
+
+
+/// The largest number of channels which can be scanned, one for each A/D input
+#define ADC_SCAN_MAX        8
+
+/** The largest number of extra bits of resolution from oversampling. Six bits takes
+ *  4^6 = 4096 readings per result and gives 16-bit results; the sum of 4096 10-bit
+ *  readings easily fits in the ISR's 32-bit accumulator.
+ */
+#define ADC_MAX_EXTRA_BITS  6
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Things which can start each conversion while channels are being scanned.
+ *  @details The timer triggers use the A/D converter's auto trigger mode; the values
+ *           are the ones which go in the @c ADTS bits of @c ADCSRB. The timer must be
+ *           set up by the caller, and the scanner clears the timer's compare flag
+ *           after each conversion so that the next compare match starts another.
+ */
+
+enum adc_trigger
+{
+    ADC_SCAN_CONTINUOUS = 0,                ///< Start each conversion from the ISR
+    ADC_SCAN_TIMER0_COMPA = 3,              ///< Timer 0 compare match A starts each
+    ADC_SCAN_TIMER1_COMPB = 5               ///< Timer 1 compare match B starts each
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   One reading from the A/D converter and the time it was taken.
+ */
+
+struct adc_sample
+{
+    uint16_t value;                         ///< The result, 10 bits plus extra bits
+    uint32_t time;                          ///< Raw time from @c get_raw_time_ISR()
+    uint8_t extra_bits;                     ///< Bits of resolution above 10 bits
+};
 
 
 //-------------------------------------------------------------------------------------
 /** @brief   This class @b will run the A/D converter on an AVR processor. 
  *  @details It has appropriate prototypes for the adc class like methods and
  *           constructors in the public region.
+ *
+ *           There is only one A/D converter, so the list of channels being scanned
+ *           and the latest readings are shared by all the @c adc objects; any of
+ *           them can start or stop the scan. While a scan is running, @c read_once()
+ *           returns the latest scanned reading instead of starting a conversion,
+ *           unless the scan hasn't read that channel yet.
  */
 
 class adc
@@ -63,8 +117,27 @@ class adc
         // implements a crude sort of low-pass filtering that can help reduce noise
         uint16_t read_oversampled (uint8_t, uint8_t);
 
+        // Begin scanning a list of channels from the A/D converter's interrupt
+        void start_scan (const uint8_t* channels, uint8_t count,
+                         adc_trigger trigger = ADC_SCAN_CONTINUOUS);
+
+        // Stop scanning channels
+        void stop_scan (void);
+
+        // Check whether a channel is in the list being scanned
+        bool is_scanned (uint8_t channel);
+
+        // Get the latest scanned reading from a channel without waiting
+        bool get_latest (uint8_t channel, adc_sample& sample);
+
+        // Read a channel with all the bits of resolution oversampling gives it
+        uint16_t read_full (uint8_t channel, uint8_t& extra_bits);
 
+        // Set the number of extra bits of resolution made by oversampling a channel
+        void set_oversampling (uint8_t channel, uint8_t extra_bits);
 
+        // Get the number of times the whole list of channels has been scanned
+        uint32_t get_scan_count (void);
 
 }; // end of class adc
 
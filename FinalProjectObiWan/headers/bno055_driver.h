@@ -9,6 +9,10 @@
  *  Revisions: @ 5/28/2016 <<EDD>> fixed everything and made everything more
  *       robust and fixed a much of calls. Made it so that it's easier
  *       to use function.
+ *             @ 10/16/2026 ERR Added readBurst() which reads the Euler angles
+ *       and other data blocks in one I2C transaction.
+ *             @ 10/16/2026 ERR Added readVectorQ() which gives fixed-point
+ *       vectors with no floating point arithmetic.
  *  License:
  *   BNO055 driver class for the ATMEGA1281 C
  *   Copyright (C) 2016  Eddie Ruano
@@ -38,6 +42,66 @@
 #include "i2c_driver.h"         // I2C driver used to interface w/ BNO
 #include "Adafruit_BNO055.h"    // Reusing declarations in Adafruit's Arduino library written by KTWON 
 #include "imumaths.h"           // libraries used for calculations
+#include "vector3q.h"           // Fixed-point vectors and scale factors
+
+/// @brief      Flags for readBurst() which choose the data blocks to read
+enum bno055_burst_block
+{
+    BNO055_BURST_GYRO     = 0x01,   ///< Angular rates, 0x14 - 0x19
+    BNO055_BURST_EULER    = 0x02,   ///< Heading, roll and pitch, 0x1A - 0x1F
+    BNO055_BURST_LINACCEL = 0x04,   ///< Linear acceleration, 0x28 - 0x2D
+    BNO055_BURST_GRAVITY  = 0x08    ///< Gravity vector, 0x2E - 0x33
+};
+
+/** @brief      Raw readings from one burst read of the BNO055.
+ *  @details    The values are the signed 16 bit numbers straight from the
+ *              data registers. With the units set up by initialize(), Euler
+ *              angles are 16 LSB per degree, angular rates 900 LSB per rad/s,
+ *              and accelerations 100 LSB per m/s^2. Blocks which weren't
+ *              asked for are left alone.
+ */
+struct bno055_burst
+{
+    int16_t heading;                ///< Euler heading, 16 LSB per degree
+    int16_t roll;                   ///< Euler roll, 16 LSB per degree
+    int16_t pitch;                  ///< Euler pitch, 16 LSB per degree
+    int16_t gyro[3];                ///< Angular rates about X, Y and Z
+    int16_t lin_accel[3];           ///< Linear acceleration in X, Y and Z
+    int16_t gravity[3];             ///< Gravity vector in X, Y and Z
+};
+
+/// @brief      Number of LSB's per degree in the Euler angle registers
+#define BNO055_LSB_PER_DEGREE   16
+
+/** @brief      Scale factors for each kind of BNO055 vector.
+ *  @details    Each specialization gives the number of LSB's per unit in the
+ *              registers, with the units set up by initialize(), and the
+ *              number of fractional bits which leaves room for the sensor's
+ *              full range in an int16_t:
+ *              | Vector             | LSB per unit   | Range        | Format |
+ *              |:-------------------|:---------------|:-------------|:------:|
+ *              | Euler angles       | 16 per degree  | +-360 deg    | Q4     |
+ *              | Magnetometer       | 16 per uT      | +-2500 uT    | Q4     |
+ *              | Gyroscope          | 900 per rad/s  | +-35 rad/s   | Q9     |
+ *              | Accelerations      | 100 per m/s^2  | +-157 m/s^2  | Q7     |
+ */
+template <uint8_t vector_type> struct bno055_scale;
+
+template <> struct bno055_scale<VECTOR_EULER> : public FixedScale<16, 4, 0> { };
+template <> struct bno055_scale<VECTOR_MAGNETOMETER> : public FixedScale<16, 4, 0> { };
+template <> struct bno055_scale<VECTOR_GYROSCOPE> : public FixedScale<900, 9, 16> { };
+template <> struct bno055_scale<VECTOR_ACCELEROMETER> : public FixedScale<100, 7, 15> { };
+template <> struct bno055_scale<VECTOR_LINEARACCEL> : public FixedScale<100, 7, 15> { };
+template <> struct bno055_scale<VECTOR_GRAVITY> : public FixedScale<100, 7, 15> { };
+
+/// @brief      Fixed-point Euler angles in degrees, Q4
+typedef Vector3q<int16_t, 4> bno055_euler_q;
+/// @brief      Fixed-point magnetic field in microtesla, Q4
+typedef Vector3q<int16_t, 4> bno055_mag_q;
+/// @brief      Fixed-point angular rates in rad/s, Q9
+typedef Vector3q<int16_t, 9> bno055_gyro_q;
+/// @brief      Fixed-point accelerations in m/s^2, Q7
+typedef Vector3q<int16_t, 7> bno055_accel_q;
 
 class bno055_driver
 {
@@ -52,6 +116,8 @@ protected:
     uint8_t local_bno055_address;
     /// This structure holds the current operational mode of the BNO055
     bno055_opmode_t local_bno055_mode;
+    /// Turns little endian register bytes into signed 16 bit numbers
+    static void decode(const uint8_t*, int16_t*, uint8_t);
 
 
     ///set the public constructor and the public methods
@@ -79,6 +145,40 @@ public:
     void printAll(void);
     /// Returns a Vector holding the type specified, look at Adafruit_BNO055 for avaliable parameters
     imu::Vector<3> getVector(vector_type_t vector_type);
+
+    /**
+     * @brief       Reads a vector into fixed-point numbers.
+     *
+     * @details     The six data bytes are read and each count is changed to
+     *              Q format with a multiply and shift by constants from
+     *              bno055_scale, so no floating point math is done. The kind
+     *              of vector is given as a template argument, for example
+     *              readVectorQ<VECTOR_GYROSCOPE>(gyro) with a bno055_gyro_q.
+     *              Call to_vector<imu::Vector<3> >() on the result if a
+     *              floating point vector is really needed.
+     *
+     * @param       vect  Fixed-point vector which will hold the result
+     *
+     * @return      Returns TRUE if the read worked, FALSE otherwise
+     */
+    template <vector_type_t type>
+    bool readVectorQ(Vector3q<int16_t, bno055_scale<type>::FRAC_BITS>& vect)
+    {
+        int16_t raw[3];
+
+        if (!readRegister((bno055_reg_t)type, data_dump, 6))
+        {
+            return false;
+        }
+        decode(data_dump, raw, 3);
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            vect[axis] = bno055_scale<type>::to_q(raw[axis]);
+        }
+        return true;
+    }
+    /// Reads the chosen data blocks in one transaction into a bno055_burst
+    bool readBurst(bno055_burst&, uint8_t blocks = BNO055_BURST_EULER);
     int16_t getHeading(void);
     /// Gets current Roll 
     int16_t getRoll(void);
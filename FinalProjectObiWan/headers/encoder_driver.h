@@ -3,7 +3,8 @@
  *    This file contains a header file for the motor driver for a regular DC
  *    motor.
  *
- *  Revisions: n/a
+ *  Revisions: @ 10/16/2026 ERR table driven quadrature decoding in the ISRs,
+ *             with a private count which is put in the share lazily
  *  Author(s): Eddie Ruano
 */
 
@@ -24,6 +25,11 @@
 #include "semphr.h"                 // Header for FreeRTOS semaphores
 //added
 
+/// The input register which holds both encoder channels
+#define ENCODER_PIN     PINE
+/// Bit of channel A in ENCODER_PIN; channel B must be the next bit up
+#define ENCODER_A_BIT   PE6
+
 
 //-------------------------------------------------------------------------------------
 /** @brief   This class will run the DC motor.
@@ -72,9 +78,17 @@ public:
       uint8_t
    );
 
-///NO METHODS YET
 emstream* serial_PORT;
 
+   // Get the count kept by the ISRs
+   int32_t get_count (void);
+
+   // Get the number of illegal transitions, each of which means a missed edge
+   uint16_t get_errors (void);
+
+   // Copy the count kept by the ISRs into the encoder_count share
+   int32_t publish (void);
+
 //void sayHello(const char*);
 
 }; // end of class encoder_driver
@@ -12,6 +12,11 @@
  *
  *  Revisions: @ 5/3/2016 <<EDD>> changed name and fixed comments to
  *             traditional style
+ *             @ 10/16/2026 ERR added sampling from a timer interrupt with time
+ *             stamps and a count extended to 32 bits
+ *             @ 10/16/2026 ERR samples carry the time the count last changed
+ *             @ 10/16/2026 ERR added hctl_driver_pins, which takes its pins as
+ *             template parameters
  *  License:
  *    This file is copyright 2016 by Eddie Ruano and released under the Lesser
  *    GNU
@@ -46,6 +51,30 @@
 #include "task.h"                   // Header for FreeRTOS task functions
 #include "queue.h"                  // Header for FreeRTOS queues
 #include "semphr.h"                 // Header for FreeRTOS semaphores
+#include "time_stamp.h"             // Fast clock used to time samples
+#include "avr_pin.h"                // Pins chosen at compile time
+#include <avr/cpufunc.h>            // For _NOP()
+
+
+/// The number of bits in the HCTL-2000's position counter
+#define HCTL_COUNTER_BITS   12
+
+/// The default rate at which the counter is sampled by the timer interrupt
+#define HCTL_SAMPLE_RATE_HZ 1000
+
+
+/**
+ * @brief      One sample of the encoder position, taken by the timer ISR.
+ * @details    Samples are taken at a constant rate, so @c delta is the
+ *             velocity in counts per sample period with no scheduler jitter.
+ */
+struct hctl_sample
+{
+    int32_t count;                  ///< Position extended to 32 bits
+    int16_t delta;                  ///< Change in position since last sample
+    uint32_t time;                  ///< Raw time from @c get_raw_time_ISR()
+    uint32_t edge_time;             ///< Raw time the count last changed
+};
 
 
 /**
@@ -62,6 +91,8 @@ protected:
 
     /// the data bus port register (where we'll look for encoder data)
     volatile uint8_t* data_PORT;
+    /// the data bus input register, always the port register - 2 addresses
+    volatile uint8_t* data_PIN;
     /// the port register for the !OE pin
     volatile uint8_t* oe_PORT;
     /// the pin number for the !OE pin
@@ -71,6 +102,22 @@ protected:
     /// the pin number for the SEL oe_pin
     uint8_t sel_pin;
 
+    /// the last raw reading of the counter, used to extend it to 32 bits
+    uint16_t last_raw;
+    /// the position extended to 32 bits, kept by the sampling ISR
+    int32_t extended_count;
+    /// the raw time of the last sample in which the count changed
+    uint32_t last_edge_time;
+    /// the two latest samples; the ISR writes the one not being read
+    hctl_sample samples[2];
+    /// count of samples taken; its lowest bit picks the latest sample
+    volatile uint8_t sequence;
+    /// the rate at which samples are being taken, or 0 if not sampling
+    uint16_t sample_rate;
+
+    // reads the counter from the bus without protection from interrupts
+    virtual uint16_t read_bus (void);
+
 public:
     // The constructor sets up the HCTL for use. The "= NULL" part is a
     // default parameter, meaning that if that parameter isn't given on the line
@@ -87,6 +134,21 @@ public:
 
     /// This function reads the HCTL once, returning the result as an unsigned integer; it should be called from within a normal task, not an ISR
     uint16_t read ();
+
+    // Start taking samples from a timer interrupt at an exact rate
+    void start_sampling (uint16_t rate_hz = HCTL_SAMPLE_RATE_HZ);
+
+    // Stop taking samples
+    void stop_sampling (void);
+
+    // Get the latest sample without waiting; called from a task
+    bool get_sample (hctl_sample& sample);
+
+    // Take one sample; called only by the timer interrupt
+    void sample_isr (void);
+
+    /// returns the rate at which samples are taken, or 0 if not sampling
+    uint16_t get_sample_rate () { return sample_rate; }
     /// returns the data port used by the HCTL.
     volatile uint8_t* get_data_port () { return data_PORT; }
     /// returns the port for the !OE pin.
@@ -105,4 +167,61 @@ public:
 // a part of class hctl, but it operates on objects of class hctl
 emstream& operator << (emstream&, hctl_driver&);
 
+/// Pointer to the HCTL driver which is sampled by the timer interrupt
+extern hctl_driver* p_hctl_sampler;
+
+
+/**
+ * @brief      This is an HCTL driver whose pins are chosen at compile time.
+ *
+ * @details    The data bus is a whole port such as PortA and !OE and SEL are
+ *             Pin<PortX, bit> classes from avr_pin.h, for example
+ *             hctl_driver_pins<PortA, Pin<PortC, PC7>, Pin<PortC, PC6> >.
+ *             Only read_bus() is replaced, so sampling works as before, but
+ *             each pin change is a single sbi or cbi and each bus read a
+ *             single in instruction. Two nops after each change give the
+ *             chip's outputs and the AVR's input synchronizer time to settle,
+ *             which the pointer arithmetic in the base class used to do by
+ *             accident. Counting instructions, a read drops from about 90
+ *             cycles to about 30, including the virtual call.
+ */
+template <class DataPort, class OePin, class SelPin>
+class hctl_driver_pins : public hctl_driver
+{
+protected:
+    /**
+     * @brief      Reads the count from the bus with single-cycle IO.
+     *
+     * @return     The 16 bit count, high byte first
+     */
+    uint16_t read_bus (void)
+    {
+        SelPin::clear ();                   // select the high byte
+        OePin::clear ();                    // latch the count onto the bus
+        _NOP ();
+        _NOP ();
+        uint16_t count = (uint16_t)PortBus<DataPort>::read () << 8;
+
+        SelPin::set ();                     // now the low byte
+        _NOP ();
+        _NOP ();
+        count |= PortBus<DataPort>::read ();
+
+        OePin::set ();                      // release the bus
+        return count;
+    }
+
+public:
+    /**
+     * @brief      Sets up the bus and pins.
+     *
+     * @param      p_serial_port  The serial port for debugging info
+     */
+    hctl_driver_pins (emstream* p_serial_port)
+        : hctl_driver (p_serial_port, &DataPort::port (), &OePin::Port::port (),
+                       OePin::BIT, &SelPin::Port::port (), SelPin::BIT)
+    {
+    }
+};
+
 #endif // _AVR_HCTL_H_
@@ -13,6 +13,8 @@
  *  @author Eddie Ruano
  *
  *  Revisions: 
+        @ 10/16/2026 ERR Transfers are now run by the interrupt driven
+ *       twi_engine, so the calling task sleeps instead of spinning.
         @ 5/30/2016 <<EDD>> added comments, updated license.
         @ 5/28/2016 <<EDD>> fixed everything and made everything more
  *       robust and fixed a much of calls. Made it so that it's easier
@@ -42,36 +44,21 @@
 #include "FreeRTOS.h"                   // Header for the RTOS
 #include "semphr.h"                     // FreeRTOS semaphores (we use a mutex)
 #include "emstream.h"                   // Header for base serial devices
-#include <util/twi.h>                   // Header for establised ACK vernacular
+#include "twi_engine.h"                 // Interrupt driven TWI transactions
 
 class i2c_driver
 {
 protected:
     /// @brief       Pointer to serial port object used for debugging purposes
     emstream* p_serial;
-    /// @brief       Function to reset timer used for timeouts
-    void resetTimer(void);
-    /// @brief       Pointer to timer variable
-    uint32_t local_timer;
     /// @brief       Holds address of device currently being read/written from
     uint8_t local_current_address;
-    /// @brief       Inititalizes the correct regsiters for I2C on ATmega1281
-    void initialize(void);
-    /// @brief       Waits for the TWINT flag to be set for an alotted time
-    void waitForSet(void);
-    /// @brief       Checks to see if response in status register is correct
-    bool checkError(uint8_t);
-    /// @brief       Mutex used to prevent simultaneous uses of the I2C port.
+    /// @brief       Mutex used to protect the transaction from multiple tasks
     SemaphoreHandle_t mutex;
-    /// @brief       Starts I2C communication protocol
-    bool start(void);
-    /// @brief       Stops I2C communication protocol
-    bool stop(void);
-    /// @brief       Creats and checks a Restart condition on I2C interface
-    bool restart(void);
-    /*  @brief       Clears the flags resulting from stop and go comms on I2C interface, also re-enables the communcation, more like a Clear/Enable dual function.
-    */
-    void clearEnable(bool);
+    /// @brief       Transaction which is filled in and run for each call
+    twi_transaction transaction;
+    /// @brief       Runs the transaction and reports any error
+    bool run(void);
 public:
     /// This constructor sets up the driver
     i2c_driver (
@@ -83,6 +70,7 @@ public:
     bool writeData(uint8_t, uint8_t, uint8_t);
     /// Fucntion to ping address on SDA line
     bool ping(uint8_t);
+    /// Returns the time the last transaction took on the bus in microseconds
+    uint32_t getTransferTime(void);
 };
 #endif //  _I2C_DRIVER_H
-
@@ -9,7 +9,11 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @ 4/23/2016 removed bitops.h library
+ *  Revisions: @ 10/16/2026 ERR pulse widths are committed once per PWM
+ *             period by the timer overflow ISR, with optional slew limiting
+ *             @ 10/16/2026 ERR added servo_driver_pins, which takes its pin
+ *             and compare register as template parameters
+ *             @ 4/23/2016 removed bitops.h library
  *             @ 4/16/2016 added bitops.h library for setting unsetting bits
  *             @ 4/12/2016 main structure created
  *  License:
@@ -60,6 +64,11 @@
 #include "adc.h"                            // Header for A/D converter driver class
 #include "textqueue.h"                 // Header for text queue class
 #include "shares.h"                    // Shared inter-task communications
+#include "avr_pin.h"                   // Pins chosen at compile time
+
+
+/// The most servos which can share the timer's overflow ISR
+#define SERVO_MAX 4
 
 
 
@@ -92,6 +101,18 @@ protected:
     /// pin where pwm comes out of
     uint8_t local_OCR_pin;
 
+    /// the pulse width asked for by a task, put in OCR by the ISR
+    volatile uint16_t target_pulse;
+    /// the pulse width now in OCR
+    uint16_t current_pulse;
+    /// the largest change in pulse width per period, or 0 for no limit
+    uint16_t slew_limit;
+    /// true once a pulse width has been asked for
+    bool started;
+
+    // writes a pulse width to the compare register
+    virtual void write_pulse (uint16_t pulse);
+
 
 
     ///set the public constructor and the public methods
@@ -111,10 +132,73 @@ public:
 
     void setServoAngle(int16_t);
 
+    // Set the largest change in pulse width per PWM period
+    void set_slew (uint16_t counts_per_period);
+
+    // Move the pulse width toward its target; called only by the timer ISR
+    void update_isr (void);
+
+    /// returns the pulse width now being sent to the servo
+    uint16_t get_pulse (void) { return current_pulse; }
+
 
 }; // end of class servo_driver
 
 
+/**
+ * @brief      This is a servo driver whose output pin and compare register
+ *             are chosen at compile time.
+ *
+ * @details    For example servo_driver_pins<Pin<PortE, PE3>, Reg_OCR3A>. The
+ *             output pin is made an output on its own port rather than always
+ *             on port E, and the overflow ISR writes the compare register
+ *             with two sts instructions instead of loading a pointer first.
+ *             That only saves a few cycles, since the old method was already
+ *             one store; the main gain is that the pin can't be mismatched
+ *             with its port.
+ */
+template <class OutPin, class Ocr>
+class servo_driver_pins : public servo_driver
+{
+public:
+    /**
+     * @brief      Sets up the timer and the output pin.
+     *
+     * @param      serial_PORT_incoming  The serial port for debugging info
+     * @param      timer_reg_A_inc       The timer's control register A
+     * @param      timer_reg_B_inc       The timer's control register B
+     * @param      ICR_reg_inc           The timer's input capture register,
+     *                                   which sets the PWM period
+     * @param[in]  prescaler_inc         The timer's prescaler
+     * @param[in]  top_ICR_inc           The value put in the ICR register
+     */
+    servo_driver_pins (
+        emstream* serial_PORT_incoming,
+        volatile uint8_t* timer_reg_A_inc,
+        volatile uint8_t* timer_reg_B_inc,
+        volatile uint16_t* ICR_reg_inc,
+        uint8_t prescaler_inc,
+        uint16_t top_ICR_inc
+    ) : servo_driver (serial_PORT_incoming, timer_reg_A_inc, timer_reg_B_inc,
+                      ICR_reg_inc, &Ocr::reg (), prescaler_inc, top_ICR_inc,
+                      OutPin::BIT)
+    {
+        OutPin::make_output ();
+    }
+
+protected:
+    /**
+     * @brief      Writes a pulse width to the compare register.
+     *
+     * @param[in]  pulse  The pulse width in timer counts
+     */
+    void write_pulse (uint16_t pulse)
+    {
+        Ocr::reg () = pulse;
+    }
+};
+
+
 /**
  * @brief                     This overloaded operator prints information
  *                            about a imu driver.
@@ -12,7 +12,9 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @li 4/20/2016  ER added more shares for the task_motor 
+ *  Revisions: @li 10-16-2026 ERR Replaced the IMU and joystick shares with one
+ *             snapshot share per sensor
+ *             @li 4/20/2016  ER added more shares for the task_motor 
  *             operations
  *             @li 01-04-2014 JRR Re-reorganized, allocating shares with new
  *             now
@@ -51,6 +53,26 @@
 #ifndef _SHARES_H_
 #define _SHARES_H_
 
+#include "snapshotshare.h"                  // Shares for sets of related values
+
+/// This structure holds one set of readings from the BNO055 IMU. The angles are
+/// in the units returned by the bno055_driver, sixteenths of a degree.
+struct imu_sample
+{
+    int16_t heading;                        ///< Current heading of the vehicle
+    int16_t del_heading;                    ///< Change in heading since last sample
+    int16_t roll;                           ///< Current roll of the vehicle
+    int16_t pitch;                          ///< Current pitch of the vehicle
+};
+
+/// This structure holds one set of steering values from task_steering.
+struct steering_sample
+{
+    int16_t x_joystick;                     ///< Corrected X joystick position
+    int16_t y_joystick;                     ///< Y joystick, 10 + extra A/D bits
+    int16_t steering_power;                 ///< Setting sent to the steering servo
+};
+
 //----------------------------------------------------------------------------
 // Externs:  In this section, we declare variables and functions that are used in all
 // (or at least two) of the files in the data acquisition project. Each of these items
@@ -79,31 +101,27 @@ extern TaskShare<uint8_t>* motor_directive;
 extern TaskShare<int32_t>* encoder_count;
 /// This variable holds the ticks per seconds so that other tasks like task_user may access it.
 extern TaskShare<int16_t>* encoder_ticks_per_task;
+/// This holds the filtered encoder velocity in ticks per ms with 4 fractional
+/// bits (VELOCITY_FRAC_BITS), found by task_encoder from counts and edge times
+extern TaskShare<int16_t>* encoder_velocity;
 /// This holds the total number of errors detected by the ISR when setting the counts        
 extern TaskShare<uint32_t>* data_read;
 
-extern TaskShare<int16_t>* steering_power;
-
 extern TaskShare<int16_t>* steering_angle;
 
 extern TaskShare<int16_t>* steering_target;
 
-extern TaskShare<int16_t>* x_joystick;
-
-extern TaskShare<int16_t>* y_joystick;
+/// Holds the joystick positions and steering power, written together by
+/// task_steering every 5 ms
+extern SnapshotShare<steering_sample>* steering_snapshot;
 
 extern TaskShare<int16_t>* gear_state;
 
 /* Start IMU variables */
 
-/// Holds current heading taken from BNO055 chip on BNO055 driver every 100 ms 
-extern TaskShare<int16_t>* heading;
-/// Holds change in heading since last reading
-extern TaskShare<int16_t>* del_heading;
-/// Holds current roll taken from BNO055 chip on BNO055 driver every 100 ms 
-extern TaskShare<int16_t>* roll;
-/// Holds current pitch taken from BNO055 chip on BNO055 driver every 100 ms 
-extern TaskShare<int16_t>* pitch;
+/// Holds the heading, change in heading, roll and pitch taken together from the
+/// BNO055 chip by task_imu every 100 ms
+extern SnapshotShare<imu_sample>* imu_snapshot;
 
 
 
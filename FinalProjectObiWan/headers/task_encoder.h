@@ -9,7 +9,9 @@
  *  @author Eddie Ruano
  *  @author JR Ridgely
  *
- *  Revisions: @li 4/28/2016 FIXED MASSIVE BUG IN ISR
+ *  Revisions: @li 10/16/2026 ERR velocity estimated from counts and edge times
+ *             @li 10/16/2026 ERR samples come from the HCTL driver's timer ISR
+ *             @li 4/28/2016 FIXED MASSIVE BUG IN ISR
  *             @li 4/26/2016 started ISR code alogorithm used is a half wave 
  *             checker
  *             @li 09-30-2012 JRR Original file was a one-file demonstration
@@ -66,13 +68,16 @@
 #include "adc.h"                            // Header for A/D converter driver class
 #include "motor_driver.h"                   // Header for Generic Motor driver
 #include "hctl_driver.h"                    // Header for the EHTCL Driver
+#include "velocity_estimator.h"             // Low and high speed velocity
+
+/// How often the task publishes the latest encoder sample, in milliseconds
+#define ENCODER_PERIOD_MS 5
 
 /**
- * @brief      this is the declaration for 'task_encoder' which directly 
- *             handles the htcl_driver. it contains necessary logic for 
- *             correct behavior needed at high rpms when the 12bit counter 
- *             overflows and it is necessary to try and guess whether we're 
- *             going forwards or backwards based on encoder ticks **ONLY**
+ * @brief      this is the declaration for 'task_encoder' which publishes
+ *             the samples taken by the htcl_driver's timer interrupt. The
+ *             driver extends the 12bit counter to 32 bits itself, so no
+ *             guessing about overflows is needed here.
  */
 
 class task_encoder : public TaskBase
@@ -80,15 +85,8 @@ class task_encoder : public TaskBase
 private:
 
 protected:
-    /// This variable hold the previous count of encoder ticks since the last time the task was called.
-    int16_t previous_encoder_count;
-
-    /// This is the diffrence between the global count and the local count
-    //int16_t previous_encoder_difference;
-
-    int16_t this_count;
-
-    int16_t this_difference;
+    /// This finds the velocity from the samples, timing edges at low speed
+    velocity_estimator velocity;
 
 public:
     ///This is the constructor prototype, added the pointer for an encoder_driver to be passed in by main.
@@ -98,8 +96,6 @@ public:
     void run (void);
     /// This is the declaration for the local copy of the encoder_driver pointer.
     hctl_driver* p_hctl;
-
-    uint16_t my_abs(int16_t);
     
     
 };
@@ -14,6 +14,7 @@
  *  @author Eddie Ruano
  *
  *  Revisions:
+        @ 10/16/2026 ERR Added IMU_PERIOD_MS for the faster burst reads.
         @ 5/30/2016 <<EDD>> added comments, updated license.
         @ 5/28/2016 <<EDD>> created barebones
 
@@ -50,6 +51,13 @@
 #include "task_imu.h"               // Header for the BNO055 Sensor Driver
 #include "bno055_driver.h"
 
+/** @brief      Period of the IMU task in milliseconds.
+ *  @details    The BNO055 updates its fused orientation at 100 Hz, so there's
+ *              no point reading it faster than every 10 ms. One burst read
+ *              takes well under a millisecond at 400 kHz.
+ */
+#define IMU_PERIOD_MS   20
+
 /**
  * @brief       { class_description } 
  * 
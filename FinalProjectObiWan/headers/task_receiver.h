@@ -12,6 +12,8 @@
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 05-25-2016 ATL task_brightness used as the template for task_reciever
  *    @li 05-27-2016 ATL added thread delay and watchdog timeout constants
+ *    @li 10-16-2026 ERR Frame decoder for the joystick link
+ *    @li 10-16-2026 ERR Latency statistics for commands from the joystick link
  *
  *  License:
  *    This file is copyright 2016 by AT Lombardi and released under the Lesser GNU
@@ -46,6 +48,7 @@
 #include "taskshare.h"                      // Header for thread-safe shared data
 
 #include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "frame_codec.h"                    // Framed protocol for the joystick link
 
 //-------------------------------------------------------------------------------------
 /** @brief   This task controls the reception and translation of commands over serial.
@@ -79,6 +82,16 @@ private:
     int16_t gear_rec;
     uint8_t temp_x;
     uint8_t temp_y;
+    /// Decoder for frames from the controller, fed by the receive interrupt
+    frame_decoder link;
+    /// Shortest time from a frame's delimiter to its delivery, in microseconds
+    uint32_t latency_min;
+    /// Longest time from a frame's delimiter to its delivery, in microseconds
+    uint32_t latency_max;
+    /// Sum of the times measured since the last report, in microseconds
+    uint32_t latency_sum;
+    /// Number of times measured since the last report
+    uint16_t latency_count;
 
 protected:
     // No protected variables or methods for this class
@@ -105,6 +118,7 @@ public:
     bool getCommand(void);
     bool receivePayload(void);
     void deliverPayload(void);
+    void measureLatency(void);
     char buffer[13];
     uint8_t hexConversion(char a);
     int16_t decodeValue(char a, char b, char c, char d);
@@ -181,7 +181,7 @@ void task_user::printDashBoard(void)
                 << PMS ("-------\t\t--------\t-------\t\t-----------")
                 << endl
                 << PMS ("Motor 1\t\t")
-                << steering_power-> get()
+                << steering_snapshot -> get().steering_power
                 << PMS("\t")
                 << PMS("\t")
                 << x_direction
@@ -207,6 +207,10 @@ void task_user::print_help_message (void)
     *p_serial << PMS ("  t:     Show the time right now") << endl;
     *p_serial << PMS ("  s:     Version and setup information") << endl;
     *p_serial << PMS ("  d:     Stack dump for tasks") << endl;
+    *p_serial << PMS ("  o:     Overruns of task periods") << endl;
+#ifdef TASK_PROFILE
+    *p_serial << PMS ("  p:     Histogram of task run times") << endl;
+#endif
     *p_serial << PMS ("  n:     Enter a number (demo)") << endl;
     *p_serial << PMS ("  Ctl-C: Reset the AVR") << endl;
     *p_serial << PMS ("  h:     HALP!") << endl;
@@ -307,6 +311,7 @@ void task_user::getNumberInput(void)
  *    \li The name, status, priority, and free stack space of each task
  *    \li Processor cycles used by each task
  *    \li Amount of heap space free and setting of RTOS tick timer
+ *    \li Transactions and errors on the I2C bus, if it's being used
  */
 void task_user::show_status (void)
 {
@@ -329,6 +334,12 @@ void task_user::show_status (void)
     *p_serial << endl;
     print_all_shares (p_serial);
 
+    // If anything has used the I2C bus, show how the transactions went
+    if (p_twi_engine != NULL)
+    {
+        *p_serial << endl;
+        p_twi_engine -> print_status (p_serial);
+    }
 }
 
 /**
@@ -417,7 +428,7 @@ void task_user::printEncoderModuleOptions(void)
         *p_serial << PMS ("|\t\t 'r'    Refresh the data                \t\t|") << endl;
         *p_serial << PMS ("|\t\t 'q'    quit to main menu               \t\t|") << endl;
         *p_serial << PMS("Encoder Count: ") << encoder_count -> get() << endl
-                  << PMS("Encoder Ticks/ms: ") << encoder_ticks_per_task -> get() << endl
+                  << PMS("Encoder Ticks/task: ") << encoder_ticks_per_task -> get() << endl
                   << endl << PMS("\t\t-> press 'r' to refresh ") << endl << endl;
         is_menu_visible = true;
     }
@@ -0,0 +1,233 @@
+//*************************************************************************************
+/** \file twi_engine.h
+ *    This file contains an interrupt driven driver for the TWI (I2C) port on an AVR.
+ *    Instead of waiting in a loop for the @c TWINT flag after every byte, as the
+ *    @c i2c_master and @c i2c_driver classes once did, a task puts a description of
+ *    a whole transaction into a queue and sleeps. The TWI interrupt service routine
+ *    then steps through the start condition, address, register, data bytes, repeated
+ *    start and stop condition on its own; when the transaction is finished it gives a
+ *    semaphore which wakes the task. While the bytes are being clocked out on the bus,
+ *    lower priority tasks are free to run.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It is intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this file from being included more than once in a *.cpp file
+#ifndef _TWI_ENGINE_H_
+#define _TWI_ENGINE_H_
+
+#include <stdlib.h>                         // Standard C/C++ library stuff
+#include "FreeRTOS.h"                       // Header for the RTOS
+#include "semphr.h"                         // FreeRTOS semaphores
+#include "emstream.h"                       // Header for base serial devices
+#include "time_stamp.h"                     // Fast clock used to time transactions
+
+
+/// @brief The default bit rate for the TWI port, in bits per second.
+#define TWI_BITRATE             400000L
+
+/** @brief   The number of RTOS ticks a task waits for a transaction to finish.
+ *  @details Even a long transaction at 100 kHz takes only a few milliseconds, so a
+ *           transaction which takes longer than this has been stuck by a device
+ *           holding the bus; it's taken out of the queue and marked as timed out.
+ */
+#define TWI_TIMEOUT_TICKS       (configTICK_RATE_HZ / 20)
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Results of a TWI transaction.
+ *  @details A transaction is @c TWI_PENDING while it waits in the queue and
+ *           @c TWI_BUSY while its bytes are being sent; after that, it has one of the
+ *           other values, which tell whether it worked and if not, what went wrong.
+ */
+
+enum twi_status
+{
+	TWI_PENDING,                            ///< Waiting in the queue
+	TWI_BUSY,                               ///< Being carried out on the bus
+	TWI_OK,                                 ///< Finished with no errors
+	TWI_NACK_ADDRESS,                       ///< No device answered at the address
+	TWI_NACK_DATA,                          ///< The device refused a data byte
+	TWI_ARB_LOST,                           ///< Another master took over the bus
+	TWI_BUS_ERROR,                          ///< Illegal start or stop, or odd status
+	TWI_TIMEOUT                             ///< The transaction didn't finish in time
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Description of one transaction on the TWI bus.
+ *  @details A transaction has up to two phases. In the write phase, the register
+ *           address (if @c send_reg is true) and then @c write_count bytes from
+ *           @c p_write are sent to the device. In the read phase, which follows a
+ *           repeated start if there was a write phase, @c read_count bytes are read
+ *           from the device into @c p_read. A stop condition ends the transaction.
+ *           The usual transactions are made by the @c set_...() methods:
+ *           | Method                | Bus traffic                                  |
+ *           |:----------------------|:---------------------------------------------|
+ *           | @c set_write_reg()    | S, SLA+W, reg, data, P                       |
+ *           | @c set_write()        | S, SLA+W, reg, data[0..n-1], P               |
+ *           | @c set_read()         | S, SLA+W, reg, Sr, SLA+R, data[0..n-1], P    |
+ *
+ *           The buffers belong to the task which made the transaction, and they must
+ *           not be touched until the transaction is finished; the byte written by
+ *           @c set_write_reg() is copied into the transaction, so it needs no buffer.
+ *           The times at which the transaction was queued, began and ended are kept
+ *           as raw times from @c get_raw_time() so that slow devices and a crowded
+ *           bus can be found.
+ */
+
+class twi_transaction
+{
+public:
+	uint8_t address;                        ///< 7-bit bus address of the device
+	bool send_reg;                          ///< True to send @c reg before the data
+	uint8_t reg;                            ///< Register address within the device
+	uint8_t write_count;                    ///< Number of bytes to write
+	const uint8_t* p_write;                 ///< Bytes to be written to the device
+	uint8_t read_count;                     ///< Number of bytes to read
+	uint8_t* p_read;                        ///< Buffer for bytes read from the device
+	uint8_t one_byte;                       ///< Holds the data for @c set_write_reg()
+	volatile twi_status status;             ///< How the transaction is going
+
+	uint32_t queue_time;                    ///< Raw time at which it was queued
+	uint32_t start_time;                    ///< Raw time at which it began on the bus
+	uint32_t end_time;                      ///< Raw time at which it finished
+
+	/// Semaphore given by the interrupt service routine when the transaction is done
+	SemaphoreHandle_t done;
+
+	/// The next transaction in the queue, or @c NULL if this is the last one
+	twi_transaction* p_next;
+
+	// Create an empty transaction, with its own semaphore if asked for one
+	twi_transaction (bool make_semaphore = true);
+
+	// Set up a transaction which writes one byte to a register
+	void set_write_reg (uint8_t addr, uint8_t a_reg, uint8_t data);
+
+	// Set up a transaction which writes bytes to consecutive registers
+	void set_write (uint8_t addr, uint8_t a_reg, const uint8_t* p_data, uint8_t count);
+
+	// Set up a transaction which reads bytes from consecutive registers
+	void set_read (uint8_t addr, uint8_t a_reg, uint8_t* p_data, uint8_t count);
+
+	/** @brief   Get the time the transaction waited in the queue.
+	 *  @return  The time from queueing to the start condition, in microseconds
+	 */
+	uint32_t get_wait_us (void)
+	{
+		return (raw_time_to_us (start_time - queue_time));
+	}
+
+	/** @brief   Get the time the transaction took on the bus.
+	 *  @return  The time from the start condition to the end, in microseconds
+	 */
+	uint32_t get_transfer_us (void)
+	{
+		return (raw_time_to_us (end_time - start_time));
+	}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Interrupt driven master for the TWI (I2C) bus.
+ *  @details There is only one TWI port, so only one of these objects should be made;
+ *           the interrupt service routine finds it through @c p_twi_engine. Any
+ *           number of tasks can share it, as each transaction is put in a queue and
+ *           run in turn. A task calls @c transfer() to queue a transaction and sleep
+ *           until it's done, or @c submit() to queue one and carry on, checking the
+ *           transaction's status or taking its semaphore later.
+ */
+
+class twi_engine
+{
+protected:
+	/// The transaction being carried out on the bus, first in the queue
+	twi_transaction* volatile p_head;
+
+	/// The last transaction in the queue
+	twi_transaction* volatile p_tail;
+
+	/// Index of the next byte to be written or read in the current transaction
+	uint8_t index;
+
+	/// True while sending the register address at the beginning of the write phase
+	bool reg_next;
+
+	/// Number of transactions which have finished successfully
+	uint32_t ok_count;
+
+	/// Number of transactions which have failed, for any reason
+	uint16_t error_count;
+
+	/// Status of the most recent transaction which failed
+	twi_status last_error;
+
+	/// Longest time any transaction has taken on the bus, in microseconds
+	uint32_t max_transfer_us;
+
+	/// True when a finished transaction has woken a task of higher priority
+	bool task_woken;
+
+	// Begin the transaction at the head of the queue with a start condition
+	void start_head (bool after_stop);
+
+	// Finish the transaction at the head of the queue and start the next one
+	void finish_head (twi_status result, bool stop_allowed = true);
+
+public:
+	// Set up the TWI port and an empty queue of transactions
+	twi_engine (uint32_t bitrate = TWI_BITRATE);
+
+	// Put a transaction in the queue without waiting for it to finish
+	void submit (twi_transaction* p_trans);
+
+	// Put a transaction in the queue and wait until it's done or has timed out
+	twi_status transfer (twi_transaction* p_trans,
+						 TickType_t timeout = TWI_TIMEOUT_TICKS);
+
+	// Take a transaction which hasn't finished out of the queue
+	void cancel (twi_transaction* p_trans, twi_status result);
+
+	// Take the next step in the current transaction; called only by the ISR
+	void isr (void);
+
+	// Switch to a task woken by a finished transaction; called only by the ISR
+	void yield_if_woken (void);
+
+	/** @brief   Check whether any transactions are waiting or being run.
+	 *  @return  True if the bus is busy with queued transactions
+	 */
+	bool is_busy (void)
+	{
+		return (p_head != NULL);
+	}
+
+	// Print the number of transactions and errors and the longest transfer time
+	void print_status (emstream* p_ser_dev);
+};
+
+
+/// Pointer to the one TWI engine, used by the TWI interrupt service routine
+extern twi_engine* p_twi_engine;
+
+// Print a short name for a transaction's status
+emstream& operator << (emstream& serpt, twi_status status);
+
+#endif // _TWI_ENGINE_H_
@@ -0,0 +1,114 @@
+//*************************************************************************************
+/** \file velocity_estimator.h
+ *    This file contains a class which estimates the speed of a shaft from encoder
+ *    counts. Counting how many encoder edges arrive in each task period works well
+ *    at high speed, but at low speed only a few edges arrive, so the estimate jumps
+ *    between a few values and a PID loop using it jitters. Timing the interval
+ *    between edges (the "1/T" method) is precise at low speed but noisy at high
+ *    speed, where the time between edges is only a few timer counts. This class uses
+ *    the edge times at low speed and switches to counts over the period at high
+ *    speed, then smooths the result with a simple low-pass filter.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It is intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this file from being included more than once in a *.cpp file
+#ifndef _VELOCITY_ESTIMATOR_H_
+#define _VELOCITY_ESTIMATOR_H_
+
+#include <stdint.h>                         // Standard integer types
+#include "time_stamp.h"                     // Raw times and their conversion
+
+
+/// Number of fractional bits in a velocity, which is in counts per millisecond
+#define VELOCITY_FRAC_BITS      4
+
+/** @brief   Number of counts per update above which velocity is found by counting.
+ *  @details With fewer counts than this since the last update, the counts are timed
+ *           from edge to edge instead.
+ */
+#define VELOCITY_SWITCH_COUNTS  8
+
+/** @brief   Strength of the low-pass filter, as a shift.
+ *  @details Each update moves the filtered velocity 1 / 2^shift of the way toward the
+ *           new estimate; 2 gives a time constant of about four updates.
+ */
+#define VELOCITY_FILTER_SHIFT   2
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Estimates shaft speed from encoder counts and edge times.
+ *  @details A task calls @c update() once per period with the encoder count, the
+ *           raw time (from @c get_raw_time() or @c get_raw_time_ISR()) at which the
+ *           count last changed, and the raw time now. The estimate is found one of
+ *           three ways:
+ *           \li If at least @c VELOCITY_SWITCH_COUNTS counts arrived since the last
+ *               update, the velocity is the change in count over the time since the
+ *               last update.
+ *           \li If fewer counts arrived, the velocity is the change in count over the
+ *               time between the last edge seen before and the newest edge. This is
+ *               the 1/T method; it spans whole edge intervals, so it doesn't quantize.
+ *           \li If no counts arrived, the shaft can be going no faster than one count
+ *               in the time since the last edge, so the velocity is limited to that.
+ *               It falls smoothly toward zero as the shaft stops.
+ *
+ *           The velocity is a fixed-point number of counts per millisecond with
+ *           @c VELOCITY_FRAC_BITS fractional bits, so it fits in the @c int16_t shares
+ *           which @c task_pid uses.
+ */
+
+class velocity_estimator
+{
+protected:
+	int32_t last_count;                     ///< Count at the last update
+	uint32_t last_time;                     ///< Raw time of the last update
+	int32_t edge_count;                     ///< Count at the newest edge used
+	uint32_t edge_time;                     ///< Raw time of the newest edge used
+	int32_t estimate;                       ///< Unfiltered velocity, counts/ms fixed
+	int32_t filtered;                       ///< Filtered velocity, with extra bits
+	bool primed;                            ///< True once there's a first update
+
+	// Find a velocity from a change in count over a time in raw timer counts
+	static int32_t rate (int32_t counts, uint32_t raw_time);
+
+public:
+	// Create an estimator which starts at zero velocity
+	velocity_estimator (void);
+
+	// Take the newest count and edge time and update the velocity
+	int16_t update (int32_t count, uint32_t a_edge_time, uint32_t now);
+
+	/** @brief   Get the filtered velocity found by the last update.
+	 *  @return  The velocity in counts per millisecond, with fractional bits
+	 */
+	int16_t get_velocity (void)
+	{
+		return ((int16_t)(filtered >> VELOCITY_FILTER_SHIFT));
+	}
+
+	/** @brief   Get the velocity found by the last update before it was filtered.
+	 *  @return  The velocity in counts per millisecond, with fractional bits
+	 */
+	int16_t get_raw_velocity (void)
+	{
+		return ((int16_t)estimate);
+	}
+};
+
+#endif // _VELOCITY_ESTIMATOR_H_
@@ -126,29 +126,25 @@ TaskShare<uint8_t>* motor_directive;
 TaskShare<int32_t>* encoder_count;
 /// This variable holds the ticks per seconds so that other tasks like task_user may access it.
 TaskShare<int16_t>* encoder_ticks_per_task;
+/// Filtered encoder velocity in ticks per ms with 4 fractional bits
+TaskShare<int16_t>* encoder_velocity;
 /// for IMU data read
 TaskShare<uint32_t>* data_read;
 
 TaskShare<uint8_t>* activate_encoder;
 
-TaskShare<int16_t>* steering_power;
 TaskShare<int16_t>* steering_angle;
 TaskShare<int16_t>* steering_target;
 
-TaskShare<int16_t>* x_joystick;
-
-TaskShare<int16_t>* y_joystick;
+/// Holds the joystick positions and steering power, written together
+SnapshotShare<steering_sample>* steering_snapshot;
 
 TaskShare<int16_t>* gear_state;
 
 /*Start IMU variables */
-TaskShare<int16_t>* heading;
-/// Holds change in heading since last reading
-TaskShare<int16_t>* del_heading;
-/// Holds current roll taken from BNO055 chip on BNO055 driver every 100 ms
-TaskShare<int16_t>* roll;
-/// Holds current pitch taken from BNO055 chip on BNO055 driver every 100 ms 
-TaskShare<int16_t>* pitch;
+/// Holds the heading, change in heading, roll and pitch taken together from the
+/// BNO055 chip on BNO055 driver every 100 ms
+SnapshotShare<imu_sample>* imu_snapshot;
 
 
 
@@ -181,6 +177,13 @@ int main (void)
     //initialize the A/D converter for potentiometer control
     adc* p_main_adc = new adc (p_ser_port);
 
+    // Scan the joystick channels in the background so tasks never wait for the A/D,
+    // oversampling each one to get 12-bit readings
+    const uint8_t joystick_channels[] = {0, 1};
+    p_main_adc->set_oversampling (0, 2);
+    p_main_adc->set_oversampling (1, 2);
+    p_main_adc->start_scan (joystick_channels, 2);
+
     // Create the queues and other shared data items here
     p_print_ser_queue = new TextQueue (32, "Print", p_ser_port, 10);
 
@@ -191,38 +194,36 @@ int main (void)
     // Start Shares Encoder Variables
     encoder_count = new TaskShare<int32_t> ("Encoder Pulse Count");
     encoder_ticks_per_task = new TaskShare<int16_t> ("Encoder Pulse Per Time");
+    encoder_velocity = new TaskShare<int16_t> ("Encoder Velocity");
     // Start Shares IMU variables
     data_read   = new TaskShare<uint32_t> ("imu data");
 
     // Start Shares Steering Variables
-    steering_power  = new TaskShare<int16_t> ("Steering Power");
     steering_angle = new TaskShare<int16_t> ("Steering Angle");
     steering_target = new TaskShare<int16_t> ("Target Angle");
-    // Start Shares oystick Position Variables
-    x_joystick  = new TaskShare<int16_t> ("X Joystick Position");
-    y_joystick  = new TaskShare<int16_t> ("Y Joystick Position");
+    // Start Shares Joystick Position and Steering Power Variables
+    steering_snapshot = new SnapshotShare<steering_sample> ("Steering");
     // Start  Shares Gear Variables
     gear_state      = new TaskShare<int16_t> ("Shift State");
     // Start IMU Position variables
-    heading         = new TaskShare<int16_t> ("Vehicle Heading");
-    del_heading     = new TaskShare<int16_t> ("Heading delta");
-    roll            = new TaskShare<int16_t> ("Vehicle Roll");
-    pitch           = new TaskShare<int16_t> ("Vehicle Pitch");
+    imu_snapshot    = new SnapshotShare<imu_sample> ("Vehicle IMU");
 
     // //initilaize two different motor driver pointers to pass into two tasks
-    motor_driver* p_motor1 = new motor_driver(p_ser_port, &PORTC, &PORTC, &PORTB, &OCR1B, PC0, PC1, PC2, PB6);
+    motor_driver* p_motor1 = new motor_driver_pins<Pin<PortC, PC0>, Pin<PortC, PC1>, Pin<PortC, PC2>, Pin<PortB, PB6>, Reg_OCR1B> (p_ser_port);
     motor_directive->put(1);
     //USE TIMER AND COUNTER 3
     // this is steering
-    servo_driver* p_steering_servo = new servo_driver(p_ser_port, &TCCR3A, &TCCR3B, &ICR3, &OCR3A, 8, 20000, PE3);
+    servo_driver* p_steering_servo = new servo_driver_pins<Pin<PortE, PE3>, Reg_OCR3A> (p_ser_port, &TCCR3A, &TCCR3B, &ICR3, 8, 20000);
     // this is shifting
 
     //encoder_driver* p_encoder1 = new encoder_driver(p_ser_port, &EICRB, &EIMSK, &DDRE, ISC60, ISC70, INT6, INT7, PE6, PE7);
 
-    servo_driver* p_shift_servo = new servo_driver(p_ser_port, &TCCR3A, &TCCR3B, &ICR3, &OCR3B, 8, 20000, PE4);
+    servo_driver* p_shift_servo = new servo_driver_pins<Pin<PortE, PE4>, Reg_OCR3B> (p_ser_port, &TCCR3A, &TCCR3B, &ICR3, 8, 20000);
 
     // make instance of hctl_driver to count external ticks from hctl chip
-    hctl_driver* p_hctl = new hctl_driver(p_ser_port, &PORTA, &PORTC, 7, &PORTC, 6);
+    hctl_driver* p_hctl = new hctl_driver_pins<PortA, Pin<PortC, PC7>, Pin<PortC, PC6> > (p_ser_port);
+    // sample it from the Timer 4 interrupt at an exact rate
+    p_hctl->start_sampling(HCTL_SAMPLE_RATE_HZ);
 
     // bno055_driver* bno055_ptr = new bno055_driver(p_ser_port, 0x29);
     
@@ -261,7 +262,7 @@ int main (void)
     gear_state -> put(0);
     
     // motor_setpoint->put(1020);
-    // new task_pid ("PID", task_priority(3), 280, p_ser_port, motor_setpoint, encoder_ticks_per_task, motor_power, 1024, 0, 0, 0, -1023, 1023);
+    // new task_pid ("PID", task_priority(3), 280, p_ser_port, motor_setpoint, encoder_velocity, motor_power, 1024, 0, 0, 0, -1023, 1023);
 
     
     // steering_angle->put(0);
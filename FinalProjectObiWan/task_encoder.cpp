@@ -13,7 +13,11 @@
  *  @author Eddie Ruano
  *  @author JR Ridgely
  *
- *  Revisions: @li 5/3/2016 <<EDD>> INCORPORATE NEW HTCL CHIP CODE
+ *  Revisions: @li 10/16/2026 ERR ticks per task are the change since the last
+ *             publish, not over the last 1 ms sample
+ *             @li 10/16/2026 ERR velocity estimated from counts and edge times
+ *             @li 10/16/2026 ERR samples come from the HCTL driver's timer ISR
+ *             @li 5/3/2016 <<EDD>> INCORPORATE NEW HTCL CHIP CODE
  *             @li 4/28/2016 FIXED MASSIVE BUG IN ISR
  *             @li 4/26/2016 started ISR code alogorithm used is a half wave
  *             checker
@@ -55,9 +59,6 @@
 #include "shares.h"                       // Shared inter-task communications
 #include "time_stamp.h"
 
-#define MAX_SPREAD 1700
-#define LIMIT 4095
-
 /**
  * @brief      This is the constructor for the task_encoder class.
  * @details    It initialzes all the variables given to the TaskBase super
@@ -87,25 +88,25 @@ task_encoder::task_encoder (
 {
    /// Initialize pointer passed from main() to local variable to work with
    p_hctl = p_hctl_inc;
-   previous_encoder_count = 0;
-   //previous_encoder_difference = 0; 
-   this_difference = 0;
-   this_count = 0;
 }
 
 
 /**
  * @brief      This method is called once by the RTOS scheduler.
  *
- * @details    Each time that this method is run it initializes a tickcount and
- *             loops in an infinite for(;;) loop that compares the last tick
- *             count stored locally with the most current reading of encoder
- *             count which lies in the global TaskShare variable
- *             'encoder_count'. It then waits 10 ms to run again and since it
- *             has the highest priority we know that it will certainly run
- *             every 10ms. This means if we multiply the difference in encoder
- *             counts (local vs. global) and use the constant time difference
- *             we can obtain an estimate of the counts per sec.
+ * @details    The HCTL driver's timer interrupt samples the counter at an
+ *             exact rate and extends it to 32 bits, so this task no longer
+ *             has to run every 1 ms and guess at overflows. Each time through
+ *             the loop it copies the latest sample into the global TaskShare
+ *             variables: 'encoder_count' gets the 32-bit position, and
+ *             'encoder_ticks_per_task' gets the change in the count since the
+ *             last time it was published, normally ENCODER_PERIOD_MS before;
+ *             as each count comes from the timer interrupt, the change is
+ *             over a whole number of exact sample periods. The
+ *             velocity estimator turns the count and the time of its last
+ *             change into 'encoder_velocity', which doesn't quantize at low
+ *             speed as the count per period does. It runs every
+ *             ENCODER_PERIOD_MS, as often as the PID task.
  */
 
 void task_encoder::run (void)
@@ -113,59 +114,40 @@ void task_encoder::run (void)
    // Make a variable which will hold times to use for precise task scheduling
    TickType_t previousTicks = xTaskGetTickCount ();
 
-   
-   // The loop to continully check the encoder
+   // Start the timer interrupt sampling, if main() hasn't already
+   if (p_hctl -> get_sample_rate() == 0)
+   {
+      p_hctl -> start_sampling(HCTL_SAMPLE_RATE_HZ);
+   }
+
+   hctl_sample sample;
+
+   // The count which was published last, and whether there's been one yet
+   int32_t last_count = 0;
+   bool have_last_count = false;
+
+   // The loop to continully publish the encoder samples
    while (1)
    { 
-      //read value from chip
-      this_count = p_hctl -> read();
-      // find raw difference w/o taking into account overflow
-      this_difference = this_count - previous_encoder_count;
-
-      //fix the difference to account for overflow
-      if(my_abs(this_difference) > MAX_SPREAD)
+      if (p_hctl -> get_sample(sample))
       {
-         //an overflow occurred, must find correct ticks difference
-         //if this reading is smaller e.g 375 and prev was like 3800 we know
-         //we are counting up and overflowed
-         if(this_count < previous_encoder_count)
-         {
-            this_difference = ((LIMIT - previous_encoder_count) + this_count);
-         }
-         else // we know we are counting down so neg
-         {
-            this_difference = -1 * ((LIMIT - this_count) + previous_encoder_count);
-         }
-         //*p_serial <<endl<<endl<<this_difference<<endl<<this_count<<endl<<previous_encoder_count<<endl<<endl;
-
+         encoder_count -> put(sample.count);
+         //place the ticks since the last publish in the shares variable
+         encoder_ticks_per_task -> put(have_last_count
+                                       ? (int16_t)(sample.count - last_count) : 0);
+         last_count = sample.count;
+         have_last_count = true;
+         //timed edges at low speed, counts at high speed, filtered
+         encoder_velocity -> put(velocity.update(sample.count, sample.edge_time,
+                                                 sample.time));
       }
-      // add the correct difference to the encoder_count variable
-      encoder_count -> put((encoder_count -> get()) + (int32_t)this_difference);
-      //place ticks per MS in this case in the correct shares variable
-      encoder_ticks_per_task -> put(this_difference);
-
-      // store the current count as previous
-      previous_encoder_count = this_count;
-
 
    // Increment the run counter. This counter belongs to the parent class and can
    // be printed out for debugging purposes
    runs++;
    // This is a method we use to cause a task to make one run through its task
    // loop every N milliseconds and let other tasks run at other times
-   delay_from_for_ms (previousTicks, 1);
+   delay_from_for_ms (previousTicks, ENCODER_PERIOD_MS);
    }
    
 }
-
-uint16_t task_encoder::my_abs(int16_t the_number)
-{
-   if(the_number < 0)
-   {
-      return ((uint16_t)(the_number * -1));
-   }
-   else
-   {
-      return (uint16_t)the_number;
-   }
-}
@@ -8,6 +8,8 @@
  *  @author Eddie Ruano
  *
  *  Revisions:
+        @ 10/16/2026 ERR Reads heading, roll and pitch in one burst and runs
+ *       every IMU_PERIOD_MS instead of every 100 ms.
         @ 6/1/2016 <<EDD>> finally fixed lagg problem
         @ 5/28/2016 <<EDD>> created barebones
 
@@ -56,30 +58,44 @@ task_imu::task_imu (const char* a_name,
  * @brief       Runs to update our shares with Heading, Pitch, Roll
  *
  * @details     We want data that is reliable and that means the most 
- *              IMMEDIATE data in my opinion, So We update every 100ms.
+ *              IMMEDIATE data in my opinion. Heading, roll and pitch are read
+ *              in one 6-byte burst. Each read sends the address, register
+ *              and address again before its data, so the burst takes about
+ *              84 bit times on the bus where three 2-byte reads take about
+ *              144, roughly 40% less, so we can update every IMU_PERIOD_MS.
  */
 void task_imu::run (void)
 {
     TickType_t previousTicks = xTaskGetTickCount ();
 
+    // Holds the most recent readings; the previous heading stays here so that
+    // the change in heading can be found
+    imu_sample sample = {0, 0, 0, 0};
+
+    // Raw readings straight from the BNO055's registers
+    bno055_burst reading;
+
     for (;;)
     {
-        // Update each individual share, once per cycle
-        int16_t old_heading = heading->get();
-        int16_t new_heading = local_bno055_ptr -> getHeading();
-        heading -> put(new_heading);
-        del_heading -> put(new_heading - old_heading);
-        roll -> put(local_bno055_ptr -> getRoll());
-        pitch -> put(local_bno055_ptr -> getPitch());
+        // Take a new set of readings, then publish them all at once so that
+        // other tasks never see a mix of old and new readings
+        if (local_bno055_ptr -> readBurst(reading, BNO055_BURST_EULER))
+        {
+            int16_t new_heading = reading.heading / BNO055_LSB_PER_DEGREE;
+            sample.del_heading = new_heading - sample.heading;
+            sample.heading = new_heading;
+            sample.roll = reading.roll / BNO055_LSB_PER_DEGREE;
+            sample.pitch = reading.pitch / BNO055_LSB_PER_DEGREE;
+            imu_snapshot -> put(sample);
+        }
 
         // Increment the run counter in the parent class.
         runs++;
 
         /* This is a method we use to cause a task to make one run through its 
-         * task loop every 50 milliseconds and let other tasks run at other 
-         * times 
+         * task loop every IMU_PERIOD_MS milliseconds and let other tasks run
+         * at other times 
          */
-        delay_from_for_ms (previousTicks, 100);
+        delay_from_for_ms (previousTicks, IMU_PERIOD_MS);
     }
 }
-
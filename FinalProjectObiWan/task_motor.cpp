@@ -10,7 +10,9 @@
  *
  *  @author Eddie Ruano
  *
- *  Revisions: @ 4/20/2016 added main structure
+ *  Revisions: @ 10/16/2026 ERR the potentiometer is read with the extra bits
+ *             from oversampling, so the power moves in steps of 1, not 2
+ *             @ 4/20/2016 added main structure
  *             @ 4/22/2016 added pointers and correct logic
  *  License:
  *    This file is copyright 2016 by Eddie Ruano and released under the Lesser
@@ -144,7 +146,11 @@ void task_motor::run (void)
             else if (LOCAL_motor_directive == POTENTIOMETER)
             {
                 //create variable to hold the reading of the adc. 1023
-                uint16_t duty_cycle = 2 * (p_adc -> read_once(0));
+                //times 2, scaled once from the oversampled reading so its
+                //extra bits fill in the odd numbers
+                uint8_t extra_bits;
+                uint16_t reading = p_adc -> read_full(0, extra_bits);
+                uint16_t duty_cycle = ((uint32_t)reading << 1) >> extra_bits;
                 //convert the duty cycle into a signed variable and divide by
                 int16_t power = ((int16_t)duty_cycle - RECENTER);
 
@@ -12,6 +12,9 @@
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 05-25-2016 ATL task_brightness used as template for task_reciever
  *    @li 05-27-2016 ATL added parsing of hex values into controls in drive mode, and imitation watchdog
+ *    @li 10-16-2026 ERR Joystick frames decoded in the receive ISR with CRC checks
+ *    @li 10-16-2026 ERR Receive ISR wakes the task for each frame; latency measured
+ *    @li 10-16-2026 ERR Latency timed from the end of each frame, as test_receiver does
  *
  *  License:
  *    This file is copyright 2016 by AT Lombardi and released under the Lesser GNU
@@ -50,6 +53,40 @@
 #define THREAD_DELAY    1000 // msec
 // #define WDT_TIMEOUT  (50000 / THREAD_DELAY) // 20 sec / delay = # of loops before timeout
 
+/// The longest the task sleeps when no frames arrive, in milliseconds
+#define LINK_TIMEOUT_MS 100
+
+/// The number of frames between reports of the link's errors and latency
+#define LINK_REPORT_FRAMES 500
+
+/// The decoder which the serial port's receive interrupt feeds
+static frame_decoder* p_link_decoder = NULL;
+
+/// Raw time at which the delimiter ending the newest good frame came in
+static volatile uint32_t link_good_end = 0;
+
+/**
+ * @brief      Hands a character from the joystick link to the frame decoder.
+ * @details    This runs in the USART0 receive interrupt, set as the port's hook.
+ *             The time at which each good frame's delimiter arrives is saved, so
+ *             the task can measure how long it takes to wake and deliver the
+ *             command. The time the frame spends on the wire before that is fixed
+ *             by its length and the baud rate, so it isn't measured.
+ *
+ * @param[in]  data  The character which arrived
+ *
+ * @return     True if the character finished a good frame, which wakes the task
+ */
+static bool link_rx_hook(uint8_t data)
+{
+    bool good = p_link_decoder -> feed(data);
+    if (good)
+    {
+        link_good_end = get_raw_time_ISR();
+    }
+    return good;
+}
+
 //-------------------------------------------------------------------------------------
 /** This constructor creates a task which handles translating incoming commands from the
  *  serial port on E0 and E1. The main job of this constructor is to call the
@@ -78,12 +115,25 @@ task_receiver::task_receiver (
     mode = 0;
     paired = false;
     // set up USART0 on E0 and E1 for external comms
-    p_ser_bt = new rs232(0, 0);
+    // 115200 baud doesn't fit in the constructor's parameter, so the port is made
+    // at 9600 and the divisor is changed; a baud rate of 0 would divide by zero
+    p_ser_bt = new rs232(9600, 0);
     UCSR0A |= (1 << U2X0); // set the double-speed bit
     UBRR0 = 16; // set baud rate to 115200
     // memset(message, 0, 3);
     runcount = 0;
-    memset(superbuffer, 0, 2);
+    memset(superbuffer, 0, 3);
+
+    latency_min = 0xFFFFFFFF;
+    latency_max = 0;
+    latency_sum = 0;
+    latency_count = 0;
+
+    // Decode frames from the controller as they arrive, waking this task each time
+    // a good one is finished
+    p_link_decoder = &link;
+    p_ser_bt -> enable_rx_wake();
+    p_ser_bt -> set_rx_hook(link_rx_hook);
 }
 
 
@@ -93,9 +143,6 @@ task_receiver::task_receiver (
 void task_receiver::run (void)
 {
 
-    // Make a variable which will hold times to use for precise task scheduling
-    TickType_t previousTicks = xTaskGetTickCount ();
-
     // Get pair going
     // *p_serial << "In Run" << endl;
     // char pairkey[] = "_CON";
@@ -150,82 +197,74 @@ void task_receiver::run (void)
 
     //Drive Mode, Engage Payload Exchange Protocol
 
-    count = 0;
-    char a;
-    char b;
-    // Start loop that will continously check data
+    // Frames are decoded by the serial port's receive interrupt as their bytes
+    // arrive, and the interrupt wakes this task as soon as a good one is finished.
+    // The timeout only lets the task run now and then when the link is quiet
+    frame_message msg;
     for (;;)
     {
-        while (p_ser_bt -> check_for_char())
+        p_ser_bt -> wait_for_rx(configMS_TO_TICKS(LINK_TIMEOUT_MS));
+
+        bool delivered = false;
+        while (link.get(msg))
         {
-            if(p_ser_bt -> getchar() != '*'){continue;}
-            while(p_ser_bt -> check_for_char() && count < 100 && token)
+            if (msg.type == FRAME_TYPE_JOYSTICK && msg.length >= 2)
             {
-                if(p_ser_bt -> getchar() == '*'){token = false; count = 0;continue;}
-                else
-                {
-                    sup
-                }
-                count++;
-            }
-            // if()
-            // token = true;
-            //while(!= '*'){p_ser_bt -> getchar()continue;}
-            // char_in = p_ser_bt -> getchar();
-
-            // if(!p_ser_bt -> check_for_char()){continue;}
-            // superbuffer[1] = p_ser_bt -> getchar();
-            // if(superbuffer[1] == '*'){token = true;}
-            // if(!p_ser_bt -> check_for_char()){continue;}
-            // superbuffer[2] = p_ser_bt -> getchar();
-            // if (char_in == '*')
-            // {
-                // P
-                
-            // if(token)
-            // {
-                // if (receivePayload())
-                // {
-                //     deliverPayload();
-                //     // token = false;
-                    
-                //     // *p_serial << "Run Count: " << dec << runcount << endl;
-                // }
-                // 
-                // *p_serial << "in passkey" << endl;
-                //if(!p_ser_bt -> check_for_char()){continue;}
-                // superbuffer[1] = a;
-                // // *p_serial << "first" << endl;
-                // //if(!p_ser_bt -> check_for_char()){continue;}
-                // superbuffer[2] = b;
-                // *p_serial << "second" << endl;
+                superbuffer[1] = (char)msg.payload[0];
+                superbuffer[2] = (char)msg.payload[1];
                 deliverPayload();
+                delivered = true;
                 runcount++;
-                *p_serial << runcount << endl;
                 PINE ^= (1 << PE6);
-                // printBuffer();
-                
-            }
-            else 
-            {
-                continue;
-                // *p_serial << '%' << (int8_t)char_in << '%';
             }
-            // *p_serial << hex;
-            // *p_serial << "X Joystick: " << x_joystick -> get() << endl;
-            // *p_serial << "Y Joystick: " << y_joystick -> get() << endl;
-            // *p_serial << "Gear State: " << gear_state -> get() << endl;
-            runcount++;
-
         }
-        delay_from_for_ms(previousTicks, 10);
-        // Print Shares for confirmation
+        if (delivered)
+        {
+            measureLatency();
+        }
         runs++;
+    }
+}
 
-        
+/**
+ * @brief      Measures how long the newest command took to get to the shares.
+ *
+ * @details    The time is from the frame's delimiter arriving at the receive
+ *             interrupt to its values being put in the shares, which is the time
+ *             the task takes to wake and deliver it. Add the time the frame takes
+ *             on the wire for the whole delay. Every LINK_REPORT_FRAMES frames the
+ *             shortest, average and longest times are printed with the link's
+ *             error counts, then the times are started over.
+ */
+void task_receiver::measureLatency()
+{
+    portENTER_CRITICAL();
+    uint32_t start = link_good_end;
+    portEXIT_CRITICAL();
 
+    uint32_t latency = raw_time_to_us(get_raw_time() - start);
+    if (latency < latency_min)
+    {
+        latency_min = latency;
     }
+    if (latency > latency_max)
+    {
+        latency_max = latency;
+    }
+    latency_sum += latency;
+    latency_count++;
 
+    if (latency_count >= LINK_REPORT_FRAMES)
+    {
+        link.print_status(p_serial);
+        *p_serial << PMS("Latency (us): min ") << latency_min << PMS(", avg ")
+                  << latency_sum / latency_count << PMS(", max ") << latency_max
+                  << endl;
+        latency_min = 0xFFFFFFFF;
+        latency_max = 0;
+        latency_sum = 0;
+        latency_count = 0;
+    }
 }
 
 /**
@@ -13,7 +13,9 @@
  *  @author Eddie Ruano
  *  @author JR Ridgely
  *
- *  Revisions: @li 5/3/2016 <<EDD>> INCORPORATE NEW HTCL CHIP CODE
+ *  Revisions: @li 10-16-2026 ERR Y joystick published with the extra bits
+ *             from oversampling
+ *             @li 5/3/2016 <<EDD>> INCORPORATE NEW HTCL CHIP CODE
  *             @li 4/28/2016 FIXED MASSIVE BUG IN ISR
  *             @li 4/26/2016 started ISR code alogorithm used is a half wave
  *             checker
@@ -96,8 +98,6 @@ task_steering::task_steering (
    /// Initialize pointer passed from main() to local variable to work with
    p_local_servo_driver = p_servo_inc;
    local_channel_select = channel_select_inc;
-
-   initJoystick(local_channel_select);
 }
 
 
@@ -120,6 +120,13 @@ void task_steering::run (void)
    // Make a variable which will hold times to use for precise task scheduling
    TickType_t previousTicks = xTaskGetTickCount ();
 
+   // Holds the joystick and steering values, which are published together
+   steering_sample sample = {0, 0, 0};
+
+   // Find the joystick's center here rather than in the constructor, so the A/D
+   // scan is running and the readings are spread out over time
+   initJoystick(local_channel_select);
+
    // The loop to contunially run the motors
    while (1)
    {
@@ -156,17 +163,18 @@ void task_steering::run (void)
 
       if (local_channel_select == 1)
       {
-         x_joystick -> put(corrected_value);
+         sample.x_joystick = corrected_value;
       }
 
-      int16_t adc_y = (int16_t) p_local_adc -> read_once(0);
-
-      y_joystick -> put(adc_y);
+      // Keep the bits oversampling adds; the scan set up in main() makes 12
+      uint8_t extra_bits;
+      sample.y_joystick = (int16_t) p_local_adc -> read_full(0, extra_bits);
 
 
       p_local_servo_driver -> setServoAngle(corrected_value);
 
-      steering_power -> put(corrected_value);
+      sample.steering_power = corrected_value;
+      steering_snapshot -> put(sample);
 
       //*p_serial << PMS("corrected_angle: ") << corrected_angle << endl;
 
@@ -182,6 +190,16 @@ void task_steering::run (void)
 }
 
 
+/**
+ * @brief      Find how far the joystick's center is from the middle of the A/D
+ *             range.
+ * @details    Ten readings are averaged. The scanner only has a new reading every
+ *             millisecond or so, so this task waits a tick between readings rather
+ *             than averaging the same one ten times. It's called at the start of
+ *             @c run(), when the scheduler is running.
+ *
+ * @param[in]  channel_select  The A/D channel to which the joystick is connected
+ */
 void task_steering::initJoystick (int16_t channel_select)
 {
    int8_t count = 0; 
@@ -190,6 +208,7 @@ void task_steering::initJoystick (int16_t channel_select)
    {
       local_error_adc = local_error_adc + (p_local_adc -> read_once(channel_select));
       count++;
+      delay_ms (1);
    }
 
    local_error_adc = (512 - (local_error_adc / 10));
@@ -57,6 +57,7 @@
 #include "task_user.h"                      // task_user header file
 #include "ansi_terminal.h" //testing ansi
 #include "imu_driver.h"
+#include "twi_engine.h"                     // Interrupt driven I2C, for its status
 #include "task_user_library.h"
 #include "adc.h"
 //Set these defines in case we want to change things later.
@@ -225,6 +226,18 @@ void task_user::run (void)
                 case ('s'):
                     show_status ();
                     break;
+
+                // The 'o' command shows which tasks have overrun their periods
+                case ('o'):
+                    print_task_overruns (p_serial);
+                    break;
+
+                #ifdef TASK_PROFILE
+                // The 'p' command shows a histogram of each task's run times
+                case ('p'):
+                    print_task_profiles (p_serial);
+                    break;
+                #endif
                 // The 'd' means drive control
                 case ('d'):
                     *p_serial << PMS("->Selected: ") << char_in;
@@ -563,6 +576,9 @@ void task_user::run (void)
                 printDriveModeOptions();
                 // printDashBoard();
 
+                // Get the joystick and steering values as one matching set
+                steering_sample steering = steering_snapshot -> get();
+
                 *p_serial
                         << ATERM_CURSOR_TO_YX(19, 1)
                         << ATERM_ERASE_IN_LINE(0)
@@ -578,15 +594,15 @@ void task_user::run (void)
                         << PMS("\t")
                         << ATERM_CURSOR_TO_YX(23, 1)
                         << ATERM_ERASE_IN_LINE(0)
-                        << steering_power -> get()
+                        << steering.steering_power
                         << PMS("    \t")
                         << encoder_ticks_per_task -> get()
                         << PMS("\t")
                         << PMS("\t")
-                        << x_joystick -> get()
+                        << steering.x_joystick
                         << PMS("\t")
                         << PMS("\t")
-                        << y_joystick -> get()
+                        << steering.y_joystick
                         << PMS("\t");
                 // *p_serial << encoder_ticks_per_task -> get() << endl;
 
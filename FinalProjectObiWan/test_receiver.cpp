@@ -0,0 +1,108 @@
+//*************************************************************************************
+/** @file test_receiver.cpp
+ *    This file contains a program which runs @c task_receiver on a PC and times how
+ *    long it takes to deliver joystick commands. One task makes joystick frames the
+ *    way the controller does and puts their bytes one at a time into the simulated
+ *    USART 0, running the receive interrupt for each one, then waits a tick before
+ *    sending the next frame. The receiver prints the shortest, average and longest
+ *    times from each frame's delimiter to its delivery once it has had
+ *    @c LINK_REPORT_FRAMES of them, and then the program ends. Build and run it with
+ *    'make -f Makefile.posix run'.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <stdlib.h>                         // For exit()
+#include <avr/interrupt.h>                  // For running the receive interrupt
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "frame_codec.h"                    // Framed protocol for the joystick link
+#include "taskshare.h"                      // Header for thread-safe shared data
+#include "task_receiver.h"                  // The task being timed
+
+extern "C" void RSI_CHAR_RECV_INT_0 (void);
+
+
+/// The number of frames sent; task_receiver reports after every 500
+#define TEST_FRAMES     500
+
+// The shares which task_receiver writes; the AVR build makes these in main.cpp
+TaskShare<int16_t>* steering_angle;
+TaskShare<int16_t>* motor_setpoint;
+TaskShare<int16_t>* gear_state;
+
+/// The serial port on which results are printed
+static rs232* p_ser_port;
+
+
+/**
+ * @brief      Sends joystick frames through the simulated USART 0 receiver, one
+ *             per tick, then ends the program after the receiver has reported.
+ * @param      p_params  Not used
+ */
+static void sender_task (void* p_params)
+{
+    (void)p_params;
+
+    uint8_t frame[FRAME_ENCODED_MAX];
+
+    // The decoder waits for a delimiter before it trusts the bytes it's given
+    UDR0 = FRAME_DELIMITER;
+    vPortHostInterrupt (RSI_CHAR_RECV_INT_0);
+
+    for (uint16_t count = 0; count < TEST_FRAMES; count++)
+    {
+        uint8_t payload[2] = {(uint8_t)count, (uint8_t)(count >> 3)};
+        uint8_t length = frame_encode (FRAME_TYPE_JOYSTICK, (uint8_t)count, payload, 2,
+                                       frame);
+        for (uint8_t index = 0; index < length; index++)
+        {
+            UDR0 = frame[index];
+            vPortHostInterrupt (RSI_CHAR_RECV_INT_0);
+        }
+        vTaskDelay (1);
+    }
+    vTaskDelay (10);
+
+    *p_ser_port << PMS ("Sent ") << TEST_FRAMES << PMS (" frames") << endl;
+    exit (EXIT_SUCCESS);
+}
+
+
+/**
+ * @brief      Make the shares and tasks and start the scheduler.
+ * @return     Nothing, as the sending task ends the program
+ */
+int main (void)
+{
+    p_ser_port = new rs232 (9600, 1);
+
+    steering_angle = new TaskShare<int16_t> ("Steering Angle");
+    motor_setpoint = new TaskShare<int16_t> ("Motor SetPoint");
+    gear_state = new TaskShare<int16_t> ("Shift State");
+
+    // The receiver has the priority it has in main.cpp, above the sender's
+    new task_receiver ("REC", task_priority (5), 300, p_ser_port);
+    xTaskCreate (sender_task, "Sender", 1000, NULL, 1, NULL);
+    vTaskStartScheduler ();
+
+    return (0);
+}
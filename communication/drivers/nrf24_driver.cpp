@@ -1,13 +1,20 @@
 //Eddie Ruano
 
 //*************************************************************************************
-/** @file adc.cpp
- *    This file contains a very simple A/D converter driver. This driver should be
+/** @file nrf24_driver.cpp
+ *    This file contains an interrupt driven driver for the nRF24L01+ radio. The
+ *    INT0 interrupt wakes a service task which does all the work of moving frames
+ *    between the radio's FIFOs and the driver's queues; other tasks only put
+ *    frames into one queue and take them out of the other.
  *
  *  Revisions:
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR IRQ line handled by an INT0 interrupt, with frame queues,
+ *                       dynamic payloads, auto-ack, and retransmit and loss counters
+ *    @li 10-16-2026 ERR Radio serviced by a task woken by INT0, so its SPI transfers
+ *                       can sleep on the interrupt driven SPI engine
  *
  *  License:
  *    This file is copyright 2015 by JR Ridgely and released under the Lesser GNU
@@ -32,242 +39,558 @@
 #include "rs232int.h"                       // Include header for serial port class
 #include "nrf24_driver.h"
 #include "spi_driver.h"
+#include "spi_engine.h"
 #include "nRF24L01.h"
 
 #define W 1
 #define R 0
 
+/// The flags in the STATUS register which pull the IRQ line low
+#define IRQ_FLAGS ((1 << RX_DR) | (1 << TX_DS) | (1 << MAX_RT))
 
 
+// The radio driver which the INT0 interrupt runs
+nrf24_driver* p_nrf24 = NULL;
 
-nrf24_driver::nrf24_driver (emstream* p_serial_port)
+
+/**
+ * @brief      Make a radio driver and the task which services the radio.
+ * @details    The radio isn't set up until initialize() is called.
+ * @param      p_serial_port  A serial port for debugging messages
+ * @param      p_spi          The SPI driver through which the radio is reached;
+ *                            if it's NULL, an interrupt driven SPI engine is made
+ * @param      priority       The priority of the service task
+ */
+nrf24_driver::nrf24_driver (emstream* p_serial_port, spi_driver* p_spi,
+                            unsigned portBASE_TYPE priority)
 {
     p_serial = p_serial_port;
 
-    // Create SPI driver
-    local_spi_driver = new spi_driver(p_serial);
-    local_spi_driver -> initializeMaster();
-    // Make CE and IRQ outputs
-    //DDRD |= ((1 << PD0) | (1 << PD1));
+    if (p_spi == NULL)
+    {
+        // Create an SPI engine, with CSN on PB0 as its default chip select
+        p_spi = new spi_engine(p_serial, &PORTB, PB0);
+    }
+    local_spi_driver = p_spi;
 
-    // Enable Pull up Resisitor
-    //PORTD |= ((1 << PD0) | (1 << PD1));
+    irq_signal = xSemaphoreCreateBinary ();
+    spi_mutex = xSemaphoreCreateMutex ();
+    ready = false;
 
-}
+    p_rx_queue = new TaskQueue<nrf24_frame> (NRF24_QUEUE_SIZE, "NRF_RX", p_serial);
+    p_tx_queue = new TaskQueue<nrf24_frame> (NRF24_QUEUE_SIZE, "NRF_TX", p_serial);
 
+    // Two byte CRC; all three interrupts are left unmasked
+    config_base = (1 << EN_CRC) | (1 << CRCO);
+    transmitting = false;
+    tx_in_fifo = 0;
 
-uint8_t nrf24_driver::readRegister(uint8_t target)
-{
-    // Drop CSN to low
-    PORTB &= ~(1 << PB0);
-    // set the nRF to reading mode "target" is read back
-    local_spi_driver -> masterTransmit(R_REGISTER + target);
-    //*p_serial << PMS("Reading Reg: ") << target << endl;
-    target = local_spi_driver -> masterTransmit(NOP);
-    // Set CSN back HIGH
-    PORTB |= (1 << PB0);
-    //*p_serial << PMS("DATA in SPDR: ") << SPDR << endl;
-    return target;
+    rx_count = 0;
+    tx_count = 0;
+    retransmits = 0;
+    tx_lost = 0;
+    rx_dropped = 0;
 
+    p_nrf24 = this;
 
+    xTaskCreate (service_task, "NRF24", NRF24_STACK_SIZE, this, priority, NULL);
 }
 
-uint8_t* nrf24_driver::writeRegister(uint8_t ReadWrite, uint8_t target, uint8_t* payload, uint8_t payload_size)
+
+/**
+ * @brief      Write one byte to a register in the radio.
+ * @param      reg    The register address
+ * @param      value  The byte to write
+ */
+void nrf24_driver::write_reg (uint8_t reg, uint8_t value)
 {
+    command (W_REGISTER | (reg & REGISTER_MASK), &value, NULL, 1);
+}
 
 
-    if (ReadWrite == W)
+/**
+ * @brief      Read one byte from a register in the radio.
+ * @param      reg    The register address
+ * @return     The contents of the register
+ */
+uint8_t nrf24_driver::read_reg (uint8_t reg)
+{
+    uint8_t value;
+    command (R_REGISTER | (reg & REGISTER_MASK), NULL, &value, 1);
+    return value;
+}
+
+
+/**
+ * @brief      Set the radio's CE pin, which turns its transmitter or receiver on.
+ * @param      high  True to turn the radio on, false to put it in standby
+ */
+void nrf24_driver::set_ce (bool high)
+{
+    if (high)
     {
-        target = W_REGISTER + target;
+        PORTD |= (1 << PD1);
     }
+    else
+    {
+        PORTD &= ~(1 << PD1);
+    }
+}
 
-    static uint8_t ret[32];
 
-    // Drop CSN to low
-    PORTB &= ~(1 << PB0);
-    // set the NRF24 to read or write
-    local_spi_driver -> masterTransmit(target);
+uint8_t nrf24_driver::readRegister(uint8_t target)
+{
+    xSemaphoreTake (spi_mutex, portMAX_DELAY);
+    target = read_reg (target);
+    xSemaphoreGive (spi_mutex);
 
-    uint8_t count;
-    for (count = 0; count < payload_size; count++)
-    {
-        if (ReadWrite == R && target != W_TX_PAYLOAD)
-        {
-            // Send dummies to read data
-            ret[count] = local_spi_driver -> masterTransmit(NOP);
-            //*p_serial << "Getting Data || " << count << " || " << ret[count]<< endl;
+    return target;
+}
 
-        }
-        else
-        {
-            // send bytes one at a time
-            local_spi_driver -> masterTransmit(payload[count]);
-        }
+uint8_t* nrf24_driver::writeRegister(uint8_t ReadWrite, uint8_t target, uint8_t* payload, uint8_t payload_size)
+{
+    static uint8_t ret[32];
+
+    // The service task uses the radio too, so keep it out during the transaction
+    xSemaphoreTake (spi_mutex, portMAX_DELAY);
+    if (ReadWrite == W)
+    {
+        command (W_REGISTER + target, payload, NULL, payload_size);
+    }
+    else if (target != W_TX_PAYLOAD)
+    {
+        // Send dummies to read data
+        command (target, NULL, ret, payload_size);
+    }
+    else
+    {
+        command (target, payload, NULL, payload_size);
     }
-    // Set CSN back HIGH
-    PORTB |= (1 << PB0);
+    xSemaphoreGive (spi_mutex);
 
     return ret;
-
-
 }
 
 
+/**
+ * @brief      Set up the radio and start listening.
+ * @details    Auto-ack and dynamic payloads are turned on for pipes 0 and 1, and
+ *             the IRQ line is connected to INT0 (PD0) as a low level interrupt.
+ *             A level interrupt is used because the line stays low as long as any
+ *             flag is set; an edge could be missed if a new flag were set while
+ *             the ISR was clearing the old ones.
+ */
 void nrf24_driver::initialize(void)
 {
     //Array of ints to send
-    uint8_t val[32];
+    uint8_t val[5];
+
+    // Keep INT0 off and the radio in standby while it's set up
+    xSemaphoreTake (spi_mutex, portMAX_DELAY);
+    EIMSK &= ~(1 << INT0);
+    DDRD |= (1 << PD1);
+    set_ce (false);
 
     //Enable auto ack, only works if TRANS has identical RF_ADDRESS on it's channel ex: RX_ADDR_P0 = TX_ADDR
-    val[0] = 0x3F; // set a value
-    writeRegister(W, EN_AA, val, 1);
+    write_reg (EN_AA, 0x3F);
 
     //Choose # of enabled data pipes (1-5)
-    val[0] = 0x03;
-    writeRegister(W, EN_RXADDR, val, 1);
+    write_reg (EN_RXADDR, (1 << ERX_P1) | (1 << ERX_P0));
+
+    //RF_ADDRESS width setup, 5 bytes
+    write_reg (SETUP_AW, 0x03);
+
+    write_reg (RF_CH, NRF24_CHANNEL);
+
+    //RF_SETUP: 1 Mbps, full power
+    write_reg (RF_SETUP, 0x07);
+
+    //RX RF_ADDRESS SETUP set reciever address; pipe 0 must match TX_ADDR for the
+    //acknowledgements to be received while transmitting
+    val[0] = val[1] = val[2] = val[3] = val[4] = 0xF0;
+    command (W_REGISTER | RX_ADDR_P0, val, NULL, 5);
+    command (W_REGISTER | TX_ADDR, val, NULL, 5);
+
+    //RETRIES: wait 750 us between tries, up to 15 retries
+    write_reg (SETUP_RETR, 0x2F);
+
+    // Dynamic payload lengths; an nRF24L01 without the plus needs ACTIVATE first
+    val[0] = 0x73;
+    command (ACTIVATE, val, NULL, 1);
+    write_reg (FEATURE, (1 << EN_DPL));
+    write_reg (DYNPD, 0x3F);
+
+    // Start with empty FIFOs and no flags set
+    command (FLUSH_TX);
+    command (FLUSH_RX);
+    write_reg (STATUS, IRQ_FLAGS);
+
+    // Power up, then wait for the oscillator to start
+    write_reg (CONFIG, config_base | (1 << PWR_UP) | (1 << PRIM_RX));
+    _delay_ms (2);
+
+    // IRQ line as an input with pullup on INT0, low level triggered
+    DDRD &= ~(1 << PD0);
+    PORTD |= (1 << PD0);
+    EICRA &= ~((1 << ISC01) | (1 << ISC00));
+
+    transmitting = false;
+    tx_in_fifo = 0;
+    enter_rx ();
+    ready = true;
+    EIMSK |= (1 << INT0);
+    xSemaphoreGive (spi_mutex);
+}
 
-    //RF_ADDRESS width setup (how many bytes is receiver address)
-    val[0] = 0x03;
-    writeRegister(W, SETUP_AW, val, 1);
 
-    //RF_CHANNEL 0x01 = 2401 GHZ steps of 1 GHZ (I NEED 118 or 0x76)
-    val[0] = 0x76;
-    writeRegister(W, RF_CH, val, 1);
+/**
+ * @brief      Make the radio a primary receiver and start listening.
+ */
+void nrf24_driver::enter_rx (void)
+{
+    set_ce (false);
+    write_reg (CONFIG, config_base | (1 << PWR_UP) | (1 << PRIM_RX));
+    transmitting = false;
+    set_ce (true);
+}
 
-    //RF_SETUP
-    val[0] = 0x07;
-    writeRegister(W, RF_SETUP, val, 1);
 
+/**
+ * @brief      Move frames from the transmit queue into the radio's FIFO.
+ * @details    If the radio is listening, it's made a transmitter first.
+ */
+void nrf24_driver::load_tx_fifo (void)
+{
+    nrf24_frame frame;
+
+    while (tx_in_fifo < NRF24_TX_FIFO_DEPTH
+           && xQueueReceive (p_tx_queue -> get_handle (), &frame, 0) == pdTRUE)
+    {
+        if (!transmitting)
+        {
+            set_ce (false);
+            write_reg (CONFIG, config_base | (1 << PWR_UP));
+            transmitting = true;
+        }
+        command (W_TX_PAYLOAD, frame.data, NULL, frame.length);
+        tx_in_fifo++;
+    }
 
-    //RX RF_ADDRESS SETUP set reciever address
-    val[0] = 0xF0;
-    val[1] = 0xF0;
-    val[2] = 0xF0;
-    val[3] = 0xF0;
-    val[4] = 0xF0;
+    // In transmit mode, CE high sends whatever is in the FIFO
+    if (transmitting)
+    {
+        set_ce (true);
+    }
+}
 
-    writeRegister(W, RX_ADDR_P0, val, 5);
 
-    // TX RF_ADDRESS
-    val[0] = 0xF0;
-    val[1] = 0xF0;
-    val[2] = 0xF0;
-    val[3] = 0xF0;
-    val[4] = 0xF0;
+/**
+ * @brief      Move frames from the radio's receive FIFO into the receive queue.
+ * @details    The pipe number in the STATUS byte which comes back with the
+ *             R_RX_PL_WID command is 7 when the FIFO is empty, so one transaction
+ *             both checks for a frame and gets its length. A length over 32 means
+ *             a corrupt frame, and the datasheet says to flush the FIFO then.
+ */
+void nrf24_driver::read_rx_fifo (void)
+{
+    for (;;)
+    {
+        nrf24_frame frame;
+        uint8_t status = command (R_RX_PL_WID, NULL, &frame.length, 1);
 
-    writeRegister(W, TX_ADDR, val, 5);
+        frame.pipe = (status >> RX_P_NO) & 0x07;
+        if (frame.pipe == 0x07)
+        {
+            break;
+        }
+        if (frame.length > NRF24_PAYLOAD_MAX)
+        {
+            command (FLUSH_RX);
+            rx_dropped++;
+            break;
+        }
 
-    // SET PAYLOAD WIDTH SIZE
-    val[0] = 0x04;
-    writeRegister(W, RX_PW_P0, val, 1);
+        command (R_RX_PAYLOAD, NULL, frame.data, frame.length);
+        if (xQueueSendToBack (p_rx_queue -> get_handle (), &frame, 0) == pdTRUE)
+        {
+            rx_count++;
+        }
+        else
+        {
+            rx_dropped++;
+        }
+    }
+}
 
-    //RETRIES
-    val[0] = 0x2F;
-    writeRegister(W, SETUP_RETR, val, 1);
 
-    // CONFIGGGGG
-    // [0b0001 1110] (0 --> 0) TRANS, (0 --> 1) REC
-    val[0] = 0x7f;
-    writeRegister(W, CONFIG, val, 1);
+/**
+ * @brief      Handle the radio's flags until none are left.
+ * @details    Each pass clears the flags first, so that any event which happens
+ *             meanwhile sets its flag again and is found by the next pass. Then
+ *             the receive FIFO is emptied, and for a sent or failed frame, the
+ *             number of retransmissions is read and the transmit FIFO refilled.
+ *             Last, any frames which send() has queued are loaded.
+ *
+ *             One TX_DS flag is normally one frame, as a frame with its ack takes
+ *             hundreds of microseconds; if the FIFO is found empty, though, all the
+ *             frames which were in it must have gone. When a frame isn't acked
+ *             after all its retries, the radio stops with it at the head of the
+ *             FIFO; the FIFO is flushed and the frames in it counted as lost, since
+ *             for joystick control the frames behind them are newer anyway.
+ *
+ *             The radio starts its ARC_CNT retransmission count over for each frame,
+ *             so when one pass finds several frames sent, only the last one's
+ *             retransmissions can be read and the others' are missed. The count of
+ *             retransmissions is therefore a lower bound, exact only while frames
+ *             are sent one at a time.
+ */
+void nrf24_driver::service (void)
+{
+    uint8_t flags;
 
+    while ((flags = command (NOP) & IRQ_FLAGS) != 0)
+    {
+        write_reg (STATUS, flags);
 
+        if (flags & (1 << RX_DR))
+        {
+            read_rx_fifo ();
+        }
 
+        if (flags & ((1 << TX_DS) | (1 << MAX_RT)))
+        {
+            // ARC_CNT only holds the count for the latest frame; see above
+            retransmits += read_reg (OBSERVE_TX) & 0x0F;
+
+            if (flags & (1 << MAX_RT))
+            {
+                command (FLUSH_TX);
+                tx_lost += tx_in_fifo;
+                tx_in_fifo = 0;
+            }
+            else if (read_reg (FIFO_STATUS) & (1 << TX_EMPTY))
+            {
+                tx_count += tx_in_fifo;
+                tx_in_fifo = 0;
+            }
+            else if (tx_in_fifo > 0)
+            {
+                tx_count++;
+                tx_in_fifo--;
+            }
+
+            load_tx_fifo ();
+            if (tx_in_fifo == 0)
+            {
+                enter_rx ();
+            }
+        }
+    }
 
+    load_tx_fifo ();
 }
-void nrf24_driver::recPayload(uint8_t size, uint8_t * container)
+
+
+/**
+ * @brief      The service task, which runs each time the radio needs attention.
+ * @details    INT0 stays masked from the interrupt until the radio's flags have
+ *             all been handled, since the IRQ line stays low until then.
+ * @param      p_driver  A pointer to the radio driver
+ */
+void nrf24_driver::service_task (void* p_driver)
 {
-    uint8_t count;
-    // Drop CSN to low
-    PORTB &= ~(1 << PB0);
-    // request the payload
-    *p_serial << "PUT INTO RX" << hex << local_spi_driver -> masterTransmit(R_RX_PAYLOAD) << endl;
-    //get payload
-    for (count = 0; count < size; count++)
-    {
+    nrf24_driver* p_this = (nrf24_driver*)p_driver;
 
-        //container[count] = local_spi_driver -> masterTransmit(NOP);
-        //*p_serial << hex << container[count] << endl;
-        
-        
-        container[count] = local_spi_driver -> masterTransmit(NOP);
-        *p_serial << count << " || " <<container[count]<< endl;
-        //*p_serial << "FIFO: " << readRegister(FIFO_STATUS) << endl;
+    for (;;)
+    {
+        xSemaphoreTake (p_this -> irq_signal, portMAX_DELAY);
 
+        xSemaphoreTake (p_this -> spi_mutex, portMAX_DELAY);
+        if (p_this -> ready)
+        {
+            p_this -> service ();
 
+            portENTER_CRITICAL ();
+            EIMSK |= (1 << INT0);
+            portEXIT_CRITICAL ();
+        }
+        xSemaphoreGive (p_this -> spi_mutex);
     }
-    // Set CSN back HIGH
-    PORTB |= (1 << PB0);
-
-    //reset();
-    //*p_serial << PMS("DATA in SPDR: ") << SPDR << endl;
 }
-void nrf24_driver::reset(void)
+
+
+/**
+ * @brief      Wake the service task when the radio's IRQ line is low.
+ * @details    INT0 is a level interrupt, so it's masked until the service task
+ *             has cleared the radio's flags and the line has gone high again.
+ */
+void nrf24_driver::isr (void)
 {
-    //Clear the CSN to LOW
-    PORTB &= ~(1 << PB0);
-    local_spi_driver -> masterTransmit(W_REGISTER + STATUS);
-    // reset IRQ
-    local_spi_driver -> masterTransmit(0x0E);
-    // Set CSN back to HIGH
-    PORTB |= (1 << PB0);
+    signed portBASE_TYPE task_awakened = pdFALSE;
+
+    EIMSK &= ~(1 << INT0);
+
+    // The service task has the highest priority, so it's switched to before the
+    // ISR returns, as FreeRTOS's own AVR serial port demonstration does
+    xSemaphoreGiveFromISR (irq_signal, &task_awakened);
+    if (task_awakened != pdFALSE)
+    {
+        portYIELD ();
+    }
 }
 
 
-void nrf24_driver::printNRF(emstream* p_ser_port, nrf24_driver* p_nrf24)
+/**
+ * @brief      Queue a frame to be sent.
+ * @details    The service task is woken to load the frame if there's room in the
+ *             radio's FIFO; if not, it loads the frame when a sent one makes room.
+ * @param      p_data  The bytes to send
+ * @param      length  How many bytes to send, 1 to 32
+ * @param      wait    RTOS ticks to wait if the transmit queue is full
+ * @return     True if the frame was queued, false if it wasn't
+ */
+bool nrf24_driver::send (const uint8_t* p_data, uint8_t length, TickType_t wait)
 {
-    uint8_t *data;
-    data[0] = 0;
+    if (length == 0 || length > NRF24_PAYLOAD_MAX)
+    {
+        return false;
+    }
+
+    nrf24_frame frame;
+    frame.pipe = 0;
+    frame.length = length;
+    for (uint8_t index = 0; index < length; index++)
+    {
+        frame.data[index] = p_data[index];
+    }
+    if (xQueueSendToBack (p_tx_queue -> get_handle (), &frame, wait) != pdTRUE)
+    {
+        return false;
+    }
+
+    xSemaphoreGive (irq_signal);
 
-    data = p_nrf24 -> writeRegister(R, STATUS, data, 1);
-    *p_ser_port << "STATUS\t\t: " << hex << data[0] << endl;
+    return true;
+}
+
+
+/**
+ * @brief      Get a frame which the radio has received.
+ * @param      frame  A frame into which the received one is copied
+ * @param      wait   RTOS ticks to wait for a frame; the default is forever
+ * @return     True if a frame was received, false if none came in time
+ */
+bool nrf24_driver::receive (nrf24_frame& frame, TickType_t wait)
+{
+    return (xQueueReceive (p_rx_queue -> get_handle (), &frame, wait) == pdTRUE);
+}
 
-    data = p_nrf24 -> writeRegister(R, CONFIG, data, 1);
-    *p_ser_port << "CONFIG\t\t: " << hex << data[0] << endl;
 
-    data = p_nrf24 -> writeRegister(R, EN_AA, data, 1);
-    *p_ser_port << "EN_AA\t\t: " << hex << data[0] << endl;
+/// @brief Get the number of frames received and queued.
+uint32_t nrf24_driver::get_rx_count (void)
+{
+    portENTER_CRITICAL ();
+    uint32_t count = rx_count;
+    portEXIT_CRITICAL ();
+    return count;
+}
 
-    data = p_nrf24 -> writeRegister(R, EN_RXADDR, data, 1);
-    *p_ser_port << "EN_RXADDR\t: " << hex << data[0] << endl;
+/// @brief Get the number of frames sent and acknowledged.
+uint32_t nrf24_driver::get_tx_count (void)
+{
+    portENTER_CRITICAL ();
+    uint32_t count = tx_count;
+    portEXIT_CRITICAL ();
+    return count;
+}
 
-    data = p_nrf24 -> writeRegister(R, SETUP_AW, data, 1);
-    *p_ser_port << "SETUP_AW\t: " << hex << data[0] << endl;
+/// @brief Get at least the number of automatic retransmissions the radio has made;
+///        see service() for why some may be missed.
+uint32_t nrf24_driver::get_retransmits (void)
+{
+    portENTER_CRITICAL ();
+    uint32_t count = retransmits;
+    portEXIT_CRITICAL ();
+    return count;
+}
 
-    data = p_nrf24 -> writeRegister(R, SETUP_RETR, data, 1);
-    *p_ser_port << "SETUP_RETR\t: " << hex << data[0] << endl;
+/// @brief Get the number of frames which were never acknowledged.
+uint16_t nrf24_driver::get_tx_lost (void)
+{
+    portENTER_CRITICAL ();
+    uint16_t count = tx_lost;
+    portEXIT_CRITICAL ();
+    return count;
+}
 
-    data = p_nrf24 -> writeRegister(R, RF_CH, data, 1);
-    *p_ser_port << "RF_CH\t\t: " << hex << data[0] << endl;
+/// @brief Get the number of received frames dropped because the queue was full.
+uint16_t nrf24_driver::get_rx_dropped (void)
+{
+    portENTER_CRITICAL ();
+    uint16_t count = rx_dropped;
+    portEXIT_CRITICAL ();
+    return count;
+}
 
-    data = p_nrf24 -> writeRegister(R, RF_SETUP, data, 1);
-    *p_ser_port << "RF_SETUP\t: " << hex << data[0] << endl;
 
-    data = p_nrf24 -> writeRegister(R, CD, data, 1);
-    *p_ser_port << "POWER_RECEIVED\t: " << hex << data[0] << endl;
+void nrf24_driver::printNRF(emstream* p_ser_port, nrf24_driver* p_nrf24)
+{
+    uint8_t *data;
 
-    data = p_nrf24 -> writeRegister(R, RX_ADDR_P0, data, 5);
+    *p_ser_port << "STATUS\t\t: " << hex << p_nrf24 -> readRegister(STATUS) << endl;
+    *p_ser_port << "CONFIG\t\t: " << hex << p_nrf24 -> readRegister(CONFIG) << endl;
+    *p_ser_port << "EN_AA\t\t: " << hex << p_nrf24 -> readRegister(EN_AA) << endl;
+    *p_ser_port << "EN_RXADDR\t: " << hex << p_nrf24 -> readRegister(EN_RXADDR) << endl;
+    *p_ser_port << "SETUP_AW\t: " << hex << p_nrf24 -> readRegister(SETUP_AW) << endl;
+    *p_ser_port << "SETUP_RETR\t: " << hex << p_nrf24 -> readRegister(SETUP_RETR) << endl;
+    *p_ser_port << "RF_CH\t\t: " << hex << p_nrf24 -> readRegister(RF_CH) << endl;
+    *p_ser_port << "RF_SETUP\t: " << hex << p_nrf24 -> readRegister(RF_SETUP) << endl;
+    *p_ser_port << "POWER_RECEIVED\t: " << hex << p_nrf24 -> readRegister(CD) << endl;
+
+    data = p_nrf24 -> writeRegister(R, RX_ADDR_P0, NULL, 5);
     *p_ser_port << "RX_ADDR_P0\t: " << hex << data[0] << " " << data[1] << " " << data[2] << " " << data[3] << " " << data[4] << " " << endl;
 
-    data = p_nrf24 -> writeRegister(R, RX_ADDR_P1, data, 5);
+    data = p_nrf24 -> writeRegister(R, RX_ADDR_P1, NULL, 5);
     *p_ser_port << "RX_ADDR_P1\t: " << hex << data[0] << " " << data[1] << " " << data[2] << " " << data[3] << " " << data[4] << " " << endl;
 
-    data = p_nrf24 -> writeRegister(R, TX_ADDR, data, 5);
+    data = p_nrf24 -> writeRegister(R, TX_ADDR, NULL, 5);
     *p_ser_port << "TX_ADDR\t\t: " << hex << data[0] << " " << data[1] << " " << data[2] << " " << data[3] << " " << data[4] << " " << endl;
 
-    data = p_nrf24 -> writeRegister(R, RX_PW_P0, data, 6);
-    *p_ser_port << "RX_PW_P0-6\t: " << hex << data[0] << " " << data[1] << " " << data[2] << " " << data[3] << " " << data[4] << " " << endl;
+    *p_ser_port << "DYNPD\t\t: " << hex << p_nrf24 -> readRegister(DYNPD) << endl;
+    *p_ser_port << "FEATURE\t\t: " << hex << p_nrf24 -> readRegister(FEATURE) << endl;
+    *p_ser_port << "FIFO_STATUS\t: " << hex << p_nrf24 -> readRegister(FIFO_STATUS) << endl;
+}
+
 
-    // data = p_nrf24 -> writeRegister(R, RX_PW_P1, data, 5);
-    // *p_ser_port << "RX_PW_P1\t: " << hex << data[0] << " " << data[1] << " " << data[2] << " " << data[3] << " " << data[4] << " " << endl;
+/**
+ * @brief      Print the frame, retransmit and loss counts on one line.
+ * @param      p_ser_dev  The serial device on which to print
+ */
+void nrf24_driver::print_status (emstream* p_ser_dev)
+{
+    *p_ser_dev << dec << PMS ("nRF24 rx ") << get_rx_count ()
+               << PMS (" (dropped ") << get_rx_dropped ()
+               << PMS ("), tx ") << get_tx_count ()
+               << PMS (" (lost ") << get_tx_lost ()
+               << PMS ("), retransmits ") << get_retransmits () << endl;
+}
 
-    data = p_nrf24 -> writeRegister(R, FIFO_STATUS, data, 5);
-    *p_ser_port << "FIFO_STATUS\t: " << hex << data[0] << endl;
+
+/**
+ * @brief      The INT0 interrupt, which runs when the radio's IRQ line is low.
+ */
+ISR (INT0_vect)
+{
+    if (p_nrf24 != NULL)
+    {
+        p_nrf24 -> isr ();
+    }
 }
 
+
 emstream& operator << (emstream& serpt, nrf24_driver& nrfdrv)
 {
     // Prints info to the serial port
-    serpt << PMS ("SPI CONTROL");
+    nrfdrv.print_status (&serpt);
     return (serpt);
 }
-
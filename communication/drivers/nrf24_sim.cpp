@@ -0,0 +1,335 @@
+//*************************************************************************************
+/** @file nrf24_sim.cpp
+ *    This file contains a simulated nRF24L01+ radio, used in place of the SPI port
+ *    and the real radio when the program is run on a PC. Nothing in this file is
+ *    compiled unless @c POSIX_HOST is defined.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#ifdef POSIX_HOST
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "nrf24_sim.h"
+#include "nRF24L01.h"
+
+/// The flags in the STATUS register which pull the IRQ line low
+#define IRQ_FLAGS ((1 << RX_DR) | (1 << TX_DS) | (1 << MAX_RT))
+
+// The INT0 interrupt service routine, which is in nrf24_driver.cpp
+extern "C" void INT0_vect (void);
+
+
+/**
+ * @brief      Make a simulated radio with its registers at their power-on values.
+ * @param      p_serial_port  A serial port for debugging messages
+ */
+nrf24_sim::nrf24_sim (emstream* p_serial_port)
+    : spi_driver (p_serial_port)
+{
+    for (uint8_t reg = 0; reg < 0x20; reg++)
+    {
+        regs[reg] = 0;
+    }
+    regs[CONFIG] = 0x08;
+    regs[EN_AA] = 0x3F;
+    regs[EN_RXADDR] = 0x03;
+    regs[SETUP_AW] = 0x03;
+    regs[SETUP_RETR] = 0x03;
+    regs[RF_CH] = 0x02;
+    regs[RF_SETUP] = 0x0F;
+
+    for (uint8_t index = 0; index < 5; index++)
+    {
+        addresses[0][index] = 0xE7;
+        addresses[1][index] = 0xC2;
+        addresses[2][index] = 0xE7;
+    }
+
+    rx_fill = 0;
+    tx_fill = 0;
+    acks_to_drop = 0;
+    air_sent = 0;
+    last_sent.pipe = 0;
+    last_sent.length = 0;
+}
+
+
+/**
+ * @brief      Find the value of the STATUS register.
+ * @details    The flags are kept in @c regs; the pipe number of the frame at the
+ *             head of the receive FIFO, or 7 if it's empty, and the TX_FULL bit
+ *             are found from the FIFOs.
+ * @return     The STATUS register
+ */
+uint8_t nrf24_sim::status (void)
+{
+    uint8_t pipe = rx_fill ? rx_fifo[0].pipe : 0x07;
+
+    return ((regs[STATUS] & IRQ_FLAGS) | (pipe << RX_P_NO)
+            | (tx_fill >= NRF24_TX_FIFO_DEPTH ? (1 << TX_FULL) : 0));
+}
+
+
+/**
+ * @brief      Find the five-byte address which a register holds.
+ * @param      reg  The register address
+ * @return     A pointer to the address bytes, or NULL for a one-byte register
+ */
+uint8_t* nrf24_sim::address_of (uint8_t reg)
+{
+    switch (reg)
+    {
+        case (RX_ADDR_P0):
+            return (addresses[0]);
+        case (RX_ADDR_P1):
+            return (addresses[1]);
+        case (TX_ADDR):
+            return (addresses[2]);
+        default:
+            return (NULL);
+    }
+}
+
+
+/**
+ * @brief      Run the INT0 interrupt if the simulated IRQ line is low.
+ * @details    The CONFIG register can mask each flag from the IRQ line. If this is
+ *             called from within the interrupt, the interrupt is run again after
+ *             it returns, just as a low level interrupt on the AVR would be.
+ */
+void nrf24_sim::update_irq (void)
+{
+    uint8_t unmasked = regs[STATUS] & IRQ_FLAGS & ~regs[CONFIG];
+
+    if (unmasked && (EIMSK & (1 << INT0)))
+    {
+        vPortHostInterrupt (INT0_vect);
+    }
+}
+
+
+/**
+ * @brief      Answer a command as the radio would.
+ * @details    The STATUS register is returned as it was when the command began,
+ *             as the radio clocks it out during the command byte.
+ * @param      command  The command byte
+ * @param      p_out    Bytes sent after the command, or NULL for 0xFF bytes
+ * @param      p_in     Space for the bytes the radio sends back, or NULL
+ * @param      count    The number of bytes after the command
+ * @return     The STATUS register
+ */
+uint8_t nrf24_sim::transaction (uint8_t command, const uint8_t* p_out,
+                                uint8_t* p_in, uint8_t count)
+{
+    uint8_t old_status = status ();
+    uint8_t reply[NRF24_PAYLOAD_MAX];
+    uint8_t reg = command & REGISTER_MASK;
+
+    if (count > NRF24_PAYLOAD_MAX)
+    {
+        count = NRF24_PAYLOAD_MAX;
+    }
+    for (uint8_t index = 0; index < count; index++)
+    {
+        reply[index] = 0;
+    }
+
+    if (command < W_REGISTER)
+    {
+        uint8_t* p_address = address_of (reg);
+        for (uint8_t index = 0; index < count; index++)
+        {
+            if (p_address)
+            {
+                reply[index] = p_address[index % 5];
+            }
+            else if (reg == STATUS)
+            {
+                reply[index] = old_status;
+            }
+            else if (reg == FIFO_STATUS)
+            {
+                reply[index] = (rx_fill == 0 ? (1 << RX_EMPTY) : 0)
+                    | (rx_fill >= 3 ? (1 << RX_FULL) : 0)
+                    | (tx_fill == 0 ? (1 << TX_EMPTY) : 0)
+                    | (tx_fill >= NRF24_TX_FIFO_DEPTH ? (1 << FIFO_FULL) : 0);
+            }
+            else
+            {
+                reply[index] = regs[reg];
+            }
+        }
+    }
+    else if (command < (W_REGISTER << 1) && p_out && count)
+    {
+        uint8_t* p_address = address_of (reg);
+        if (p_address)
+        {
+            for (uint8_t index = 0; index < count && index < 5; index++)
+            {
+                p_address[index] = p_out[index];
+            }
+        }
+        else if (reg == STATUS)
+        {
+            // Writing a one to a flag clears it
+            regs[STATUS] &= ~(p_out[0] & IRQ_FLAGS);
+        }
+        else if (reg != FIFO_STATUS && reg != OBSERVE_TX)
+        {
+            regs[reg] = p_out[0];
+        }
+    }
+    else if (command == R_RX_PL_WID && count)
+    {
+        reply[0] = rx_fill ? rx_fifo[0].length : 0;
+    }
+    else if (command == R_RX_PAYLOAD && rx_fill)
+    {
+        for (uint8_t index = 0; index < count; index++)
+        {
+            reply[index] = rx_fifo[0].data[index];
+        }
+        for (uint8_t index = 1; index < rx_fill; index++)
+        {
+            rx_fifo[index - 1] = rx_fifo[index];
+        }
+        rx_fill--;
+    }
+    else if ((command == W_TX_PAYLOAD || command == W_TX_PAYLOAD_NOACK)
+             && tx_fill < NRF24_TX_FIFO_DEPTH && p_out)
+    {
+        tx_fifo[tx_fill].pipe = 0;
+        tx_fifo[tx_fill].length = count;
+        for (uint8_t index = 0; index < count; index++)
+        {
+            tx_fifo[tx_fill].data[index] = p_out[index];
+        }
+        tx_fill++;
+    }
+    else if (command == FLUSH_TX)
+    {
+        tx_fill = 0;
+    }
+    else if (command == FLUSH_RX)
+    {
+        rx_fill = 0;
+    }
+
+    if (p_in)
+    {
+        for (uint8_t index = 0; index < count; index++)
+        {
+            p_in[index] = reply[index];
+        }
+    }
+
+    update_irq ();
+    return (old_status);
+}
+
+
+/**
+ * @brief      Let the radio send the frame at the head of its transmit FIFO.
+ * @details    Nothing is sent unless the radio is powered up as a transmitter with
+ *             CE high and the MAX_RT flag clear. Dropped acknowledgements are
+ *             counted off one per try; if all the tries allowed by SETUP_RETR go
+ *             unacknowledged, MAX_RT is set and the frame stays in the FIFO, as on
+ *             the real radio. OBSERVE_TX counts the retries and lost frames.
+ */
+void nrf24_sim::step (void)
+{
+    bool ce_high = (PORTD & (1 << PD1)) != 0;
+    bool ptx = (regs[CONFIG] & ((1 << PWR_UP) | (1 << PRIM_RX))) == (1 << PWR_UP);
+
+    if (!ce_high || !ptx || tx_fill == 0 || (regs[STATUS] & (1 << MAX_RT)))
+    {
+        return;
+    }
+
+    uint8_t retries = regs[SETUP_RETR] & 0x0F;
+    uint8_t lost = regs[OBSERVE_TX] >> PLOS_CNT;
+
+    if (acks_to_drop > retries)
+    {
+        acks_to_drop -= retries + 1;
+        if (lost < 0x0F)
+        {
+            lost++;
+        }
+        regs[OBSERVE_TX] = (lost << PLOS_CNT) | retries;
+        regs[STATUS] |= (1 << MAX_RT);
+    }
+    else
+    {
+        regs[OBSERVE_TX] = (lost << PLOS_CNT) | (uint8_t)acks_to_drop;
+        acks_to_drop = 0;
+
+        last_sent = tx_fifo[0];
+        for (uint8_t index = 1; index < tx_fill; index++)
+        {
+            tx_fifo[index - 1] = tx_fifo[index];
+        }
+        tx_fill--;
+        air_sent++;
+        regs[STATUS] |= (1 << TX_DS);
+    }
+
+    update_irq ();
+}
+
+
+/**
+ * @brief      Have the radio receive a frame from another radio.
+ * @details    The frame is received only if the radio is powered up as a receiver
+ *             with CE high, the pipe is enabled, and there's room in the FIFO;
+ *             otherwise the other radio gets no acknowledgement.
+ * @param      pipe    The data pipe on which the frame arrives, 0 to 5
+ * @param      p_data  The payload
+ * @param      length  The number of bytes in the payload, 1 to 32
+ * @return     True if the frame was received and acknowledged
+ */
+bool nrf24_sim::air_receive (uint8_t pipe, const uint8_t* p_data, uint8_t length)
+{
+    bool ce_high = (PORTD & (1 << PD1)) != 0;
+    uint8_t prx = (1 << PWR_UP) | (1 << PRIM_RX);
+
+    if (!ce_high || (regs[CONFIG] & prx) != prx || pipe > 5
+        || !(regs[EN_RXADDR] & (1 << pipe)) || rx_fill >= 3
+        || length == 0 || length > NRF24_PAYLOAD_MAX)
+    {
+        return (false);
+    }
+
+    rx_fifo[rx_fill].pipe = pipe;
+    rx_fifo[rx_fill].length = length;
+    for (uint8_t index = 0; index < length; index++)
+    {
+        rx_fifo[rx_fill].data[index] = p_data[index];
+    }
+    rx_fill++;
+    regs[STATUS] |= (1 << RX_DR);
+
+    update_irq ();
+    return (true);
+}
+
+#endif // POSIX_HOST
@@ -1,103 +1,141 @@
-//Eddie Ruano
-
-//*************************************************************************************
-/** @file adc.cpp
- *    This file contains a very simple A/D converter driver. This driver should be
- *
- *  Revisions:
- *    @li 01-15-2008 JRR Original (somewhat useful) file
- *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
- *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
- *
- *  License:
- *    This file is copyright 2015 by JR Ridgely and released under the Lesser GNU
- *    Public License, version 2. It intended for educational use only, but its use
- *    is not limited thereto. */
-/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
- *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
- *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
- *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
- *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
- *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
- *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
- *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
- *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
-//*************************************************************************************
-
-#include <stdlib.h>                         // Include standard library header files
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include "rs232int.h"                       // Include header for serial port class
-#include "spi_driver.h"
-
-
-spi_driver::spi_driver (emstream* p_serial_port)
-{
-    p_serial = p_serial_port;
-    
-    DBG (p_serial, "SPI Driver Engaged " << endl);
-}
-
-void spi_driver::initializeMaster(void)
-{
-    // Activate SPI in Power Reduction
-    PRR0 &= ~(1 << PRSPI);
-
-    // Set SCK and MOSI and CSN as outputs
-    DDRB |= ((1 << PB1) | (1 << PB2) | (1 << PB0));
-
-    //Set CE as outport
-    DDRB |= (1 << PD1);
-
-    // Set CSN as HIGH and CE as LOW
-    PORTB |= (1 << PB0);
-    PORTD &= ~(1 << PD1);
-
-    
-
-    // Enable SPI, set as Master, and Prescaler to 16
-    SPCR |= ((1 << SPE) | (1 << MSTR) | (1 << SPR0));
-}
-
-char spi_driver::masterTransmit(unsigned char data)
-{
-    // Place Data in Data in/out register
-    SPDR = data;
-    while(!(SPSR & (1 << SPIF)))
-    {
-        //wait here until transmission complete
-        //*p_serial << PMS("Master is transmitting.. ") << endl;
-    }
-
-    return SPDR;
-}
-
-void spi_driver::initializeSlave(void)
-{
-    // Set Master Input Slave Output to OUTPUT
-    DDRB |= (1 << PB3);
-
-    //Enable SPI
-    SPCR |= (1 << SPE);
-}
-
-volatile uint8_t* spi_driver::slaveReceive(void)
-{
-    while(!(SPSR & (1 << SPIF)))
-    {
-        //wait here until reception complete
-        //
-    }
-    return &SPDR;
-}
-
-
-emstream& operator << (emstream& serpt, spi_driver& spidrv)
-{
-    // Prints info to the serial port
-    serpt << PMS ("SPI CONTROL");
-    return (serpt);
-}
-
-
+//Eddie Ruano
+
+//*************************************************************************************
+/** @file adc.cpp
+ *    This file contains a very simple A/D converter driver. This driver should be
+ *
+ *  Revisions:
+ *    @li 01-15-2008 JRR Original (somewhat useful) file
+ *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
+ *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR Added transaction(); CE pin made an output on port D; SPI
+ *                       clock raised to F_CPU / 4
+ *
+ *  License:
+ *    This file is copyright 2015 by JR Ridgely and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "rs232int.h"                       // Include header for serial port class
+#include "spi_driver.h"
+
+
+spi_driver::spi_driver (emstream* p_serial_port)
+{
+    p_serial = p_serial_port;
+    
+    DBG (p_serial, "SPI Driver Engaged " << endl);
+}
+
+void spi_driver::initializeMaster(void)
+{
+    // Activate SPI in Power Reduction
+    PRR0 &= ~(1 << PRSPI);
+
+    // Set SCK and MOSI and CSN as outputs
+    DDRB |= ((1 << PB1) | (1 << PB2) | (1 << PB0));
+
+    //Set CE as outport
+    DDRD |= (1 << PD1);
+
+    // Set CSN as HIGH and CE as LOW
+    PORTB |= (1 << PB0);
+    PORTD &= ~(1 << PD1);
+
+    
+
+    // Enable SPI, set as Master, and Prescaler to 4; the nRF24 can go to 10 MHz,
+    // and a faster clock shortens the time its interrupt spends on the bus
+    SPCR |= ((1 << SPE) | (1 << MSTR));
+}
+
+char spi_driver::masterTransmit(unsigned char data)
+{
+    // Place Data in Data in/out register
+    SPDR = data;
+    while(!(SPSR & (1 << SPIF)))
+    {
+        //wait here until transmission complete
+        //*p_serial << PMS("Master is transmitting.. ") << endl;
+    }
+
+    return SPDR;
+}
+
+/**
+ * @brief      Send a command byte and exchange data bytes with the device.
+ * @details    CSN is held low for the whole transaction. The byte which comes
+ *             back while the command is sent is returned; for the nRF24 this is
+ *             its STATUS register. Each data byte sent comes from @c p_out, or is
+ *             0xFF if @c p_out is NULL; each byte received is put in @c p_in
+ *             unless it's NULL.
+ * @param      command  The first byte to send
+ * @param      p_out    Bytes to send after the command, or NULL
+ * @param      p_in     Space for the bytes received after the command, or NULL
+ * @param      count    The number of bytes to exchange after the command
+ * @return     The byte received while the command was sent
+ */
+uint8_t spi_driver::transaction (uint8_t command, const uint8_t* p_out,
+                                 uint8_t* p_in, uint8_t count)
+{
+    // Drop CSN to low
+    PORTB &= ~(1 << PB0);
+
+    uint8_t status = (uint8_t)masterTransmit (command);
+    for (uint8_t index = 0; index < count; index++)
+    {
+        uint8_t data = (uint8_t)masterTransmit (p_out ? p_out[index] : 0xFF);
+        if (p_in)
+        {
+            p_in[index] = data;
+        }
+    }
+
+    // Set CSN back HIGH
+    PORTB |= (1 << PB0);
+
+    return status;
+}
+
+void spi_driver::initializeSlave(void)
+{
+    // Set Master Input Slave Output to OUTPUT
+    DDRB |= (1 << PB3);
+
+    //Enable SPI
+    SPCR |= (1 << SPE);
+}
+
+volatile uint8_t* spi_driver::slaveReceive(void)
+{
+    while(!(SPSR & (1 << SPIF)))
+    {
+        //wait here until reception complete
+        //
+    }
+    return &SPDR;
+}
+
+
+emstream& operator << (emstream& serpt, spi_driver& spidrv)
+{
+    // Prints info to the serial port
+    serpt << PMS ("SPI CONTROL");
+    return (serpt);
+}
+
+
@@ -0,0 +1,494 @@
+//*************************************************************************************
+/** @file spi_engine.cpp
+ *    This file contains an interrupt driven driver for the SPI port on an AVR. The
+ *    SPI transfer complete interrupt clocks the bytes of queued transactions
+ *    through the port while the tasks which queued them sleep.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // FreeRTOS task functions
+#include "spi_engine.h"                     // Header for this file
+
+
+/// The SPCR bits which a transaction may choose: data order, mode and clock
+#define SPI_CONTROL_MASK ((1 << DORD) | (1 << CPOL) | (1 << CPHA) \
+                          | (1 << SPR1) | (1 << SPR0))
+
+
+/// Pointer to the one SPI engine, used by the SPI interrupt service routine
+spi_engine* p_spi_engine = NULL;
+
+
+/**
+ * @brief      Create an empty transaction.
+ * @details    A task usually keeps one transaction object and uses it over and
+ *             over, so its semaphore is made here. Transactions which are only
+ *             ever checked with @c status don't need a semaphore.
+ * @param      make_semaphore  True (the default) to make a semaphore for transfer()
+ */
+spi_transaction::spi_transaction (bool make_semaphore)
+{
+    p_cs_port = NULL;
+    cs_mask = 0;
+    control = SPI_DEFAULT_CONTROL;
+    double_speed = false;
+    send_command = false;
+    command = 0;
+    reply = 0;
+    p_out = NULL;
+    p_in = NULL;
+    count = 0;
+    status = SPI_OK;
+    p_next = NULL;
+
+    done = make_semaphore ? xSemaphoreCreateBinary () : NULL;
+}
+
+
+/**
+ * @brief      Choose the device which the transaction talks to.
+ * @details    The chip select pin is made an output and set high, so the device
+ *             isn't selected until the transaction runs. On an AVR each port's
+ *             data direction register is just below its output register.
+ * @param      p_port     The output register of the chip select pin's port, such as
+ *                        @c &PORTB, or NULL if the device has no chip select
+ * @param      pin        The chip select pin's number within the port
+ * @param      a_control  The @c DORD, @c CPOL, @c CPHA, @c SPR1 and @c SPR0 bits
+ * @param      a_double   True to double the clock rate with @c SPI2X
+ */
+void spi_transaction::set_device (volatile uint8_t* p_port, uint8_t pin,
+                                  uint8_t a_control, bool a_double)
+{
+    p_cs_port = p_port;
+    cs_mask = (1 << pin);
+    control = a_control & SPI_CONTROL_MASK;
+    double_speed = a_double;
+
+    if (p_cs_port != NULL)
+    {
+        *p_cs_port |= cs_mask;
+        *(p_cs_port - 1) |= cs_mask;
+    }
+}
+
+
+/**
+ * @brief      Set up a full duplex transfer with no command byte.
+ * @param      a_p_out  Bytes to send, or NULL to send 0xFF bytes
+ * @param      a_p_in   Space for the bytes received, or NULL to ignore them
+ * @param      a_count  The number of bytes to exchange
+ */
+void spi_transaction::set_transfer (const uint8_t* a_p_out, uint8_t* a_p_in,
+                                    uint8_t a_count)
+{
+    send_command = false;
+    p_out = a_p_out;
+    p_in = a_p_in;
+    count = a_count;
+}
+
+
+/**
+ * @brief      Set up a command byte followed by a full duplex transfer.
+ * @param      a_command  The byte sent first; the byte received with it goes in
+ *                        @c reply
+ * @param      a_p_out    Bytes to send after the command, or NULL for 0xFF bytes
+ * @param      a_p_in     Space for the bytes received after the command, or NULL
+ * @param      a_count    The number of bytes to exchange after the command
+ */
+void spi_transaction::set_command (uint8_t a_command, const uint8_t* a_p_out,
+                                   uint8_t* a_p_in, uint8_t a_count)
+{
+    set_transfer (a_p_out, a_p_in, a_count);
+    send_command = true;
+    command = a_command;
+}
+
+
+/**
+ * @brief      Set up the SPI port as a master and make an empty queue.
+ * @details    SCK, MOSI and SS are made outputs; SS has to be an output, or held
+ *             high, for the port to stay a master. The interrupt isn't enabled
+ *             until there's a transaction to run.
+ * @param      p_serial_port  A serial port for debugging messages
+ * @param      p_cs_port      The port of the chip select used by transaction()
+ * @param      cs_pin         The pin of the chip select used by transaction()
+ */
+spi_engine::spi_engine (emstream* p_serial_port, volatile uint8_t* p_cs_port,
+                        uint8_t cs_pin)
+    : spi_driver (p_serial_port)
+{
+    p_head = NULL;
+    p_tail = NULL;
+    index = 0;
+    command_next = false;
+    ok_count = 0;
+    timeout_count = 0;
+    task_woken = false;
+
+    // Activate SPI in Power Reduction
+    PRR0 &= ~(1 << PRSPI);
+
+    // Set SCK, MOSI and SS as outputs, with SS high
+    PORTB |= (1 << PB0);
+    DDRB |= ((1 << PB1) | (1 << PB2) | (1 << PB0));
+    SPCR = (1 << SPE) | (1 << MSTR) | SPI_DEFAULT_CONTROL;
+
+    default_trans.set_device (p_cs_port, cs_pin);
+    default_mutex = xSemaphoreCreateMutex ();
+
+    p_spi_engine = this;
+}
+
+
+/**
+ * @brief      Set up the port for the head transaction and send its first byte.
+ * @details    This method must be called with interrupts disabled. A transaction
+ *             with nothing at all to send is finished right away.
+ */
+void spi_engine::start_head (void)
+{
+    spi_transaction* p_trans = p_head;
+
+    p_trans->status = SPI_BUSY;
+    index = 0;
+    command_next = p_trans->send_command;
+
+    if (!command_next && p_trans->count == 0)
+    {
+        finish_head (SPI_OK);
+        return;
+    }
+
+    SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPIE) | p_trans->control;
+    if (p_trans->double_speed)
+    {
+        SPSR |= (1 << SPI2X);
+    }
+    else
+    {
+        SPSR &= ~(1 << SPI2X);
+    }
+
+    if (p_trans->p_cs_port != NULL)
+    {
+        *(p_trans->p_cs_port) &= ~(p_trans->cs_mask);
+    }
+
+    if (command_next)
+    {
+        SPDR = p_trans->command;
+    }
+    else
+    {
+        SPDR = p_trans->p_out ? p_trans->p_out[0] : 0xFF;
+    }
+}
+
+
+/**
+ * @brief      Finish the head transaction and start the next one.
+ * @details    This method must be called with interrupts disabled. The chip select
+ *             pin is raised and the transaction's semaphore is given to wake the
+ *             task waiting for it; @c task_woken is set if that task should run
+ *             before the one which was interrupted. If no more transactions are
+ *             waiting, the SPI interrupt is turned off.
+ * @param      result  The status with which the transaction has finished
+ */
+void spi_engine::finish_head (spi_status result)
+{
+    spi_transaction* p_trans = p_head;
+    signed portBASE_TYPE task_awakened = pdFALSE;
+
+    if (p_trans->p_cs_port != NULL)
+    {
+        *(p_trans->p_cs_port) |= p_trans->cs_mask;
+    }
+    p_trans->status = result;
+
+    if (result == SPI_OK)
+    {
+        ok_count++;
+    }
+    else if (timeout_count < 0xFFFF)
+    {
+        timeout_count++;
+    }
+
+    p_head = p_trans->p_next;
+    if (p_head != NULL)
+    {
+        start_head ();
+    }
+    else
+    {
+        p_tail = NULL;
+        SPCR &= ~(1 << SPIE);
+    }
+
+    if (p_trans->done != NULL)
+    {
+        xSemaphoreGiveFromISR (p_trans->done, &task_awakened);
+        if (task_awakened != pdFALSE)
+        {
+            task_woken = true;
+        }
+    }
+}
+
+
+/**
+ * @brief      Put a transaction in the queue without waiting for it to finish.
+ * @details    If the port is idle, the transaction is started right away. The
+ *             caller must not change the transaction or its buffers until its
+ *             status shows that it's finished or its semaphore has been given.
+ * @param      p_trans  Pointer to the transaction to be run
+ */
+void spi_engine::submit (spi_transaction* p_trans)
+{
+    p_trans->status = SPI_PENDING;
+    p_trans->p_next = NULL;
+
+    portENTER_CRITICAL ();
+    if (p_head == NULL)
+    {
+        p_head = p_trans;
+        p_tail = p_trans;
+        start_head ();
+    }
+    else
+    {
+        p_tail->p_next = p_trans;
+        p_tail = p_trans;
+    }
+    portEXIT_CRITICAL ();
+}
+
+
+/**
+ * @brief      Put a transaction in the queue and wait until it's done.
+ * @details    The calling task sleeps on the transaction's semaphore while the
+ *             bytes are clocked through the port. If the transaction hasn't
+ *             finished when the timeout runs out, it's cancelled and its status
+ *             is @c SPI_TIMEOUT. The transaction must have a semaphore.
+ * @param      p_trans  Pointer to the transaction to be run
+ * @param      timeout  The longest time to wait, in RTOS ticks
+ * @return     The status of the finished transaction, @c SPI_OK if it worked
+ */
+spi_status spi_engine::transfer (spi_transaction* p_trans, TickType_t timeout)
+{
+    submit (p_trans);
+
+    if (xSemaphoreTake (p_trans->done, timeout) != pdTRUE)
+    {
+        cancel (p_trans, SPI_TIMEOUT);
+
+        // If the transaction finished just before it was cancelled, its semaphore
+        // was given; take it so it isn't left over for the next transaction
+        xSemaphoreTake (p_trans->done, 0);
+    }
+
+    return (p_trans->status);
+}
+
+
+/**
+ * @brief      Take a transaction which hasn't finished out of the queue.
+ * @details    If the transaction is being clocked through the port, the byte in
+ *             progress is allowed to finish before the chip select is raised, as
+ *             writing SPDR during a byte would be ignored and the next transaction
+ *             would start out of step. A byte takes at most 128 processor cycles.
+ *             A transaction waiting in the queue is just unlinked, and one which
+ *             has already finished is left alone.
+ * @param      p_trans  Pointer to the transaction to be cancelled
+ * @param      result   The status to be given to the cancelled transaction
+ */
+void spi_engine::cancel (spi_transaction* p_trans, spi_status result)
+{
+    portENTER_CRITICAL ();
+    if (p_trans == p_head)
+    {
+        for (uint8_t wait = 0xFF; wait && !(SPSR & (1 << SPIF)); wait--)
+        {
+        }
+        (void)SPDR;
+        finish_head (result);
+
+        // This runs in a task, usually the one the transaction belonged to, so
+        // there's no switch to be made from an ISR
+        task_woken = false;
+    }
+    else if (p_trans->status == SPI_PENDING)
+    {
+        for (spi_transaction* p_prev = p_head; p_prev != NULL; p_prev = p_prev->p_next)
+        {
+            if (p_prev->p_next == p_trans)
+            {
+                p_prev->p_next = p_trans->p_next;
+                if (p_tail == p_trans)
+                {
+                    p_tail = p_prev;
+                }
+                break;
+            }
+        }
+        p_trans->status = result;
+        if (timeout_count < 0xFFFF)
+        {
+            timeout_count++;
+        }
+    }
+    portEXIT_CRITICAL ();
+}
+
+
+/**
+ * @brief      Run a command and transfer on the default chip select and wait.
+ * @details    This replaces the busy waiting @c spi_driver::transaction(), so a
+ *             device driver written for @c spi_driver sleeps instead of spinning.
+ *             Tasks take turns using the one transaction kept for this method.
+ * @param      command  The first byte to send
+ * @param      p_out    Bytes to send after the command, or NULL for 0xFF bytes
+ * @param      p_in     Space for the bytes received after the command, or NULL
+ * @param      count    The number of bytes to exchange after the command
+ * @return     The byte received while the command was sent
+ */
+uint8_t spi_engine::transaction (uint8_t command, const uint8_t* p_out,
+                                 uint8_t* p_in, uint8_t count)
+{
+    xSemaphoreTake (default_mutex, portMAX_DELAY);
+    default_trans.set_command (command, p_out, p_in, count);
+    transfer (&default_trans);
+    uint8_t reply = default_trans.reply;
+    xSemaphoreGive (default_mutex);
+
+    return reply;
+}
+
+
+/**
+ * @brief      Save the byte just received and send the next one.
+ * @details    This method is called by the SPI interrupt service routine each time
+ *             a byte has been exchanged. When the last byte is in, the transaction
+ *             is finished and the next one in the queue is started.
+ */
+void spi_engine::isr (void)
+{
+    spi_transaction* p_trans = p_head;
+
+    // Reading SPDR after SPSR clears the flag; with nothing in the queue, the
+    // interrupt is left over from a cancelled transaction
+    uint8_t data = SPDR;
+    if (p_trans == NULL)
+    {
+        SPCR &= ~(1 << SPIE);
+        return;
+    }
+
+    if (command_next)
+    {
+        p_trans->reply = data;
+        command_next = false;
+    }
+    else
+    {
+        if (p_trans->p_in)
+        {
+            p_trans->p_in[index] = data;
+        }
+        index++;
+    }
+
+    if (index < p_trans->count)
+    {
+        SPDR = p_trans->p_out ? p_trans->p_out[index] : 0xFF;
+    }
+    else
+    {
+        finish_head (SPI_OK);
+    }
+}
+
+
+/**
+ * @brief      Switch to a task woken by the transaction which has just finished.
+ * @details    This is called by the SPI interrupt service routine after @c isr(),
+ *             and never from a task. If finishing a transaction woke a task of
+ *             higher priority than the one which was interrupted, the context is
+ *             switched before the ISR returns, as FreeRTOS's own AVR serial port
+ *             demonstration does, so the task runs now rather than at the next
+ *             RTOS tick.
+ */
+void spi_engine::yield_if_woken (void)
+{
+    if (task_woken)
+    {
+        task_woken = false;
+        portYIELD ();
+    }
+}
+
+
+/**
+ * @brief      Print the numbers of finished and timed out transactions.
+ * @param      p_ser_dev  Pointer to a serial device on which to print them
+ */
+void spi_engine::print_status (emstream* p_ser_dev)
+{
+    *p_ser_dev << PMS ("SPI: ") << ok_count << PMS (" OK, ") << timeout_count
+               << PMS (" timeouts") << endl;
+}
+
+
+/**
+ * @brief      Print a short name for the status of a transaction.
+ * @param      serpt   Reference to a serial port to which to print the name
+ * @param      status  The status whose name is to be printed
+ * @return     A reference to the same serial device on which we write
+ */
+emstream& operator << (emstream& serpt, spi_status status)
+{
+    switch (status)
+    {
+        case SPI_PENDING:   serpt << PMS ("pending");   break;
+        case SPI_BUSY:      serpt << PMS ("busy");      break;
+        case SPI_OK:        serpt << PMS ("OK");        break;
+        case SPI_TIMEOUT:   serpt << PMS ("timeout");   break;
+    }
+    return (serpt);
+}
+
+
+/**
+ * @brief      Interrupt service routine for the SPI port, which runs each time a
+ *             byte has been exchanged; all the work is done by the engine.
+ */
+ISR (SPI_STC_vect)
+{
+    if (p_spi_engine != NULL)
+    {
+        p_spi_engine->isr ();
+        p_spi_engine->yield_if_woken ();
+    }
+}
@@ -76,3 +76,14 @@
 #define FLUSH_RX      0xE2
 #define REUSE_TX_PL   0xE3
 #define NOP           0xFF
+
+/* Registers, bits and instructions for dynamic payloads */
+#define DYNPD       0x1C
+#define FEATURE     0x1D
+#define EN_DPL      2
+#define EN_ACK_PAY  1
+#define EN_DYN_ACK  0
+#define ACTIVATE      0x50
+#define R_RX_PL_WID   0x60
+#define W_ACK_PAYLOAD 0xA8
+#define W_TX_PAYLOAD_NOACK 0xB0
@@ -1,13 +1,20 @@
-/** @file adc.h
- *    This file contains a very simple A/D converter driver. The driver is hopefully
- *    thread safe in FreeRTOS due to the use of a mutex to prevent its use by multiple
- *    tasks at the same time. There is no protection from priority inversion, however,
- *    except for the priority elevation in the mutex.
+/** @file nrf24_driver.h
+ *    This file contains an interrupt driven driver for the nRF24L01+ radio. The
+ *    radio's IRQ line is connected to INT0, and the external interrupt wakes the
+ *    driver's service task, which reads the radio's status, empties its receive
+ *    FIFO into a queue of frames for a task to read, and refills its 3-deep
+ *    transmit FIFO from a queue of frames which tasks have sent. Payloads have
+ *    dynamic lengths of up to 32 bytes and are acknowledged automatically by the
+ *    receiving radio.
  *
  *  Revisions:
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR IRQ line handled by an INT0 interrupt, with frame queues,
+ *                       dynamic payloads, auto-ack, and retransmit and loss counters
+ *    @li 10-16-2026 ERR Radio serviced by a task woken by INT0, so its SPI transfers
+ *                       can sleep on the interrupt driven SPI engine
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -34,28 +41,165 @@
 #include "task.h"                           // Header for FreeRTOS task functions
 #include "queue.h"                          // Header for FreeRTOS queues
 #include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "taskqueue.h"                      // Header for FreeRTOS queue wrappers
 #include "spi_driver.h"
 
+/// The longest payload the radio can carry, in bytes
+#define NRF24_PAYLOAD_MAX   32
+
+/// The number of payloads the radio's transmit FIFO holds
+#define NRF24_TX_FIFO_DEPTH 3
+
+/// The number of frames held in each of the driver's receive and transmit queues
+#define NRF24_QUEUE_SIZE    4
+
+/// The RF channel, 2400 MHz plus this many MHz
+#define NRF24_CHANNEL       0x76
+
+/// The priority of the task which services the radio; it's the highest, as the
+/// task only runs briefly when the radio needs attention
+#define NRF24_PRIORITY      (configMAX_PRIORITIES - 1)
+
+/// The stack size of the task which services the radio, in bytes
+#define NRF24_STACK_SIZE    240
+
+
+/** @brief   One payload sent or received by the radio.
+ */
+struct nrf24_frame
+{
+    uint8_t pipe;                           ///< Data pipe it came in on, 0 to 5
+    uint8_t length;                         ///< Number of bytes in @c data
+    uint8_t data[NRF24_PAYLOAD_MAX];        ///< The payload itself
+};
+
+
+/** @brief   Interrupt driven driver for an nRF24L01+ radio.
+ *  @details The radio normally listens as a primary receiver. When a task calls
+ *           @c send(), the frame is queued and the service task is woken; if the
+ *           radio isn't already sending, it's switched to a primary transmitter and
+ *           up to three frames are loaded into its FIFO. Each time a frame is
+ *           acknowledged, the IRQ line wakes the service task, which loads another
+ *           from the queue; when there's nothing left to send, it switches the
+ *           radio back to listening. Received frames are put in a queue which a
+ *           task reads with @c receive().
+ *
+ *           The INT0 interrupt only masks itself and gives a semaphore; the SPI
+ *           transfers are done by the service task, as they sleep while the SPI
+ *           engine clocks the bytes and sleeping isn't allowed in an ISR. INT0 is
+ *           unmasked again when the radio has no more flags set.
+ *
+ *           All the SPI traffic goes through @c spi_driver::transaction(), so on a
+ *           PC the driver can be run against a simulated radio (see @c nrf24_sim)
+ *           instead of the real one. Only one radio can be used, as the ISR finds
+ *           it through @c p_nrf24.
+ */
 class nrf24_driver
 {
 protected:
     /// Pointer to RS232 serial declared in main()
     emstream* p_serial;
 
+    /// Queue of frames which have been received, waiting for a task to read them
+    TaskQueue<nrf24_frame>* p_rx_queue;
+
+    /// Queue of frames which tasks have sent, waiting to go into the radio's FIFO
+    TaskQueue<nrf24_frame>* p_tx_queue;
+
+    /// Semaphore given by the INT0 interrupt, or by send(), to wake the service task
+    SemaphoreHandle_t irq_signal;
+
+    /// Mutex which lets one task at a time carry out a series of SPI commands
+    SemaphoreHandle_t spi_mutex;
+
+    /// The bits always set in the CONFIG register, which sets up the CRC
+    uint8_t config_base;
+
+    /// True once initialize() has set up the radio
+    bool ready;
+
+    /// True while the radio is a primary transmitter
+    bool transmitting;
+
+    /// How many frames are in the radio's transmit FIFO
+    uint8_t tx_in_fifo;
+
+    uint32_t rx_count;                      ///< Frames received and queued
+    uint32_t tx_count;                      ///< Frames sent and acknowledged
+    uint32_t retransmits;                   ///< Retransmissions seen; a lower bound
+    uint16_t tx_lost;                       ///< Frames never acknowledged
+    uint16_t rx_dropped;                    ///< Frames dropped as the queue was full
+
+    /// Send a command and its data bytes, returning the status register
+    uint8_t command (uint8_t cmd, const uint8_t* p_out = NULL, uint8_t* p_in = NULL,
+                     uint8_t count = 0)
+    {
+        return (local_spi_driver -> transaction (cmd, p_out, p_in, count));
+    }
+
+    // Write one byte to a register
+    void write_reg (uint8_t reg, uint8_t value);
+
+    // Read one byte from a register
+    uint8_t read_reg (uint8_t reg);
+
+    // Set the radio's CE pin high or low
+    void set_ce (bool high);
+
+    // Move frames from the receive FIFO into the receive queue
+    void read_rx_fifo (void);
+
+    // Move frames from the transmit queue into the transmit FIFO
+    void load_tx_fifo (void);
+
+    // Make the radio a primary receiver and start listening
+    void enter_rx (void);
+
+    // Handle the radio's flags until none are left, then fill its transmit FIFO
+    void service (void);
+
+    // The function run by the service task, which is given a pointer to the driver
+    static void service_task (void* p_driver);
+
 public:
     spi_driver* local_spi_driver;
-    nrf24_driver (emstream*);
+
+    // Make a driver and its service task, which use the given SPI driver
+    nrf24_driver (emstream*, spi_driver* p_spi = NULL,
+                  unsigned portBASE_TYPE priority = NRF24_PRIORITY);
+
     uint8_t readRegister(uint8_t);
     uint8_t *writeRegister(uint8_t, uint8_t, uint8_t*, uint8_t);
+
+    // Set up the radio's registers and the IRQ interrupt, then start listening
     void initialize(void);
-    void recPayload(void);
-    void reset(void);
-    void recPayload(uint8_t, uint8_t *);
+
+    // Queue a frame to be sent
+    bool send (const uint8_t* p_data, uint8_t length, TickType_t wait = 0);
+
+    // Get a received frame, waiting for one if necessary
+    bool receive (nrf24_frame& frame, TickType_t wait = portMAX_DELAY);
+
+    // Wake the service task when the IRQ line is low; called only by INT0
+    void isr (void);
+
+    // Get the numbers of frames and errors, each safely from the service task
+    uint32_t get_rx_count (void);
+    uint32_t get_tx_count (void);
+    uint32_t get_retransmits (void);
+    uint16_t get_tx_lost (void);
+    uint16_t get_rx_dropped (void);
+
     void printNRF(emstream*, nrf24_driver*);
 
+    // Print the frame, retransmit and loss counts
+    void print_status (emstream* p_ser_dev);
 };
 
 
+/// Pointer to the radio driver run by the INT0 interrupt
+extern nrf24_driver* p_nrf24;
+
 emstream& operator << (emstream&, nrf24_driver&);
 
 #endif
@@ -0,0 +1,121 @@
+/** @file nrf24_sim.h
+ *    This file contains a simulated nRF24L01+ radio, which stands in for the SPI
+ *    port and the real radio when the program is run on a PC. It keeps the radio's
+ *    registers and FIFOs, answers the same SPI commands, and pulls its simulated
+ *    IRQ line low by running the INT0 interrupt service routine. A test program
+ *    puts frames "on the air" for it to receive, tells it to drop acknowledgements,
+ *    and checks what it sent, so the driver's interrupt handling can be tried out
+ *    without any hardware. It's only compiled when @c POSIX_HOST is defined.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _NRF24_SIM_H
+#define _NRF24_SIM_H
+
+#ifdef POSIX_HOST
+
+#include "spi_driver.h"
+#include "nrf24_driver.h"
+
+/** @brief   A simulated nRF24L01+ radio on a simulated SPI port.
+ *  @details The radio's time passes only when @c step() is called: each call sends
+ *           at most one frame from the transmit FIFO, as the real radio sends one
+ *           frame per few hundred microseconds. The CE pin is read from the
+ *           simulated PORTD, and the IRQ line is low whenever a STATUS flag is set;
+ *           while it's low and INT0 is enabled, the INT0 interrupt is run.
+ */
+class nrf24_sim : public spi_driver
+{
+protected:
+    /// The single-byte registers, by address
+    uint8_t regs[0x20];
+
+    /// The five-byte addresses of pipe 0, pipe 1, and the transmitter
+    uint8_t addresses[3][5];
+
+    /// The receive FIFO, oldest frame first
+    nrf24_frame rx_fifo[3];
+    uint8_t rx_fill;                        ///< Number of frames in @c rx_fifo
+
+    /// The transmit FIFO, oldest frame first
+    nrf24_frame tx_fifo[NRF24_TX_FIFO_DEPTH];
+    uint8_t tx_fill;                        ///< Number of frames in @c tx_fifo
+
+    /// The number of transmissions from now on which get no acknowledgement
+    uint16_t acks_to_drop;
+
+    /// The number of frames which have been sent and acknowledged
+    uint16_t air_sent;
+
+    /// The most recent frame which was sent and acknowledged
+    nrf24_frame last_sent;
+
+    // Find the value of the STATUS register
+    uint8_t status (void);
+
+    // Find which of the address arrays a register refers to, if any
+    uint8_t* address_of (uint8_t reg);
+
+    // Run the INT0 interrupt if the IRQ line is low and INT0 is on
+    void update_irq (void);
+
+public:
+    // Make a simulated radio in its power-on state
+    nrf24_sim (emstream* p_serial_port);
+
+    // Answer a command as the radio would
+    virtual uint8_t transaction (uint8_t command, const uint8_t* p_out,
+                                 uint8_t* p_in, uint8_t count);
+
+    // Let the radio send one frame, if it's transmitting and has one to send
+    void step (void);
+
+    // Have the radio receive a frame from another radio
+    bool air_receive (uint8_t pipe, const uint8_t* p_data, uint8_t length);
+
+    /** @brief   Make the next transmissions go unacknowledged.
+     *  @param   count The number of transmissions, including retries, to drop
+     */
+    void drop_acks (uint16_t count)
+    {
+        acks_to_drop = count;
+    }
+
+    /** @brief   Get the number of frames the radio has sent and had acknowledged.
+     *  @return  The number of frames sent
+     */
+    uint16_t get_air_sent (void)
+    {
+        return (air_sent);
+    }
+
+    /** @brief   Get the most recent frame the radio sent.
+     *  @return  A reference to the frame
+     */
+    const nrf24_frame& get_last_sent (void)
+    {
+        return (last_sent);
+    }
+};
+
+#endif // POSIX_HOST
+
+#endif // _NRF24_SIM_H
@@ -1,61 +1,66 @@
-/** @file adc.h
- *    This file contains a very simple A/D converter driver. The driver is hopefully
- *    thread safe in FreeRTOS due to the use of a mutex to prevent its use by multiple
- *    tasks at the same time. There is no protection from priority inversion, however,
- *    except for the priority elevation in the mutex.
- *
- *  Revisions:
- *    @li 01-15-2008 JRR Original (somewhat useful) file
- *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
- *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
- *
- *  License:
- *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
- *    Public License, version 2. It intended for educational use only, but its use
- *    is not limited thereto. */
-/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
- *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
- *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
- *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
- *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
- *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
- *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
- *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
- *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
-//======================================================================================
-
-// This define prevents this .H file from being included multiple times in a .CPP file
-#ifndef _AVR_SPI_H
-#define _AVR_SPI_H
-
-#include "emstream.h"                       // Header for serial ports and devices
-#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
-#include "task.h"                           // Header for FreeRTOS task functions
-#include "queue.h"                          // Header for FreeRTOS queues
-#include "semphr.h"                         // Header for FreeRTOS semaphores
-
-class spi_driver
-{
-protected:
-    /// Pointer to RS232 serial declared in main()
-    emstream* p_serial;
-
-public:
-
-    spi_driver (emstream*);
-    void initializeMaster(void);
-    char masterTransmit(unsigned char);
-    void initializeSlave(void);
-    volatile uint8_t* slaveReceive(void);
-
-
-
-
-
-};
-
-
-emstream& operator << (emstream&, spi_driver&);
-
-#endif
+/** @file adc.h
+ *    This file contains a very simple A/D converter driver. The driver is hopefully
+ *    thread safe in FreeRTOS due to the use of a mutex to prevent its use by multiple
+ *    tasks at the same time. There is no protection from priority inversion, however,
+ *    except for the priority elevation in the mutex.
+ *
+ *  Revisions:
+ *    @li 01-15-2008 JRR Original (somewhat useful) file
+ *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
+ *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-16-2026 ERR Added transaction(), which a simulated device can replace
+ *
+ *  License:
+ *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _AVR_SPI_H
+#define _AVR_SPI_H
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // Header for FreeRTOS queues
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+
+class spi_driver
+{
+protected:
+    /// Pointer to RS232 serial declared in main()
+    emstream* p_serial;
+
+public:
+
+    spi_driver (emstream*);
+    void initializeMaster(void);
+    char masterTransmit(unsigned char);
+
+    // Send a command byte and exchange data bytes with the selected device
+    virtual uint8_t transaction (uint8_t command, const uint8_t* p_out,
+                                 uint8_t* p_in, uint8_t count);
+    void initializeSlave(void);
+    volatile uint8_t* slaveReceive(void);
+
+
+
+
+
+};
+
+
+emstream& operator << (emstream&, spi_driver&);
+
+#endif
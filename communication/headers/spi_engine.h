@@ -0,0 +1,212 @@
+//*************************************************************************************
+/** @file spi_engine.h
+ *    This file contains an interrupt driven driver for the SPI port on an AVR. The
+ *    old @c spi_driver::masterTransmit() waits in a loop for the @c SPIF flag after
+ *    every byte. Here a task describes a whole transaction (which chip to select,
+ *    an optional command byte, and the bytes to send and receive) and puts it in a
+ *    queue. The SPI transfer complete interrupt then clocks the bytes through one at
+ *    a time, drops and raises the chip select, and gives a semaphore when the
+ *    transaction is finished. The task sleeps until then, so other tasks can run.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _SPI_ENGINE_H
+#define _SPI_ENGINE_H
+
+#include <avr/io.h>
+#include "emstream.h"                       // Header for serial ports and devices
+#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "spi_driver.h"
+
+
+/** @brief   The SPCR bits for the default clock, F_CPU / 16.
+ *  @details Each byte costs one interrupt of roughly 80 cycles. At F_CPU / 16 a byte
+ *           takes 128 cycles on the bus, so about a third of the processor's time
+ *           is left over while a transfer runs; at F_CPU / 4 the interrupts would
+ *           use more time than spinning on @c SPIF does. Devices which need a fast
+ *           clock for long transfers can choose one in their transactions.
+ */
+#define SPI_DEFAULT_CONTROL     (1 << SPR0)
+
+/// The number of RTOS ticks a task waits for a transaction to finish
+#define SPI_TIMEOUT_TICKS       (configTICK_RATE_HZ / 50)
+
+
+/** @brief   Results of an SPI transaction.
+ */
+enum spi_status
+{
+    SPI_PENDING,                            ///< Waiting in the queue
+    SPI_BUSY,                               ///< Being clocked through the port
+    SPI_OK,                                 ///< Finished
+    SPI_TIMEOUT                             ///< Didn't finish in time and was cancelled
+};
+
+
+/** @brief   Description of one SPI transaction.
+ *  @details The chip select pin is driven low, then the command byte is sent if
+ *           @c send_command is true, and the byte which comes back is saved in
+ *           @c reply. Then @c count bytes are exchanged: each one sent comes from
+ *           @c p_out, or is 0xFF if @c p_out is NULL, and each one received goes
+ *           into @c p_in unless it's NULL. Both can point to the same buffer, as
+ *           each byte is sent before the one in its place is received. Last, the
+ *           chip select pin is raised.
+ *
+ *           The SPI mode and clock rate are set by @c control, which holds the
+ *           @c CPOL, @c CPHA, @c DORD, @c SPR1 and @c SPR0 bits of @c SPCR, and by
+ *           @c double_speed, which sets @c SPI2X; each transaction can have its own,
+ *           so devices with different needs can share the port. The buffers belong
+ *           to the task which made the transaction and mustn't be touched until the
+ *           transaction is finished.
+ */
+class spi_transaction
+{
+public:
+    volatile uint8_t* p_cs_port;            ///< Port with the chip select pin, or NULL
+    uint8_t cs_mask;                        ///< Bit mask for the chip select pin
+    uint8_t control;                        ///< Mode and clock bits for SPCR
+    bool double_speed;                      ///< True to double the clock with SPI2X
+    bool send_command;                      ///< True to send @c command first
+    uint8_t command;                        ///< Command byte, such as a register address
+    uint8_t reply;                          ///< Byte received while sending @c command
+    const uint8_t* p_out;                   ///< Bytes to send, or NULL for 0xFF bytes
+    uint8_t* p_in;                          ///< Space for bytes received, or NULL
+    uint8_t count;                          ///< Number of bytes after the command
+    volatile spi_status status;             ///< How the transaction is going
+
+    /// Semaphore given by the interrupt service routine when the transaction is done
+    SemaphoreHandle_t done;
+
+    /// The next transaction in the queue, or @c NULL if this is the last one
+    spi_transaction* p_next;
+
+    // Create an empty transaction, with its own semaphore if asked for one
+    spi_transaction (bool make_semaphore = true);
+
+    // Choose the chip select pin, SPI mode and clock rate
+    void set_device (volatile uint8_t* p_port, uint8_t pin,
+                     uint8_t a_control = SPI_DEFAULT_CONTROL, bool a_double = false);
+
+    // Set up a full duplex transfer of bytes with no command byte
+    void set_transfer (const uint8_t* a_p_out, uint8_t* a_p_in, uint8_t a_count);
+
+    // Set up a command byte followed by a full duplex transfer
+    void set_command (uint8_t a_command, const uint8_t* a_p_out, uint8_t* a_p_in,
+                      uint8_t a_count);
+};
+
+
+/** @brief   Interrupt driven master for the SPI port.
+ *  @details There is only one SPI port, so only one of these should be made; the
+ *           interrupt service routine finds it through @c p_spi_engine. Any number
+ *           of tasks can share it, as their transactions are run in turn. A task
+ *           calls @c transfer() to queue a transaction and sleep until it's done, or
+ *           @c submit() to queue one and carry on.
+ *
+ *           This class is also an @c spi_driver, whose @c transaction() method runs
+ *           a command and transfer on the default chip select pin and sleeps until
+ *           it's done, so a driver written for @c spi_driver uses the interrupt
+ *           driven port without any changes. That method, like @c transfer(), has
+ *           to be called from a task after the scheduler has started, and never from
+ *           an interrupt service routine or critical section.
+ */
+class spi_engine : public spi_driver
+{
+protected:
+    /// The transaction being clocked through the port, first in the queue
+    spi_transaction* volatile p_head;
+
+    /// The last transaction in the queue
+    spi_transaction* volatile p_tail;
+
+    /// Index of the next byte to be received in the current transaction
+    uint8_t index;
+
+    /// True while the command byte of the current transaction is being sent
+    bool command_next;
+
+    /// Number of transactions which have finished
+    uint32_t ok_count;
+
+    /// Number of transactions which timed out
+    uint16_t timeout_count;
+
+    /// True when a finished transaction has woken a task of higher priority
+    bool task_woken;
+
+    /// The transaction used by @c transaction(), with the default chip select
+    spi_transaction default_trans;
+
+    /// Mutex which lets one task at a time use @c default_trans
+    SemaphoreHandle_t default_mutex;
+
+    // Set up the port for the head transaction and send its first byte
+    void start_head (void);
+
+    // Finish the head transaction and start the next one
+    void finish_head (spi_status result);
+
+public:
+    // Set up the SPI port as a master and make an empty queue
+    spi_engine (emstream* p_serial_port, volatile uint8_t* p_cs_port = &PORTB,
+                uint8_t cs_pin = PB0);
+
+    // Put a transaction in the queue without waiting for it to finish
+    void submit (spi_transaction* p_trans);
+
+    // Put a transaction in the queue and wait until it's done or has timed out
+    spi_status transfer (spi_transaction* p_trans,
+                         TickType_t timeout = SPI_TIMEOUT_TICKS);
+
+    // Take a transaction which hasn't finished out of the queue
+    void cancel (spi_transaction* p_trans, spi_status result);
+
+    // Run a command and transfer on the default chip select and wait for it
+    virtual uint8_t transaction (uint8_t command, const uint8_t* p_out,
+                                 uint8_t* p_in, uint8_t count);
+
+    // Exchange the next byte; called only by the SPI interrupt service routine
+    void isr (void);
+
+    // Switch to a task woken by a finished transaction; called only by the ISR
+    void yield_if_woken (void);
+
+    /** @brief   Check whether any transactions are waiting or being run.
+     *  @return  True if the port is busy with queued transactions
+     */
+    bool is_busy (void)
+    {
+        return (p_head != NULL);
+    }
+
+    // Print the numbers of transactions and timeouts
+    void print_status (emstream* p_ser_dev);
+};
+
+
+/// Pointer to the one SPI engine, used by the SPI interrupt service routine
+extern spi_engine* p_spi_engine;
+
+// Print a short name for a transaction's status
+emstream& operator << (emstream& serpt, spi_status status);
+
+#endif // _SPI_ENGINE_H
@@ -13,7 +13,9 @@
  *  @author Eddie Ruano
  *  @author JR Ridgely
  *
- *  Revisions: @li 4/26/2016 ERR added a new module for testing of the encoder
+ *  Revisions: @li 10/16/2026 ERR radio state uses the interrupt driven nRF24
+ *             driver and prints each frame it receives
+ *             @li 4/26/2016 ERR added a new module for testing of the encoder
  *             task
  *             @li 4/23/2016 added a bunch of helper methods to make testing
  *             easier in the future
@@ -151,40 +153,32 @@ void task_user::run (void)
 
             break; // End of state 0
         case (1):
-            nrf24_driver* main_nrf24;
-            main_nrf24 = new nrf24_driver(p_serial);
-
-
-            main_nrf24 -> printNRF(p_serial, main_nrf24);
-
-            main_nrf24 -> initialize();
-
-            //Space
-            *p_serial << endl << endl << endl;
-
-            main_nrf24 -> printNRF(p_serial, main_nrf24);
-
-            PORTD |= (1 << PD1);
-            //delay(500);
-            while (main_nrf24 -> readRegister(STATUS) != 0x40)
+            // Set up the radio the first time through; after that, the INT0
+            // interrupt puts each frame it receives into the driver's queue
+            if (p_nrf24 == NULL)
             {
-                //main_nrf24 -> printNRF(p_serial, main_nrf24);
+                new nrf24_driver(p_serial);
+                p_nrf24 -> initialize();
+                p_nrf24 -> printNRF(p_serial, p_nrf24);
             }
-
-            *p_serial << "Broke Loop! " << endl;
-            uint8_t data_read[32];
-
-            main_nrf24 -> recPayload(4, data_read);
-
-            // *p_serial << endl << endl << "DATA READ: "<< hex << data_read[0] << " " << data_read[1] << " " << data_read[2] << " " << data_read[3] << " " << data_read[4] << " " << endl;
-            *p_serial << "Data Read" << endl;
-            uint8_t count;
-            for (count = 0; count < 4; count++)
+            else
             {
-                *p_serial << hex << count << ": " << data_read[count] << endl;
+                nrf24_frame frame;
+                if (p_nrf24 -> receive(frame, 0))
+                {
+                    *p_serial << "Pipe " << dec << frame.pipe << ":" << hex;
+                    for (count = 0; count < frame.length; count++)
+                    {
+                        *p_serial << ' ' << frame.data[count];
+                    }
+                    *p_serial << endl;
+                }
+                if (hasUserInput())
+                {
+                    *p_serial << *p_nrf24;
+                    transition_to(0);
+                }
             }
-
-            PORTD &= ~(1 << PD1);
             break;
         default:
             *p_serial << PMS ("Illegal state! Resetting AVR") << endl;
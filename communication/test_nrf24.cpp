@@ -0,0 +1,224 @@
+//*************************************************************************************
+/** @file test_nrf24.cpp
+ *    This file contains a test of the interrupt driven nRF24L01+ driver which runs
+ *    on a PC. The driver talks to the simulated radio in @c nrf24_sim.cpp instead of
+ *    a real one, and one task puts frames on the air, sends frames and drops
+ *    acknowledgements, checking after each step that the driver received, queued,
+ *    retried or gave up as it should. Build and run it with
+ *    'make -f Makefile.posix run'; the program's exit status is zero only if every
+ *    check passed.
+ *
+ *  Revisions:
+ *    @li 10-16-2026 ERR Original file, with receive, overflow, refill and maximum
+ *                       retry tests
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <stdlib.h>                         // For exit()
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "nRF24L01.h"                       // Register names of the radio
+#include "nrf24_driver.h"                   // The driver being tested
+#include "nrf24_sim.h"                      // The simulated radio it talks to
+
+
+/// The serial port on which results are printed
+static rs232* p_ser_port;
+
+/// The number of checks which have failed
+static uint16_t failures = 0;
+
+/// Print the line number and text of a check which fails, and count it
+#define CHECK(test) check ((test), __LINE__, #test)
+
+
+/**
+ * @brief      Count a check which failed and print where it is.
+ * @param      passed  True if the check passed
+ * @param      line    The line in this file on which the check is
+ * @param      p_text  The check's source code
+ */
+static void check (bool passed, uint16_t line, const char* p_text)
+{
+    if (!passed)
+    {
+        *p_ser_port << PMS ("FAIL line ") << line << PMS (": ") << p_text << endl;
+        failures++;
+    }
+}
+
+
+/**
+ * @brief      Check that frames which arrive on two pipes are received in order,
+ *             and that nothing more is received after them.
+ * @param      p_sim  Pointer to the simulated radio
+ */
+static void test_receive (nrf24_sim* p_sim)
+{
+    uint8_t short_data[3] = {1, 2, 3};
+    uint8_t long_data[7] = {9, 8, 7, 6, 5, 4, 3};
+    nrf24_frame frame;
+
+    CHECK (p_sim->air_receive (0, short_data, 3));
+    CHECK (p_sim->air_receive (1, long_data, 7));
+    vTaskDelay (2);
+
+    CHECK (p_nrf24->receive (frame, 10));
+    CHECK (frame.pipe == 0 && frame.length == 3 && frame.data[2] == 3);
+    CHECK (p_nrf24->receive (frame, 10));
+    CHECK (frame.pipe == 1 && frame.length == 7 && frame.data[6] == 3);
+    CHECK (!p_nrf24->receive (frame, 2));
+}
+
+
+/**
+ * @brief      Check that frames which arrive while no task reads them fill the
+ *             receive queue and are then counted as dropped. The radio's own FIFO
+ *             refuses frames once it's full, so not every frame is acknowledged.
+ * @param      p_sim  Pointer to the simulated radio
+ */
+static void test_overflow (nrf24_sim* p_sim)
+{
+    uint8_t data[3] = {4, 5, 6};
+    uint32_t rx_before = p_nrf24->get_rx_count ();
+    uint16_t acked = 0;
+    nrf24_frame frame;
+
+    for (uint8_t count = 0; count < 8; count++)
+    {
+        acked += p_sim->air_receive (0, data, 3);
+        vTaskDelay (2);
+    }
+    CHECK (p_nrf24->get_rx_count () - rx_before == 4);
+    CHECK (p_nrf24->get_rx_dropped () == acked - NRF24_QUEUE_SIZE);
+
+    while (p_nrf24->receive (frame, 0))
+    {
+    }
+}
+
+
+/**
+ * @brief      Check that more frames than the radio's transmit FIFO holds are all
+ *             sent, the rest being put in the FIFO from the driver's queue as
+ *             room is made, and that the radio goes back to receiving afterwards.
+ * @param      p_sim  Pointer to the simulated radio
+ */
+static void test_refill (nrf24_sim* p_sim)
+{
+    for (uint8_t index = 0; index < NRF24_TX_FIFO_DEPTH + 1; index++)
+    {
+        uint8_t data[2] = {index, 0x55};
+        CHECK (p_nrf24->send (data, 2));
+    }
+    vTaskDelay (2);
+    for (uint8_t count = 0; count < 10; count++)
+    {
+        p_sim->step ();
+        vTaskDelay (2);
+    }
+    CHECK (p_sim->get_air_sent () == NRF24_TX_FIFO_DEPTH + 1);
+    CHECK (p_sim->get_last_sent ().data[0] == NRF24_TX_FIFO_DEPTH);
+    CHECK (p_nrf24->get_tx_count () == NRF24_TX_FIFO_DEPTH + 1);
+    CHECK ((p_nrf24->readRegister (CONFIG) & (1 << PRIM_RX)) != 0);
+}
+
+
+/**
+ * @brief      Check that a frame whose first few acknowledgements are lost is
+ *             retried until it gets through, and that one which never gets an
+ *             acknowledgement is counted as lost once the radio gives up.
+ * @param      p_sim  Pointer to the simulated radio
+ */
+static void test_max_retry (nrf24_sim* p_sim)
+{
+    uint32_t tx_before = p_nrf24->get_tx_count ();
+    uint32_t retries_before = p_nrf24->get_retransmits ();
+    uint8_t data[1] = {0x77};
+
+    p_sim->drop_acks (3);
+    CHECK (p_nrf24->send (data, 1));
+    vTaskDelay (2);
+    p_sim->step ();
+    vTaskDelay (2);
+    CHECK (p_nrf24->get_retransmits () - retries_before == 3);
+    CHECK (p_nrf24->get_tx_count () - tx_before == 1);
+    CHECK (p_nrf24->get_tx_lost () == 0);
+
+    // The driver sets up the radio to make one try and 15 retries before giving up
+    retries_before = p_nrf24->get_retransmits ();
+    p_sim->drop_acks (0xFFFF);
+    data[0] = 0x88;
+    CHECK (p_nrf24->send (data, 1));
+    vTaskDelay (2);
+    p_sim->step ();
+    vTaskDelay (2);
+    p_sim->drop_acks (0);
+    CHECK (p_nrf24->get_tx_lost () == 1);
+    CHECK (p_nrf24->get_retransmits () - retries_before == 15);
+    CHECK (p_nrf24->get_tx_count () - tx_before == 1);
+    CHECK ((p_nrf24->readRegister (CONFIG) & (1 << PRIM_RX)) != 0);
+}
+
+
+/**
+ * @brief      The task which runs the tests, then ends the program with an exit
+ *             status which tells whether they passed.
+ * @param      p_params  Not used
+ */
+static void test_task (void* p_params)
+{
+    (void)p_params;
+
+    nrf24_sim* p_sim = new nrf24_sim (p_ser_port);
+    new nrf24_driver (p_ser_port, p_sim);
+    p_nrf24->initialize ();
+    CHECK (p_nrf24->readRegister (RF_CH) == NRF24_CHANNEL);
+    CHECK (p_nrf24->readRegister (FEATURE) == (1 << EN_DPL));
+
+    test_receive (p_sim);
+    test_overflow (p_sim);
+    test_refill (p_sim);
+    test_max_retry (p_sim);
+
+    *p_ser_port << *p_nrf24;
+    if (failures)
+    {
+        *p_ser_port << PMS ("FAILED with ") << failures << PMS (" failures") << endl;
+    }
+    else
+    {
+        *p_ser_port << PMS ("PASSED") << endl;
+    }
+    exit (failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/**
+ * @brief      Start the test task and the scheduler.
+ * @return     Nothing, as the test task ends the program
+ */
+int main (void)
+{
+    p_ser_port = new rs232 (9600, 1);
+    xTaskCreate (test_task, "Test", 1000, NULL, 1, NULL);
+    vTaskStartScheduler ();
+
+    return (0);
+}
@@ -74,7 +74,7 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
-#include <avr/io.h>
+#include <avr/io.h>                         // On a PC host, see lib/posix/avr/io.h
 
 /*-----------------------------------------------------------
  * Application specific definitions.
@@ -122,14 +122,36 @@
 /** This define is set to compile some extra code that helps keep track of memory and
  *  processor usage in tasks. It does not check for state transitions in tasks. Since
  *  tracing takes up memory and processor time, it should only be used for debugging.
+ *  When the program is compiled to run on a PC (see lib/posix), there's memory and
+ *  time to spare, so tracing is turned on there.
  */
-#define configUSE_TRACE_FACILITY        0
+#ifdef __AVR
+	#define configUSE_TRACE_FACILITY    0
+#else
+	#define configUSE_TRACE_FACILITY    1
+#endif
 
 /** This define causes task run times to be measured by the RTOS profiler. This is a
  *  useful debugging feature, but it takes up memory and processor time, so it should
- *  only be used when debugging the performance of a program.
+ *  only be used when debugging the performance of a program. On a PC host, the run
+ *  times are printed when the program finishes so that each task's share of the CPU
+ *  can be checked. 
  */
-#define configGENERATE_RUN_TIME_STATS   0
+#ifdef __AVR
+	#define configGENERATE_RUN_TIME_STATS 0
+#else
+	#define configGENERATE_RUN_TIME_STATS 1
+#endif
+
+/** This define turns on tickless idle mode, in which the tick interrupt is stopped
+ *  while all the tasks are blocked. We only use it on a PC host, where it lets the
+ *  program skip over idle time so that simulations run faster than real time. 
+ */
+#ifdef __AVR
+	#define configUSE_TICKLESS_IDLE     0
+#else
+	#define configUSE_TICKLESS_IDLE     1
+#endif
 
 /** This define sets the maximum number of task priorities available for use. More
  *  memory is used if a higher number of priorities is set, so you should not make
@@ -155,7 +177,12 @@
  *  bytes, which seems strange because the data sheets say is only has 2K of SRAM. 
  *  This formula is intended to be altered by the user for different configurations.
  */
-#define configTOTAL_HEAP_SIZE           (1024 + ((((uint32_t)RAMEND - 2143) * 3) / 4 ))
+#ifdef __AVR
+	#define configTOTAL_HEAP_SIZE       (1024 + ((((uint32_t)RAMEND - 2143) * 3) / 4 ))
+#else
+	// On a PC each stack item is 8 bytes wide rather than 1, so the heap is bigger
+	#define configTOTAL_HEAP_SIZE       ((size_t)(512 * 1024))
+#endif
 
 /** This define sets the maximum length of task names, plus one byte for the '\0'
  *  which signifies the end of the string. When set to 8, it allows 7-letter names.
@@ -200,9 +227,14 @@
 #define configUSE_MUTEXES               1
 
 /** The RAM pointer size on an AVR processor is 16 bits; set it here to shut up a dumb
- *  compiler warning that comes out in tasks.c if the default 32 bits is used. 
+ *  compiler warning that comes out in tasks.c if the default 32 bits is used. On a PC
+ *  host, a pointer is the same size as a \c size_t. 
  */
-#define portPOINTER_SIZE_TYPE           uint16_t
+#ifdef __AVR
+	#define portPOINTER_SIZE_TYPE       uint16_t
+#else
+	#define portPOINTER_SIZE_TYPE       size_t
+#endif
 
 /** This define is set to 1 in order to allow the use of co-routines, which are a sort
  *  of cooperatively multitasked set of tasks.
@@ -222,12 +254,13 @@
 #define INCLUDE_uxTaskPriorityGet                1
 #define INCLUDE_vTaskDelete                      0
 #define INCLUDE_vTaskCleanUpResources            0
-#define INCLUDE_vTaskSuspend                     0
+#define INCLUDE_vTaskSuspend                     configUSE_TICKLESS_IDLE
 #define INCLUDE_vTaskDelayUntil                  1
 #define INCLUDE_vTaskDelay                       1
 #define INCLUDE_pcTaskGetTaskName                1
 #define INCLUDE_uxTaskGetStackHighWaterMark      1
 #define INCLUDE_xTaskGetIdleTaskHandle           1
+#define INCLUDE_xTaskGetSchedulerState           1
 
 
 // //-------------------------------------------------------------------------------------
@@ -258,7 +291,8 @@
 //-------------------------------------------------------------------------------------
 /** This macro sets up the timer/counter to measure the run time of tasks. However, if
  *  using the ME405/507 code, no setup is needed, as the hardware timer which runs the
- *  RTOS scheduler tick is used. Therefore, this function does nothing. 
+ *  RTOS scheduler tick is used. Therefore, this function does nothing. On a PC host,
+ *  the port measures run time in microseconds with the computer's monotonic clock. 
  */
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
 
@@ -270,7 +304,13 @@
 #define portGET_RUN_TIME_COUNTER_VALUE()  func_get_run_time_counter ()
 
 // Here's the header for the function which returns the run-time counter value
+#ifdef __cplusplus
+extern "C" {
+#endif
 uint32_t func_get_run_time_counter (void);
+#ifdef __cplusplus
+}
+#endif
 
 
 
@@ -88,6 +88,11 @@ include path. */
 	#include "portmacro.h"
 #endif
 
+/* ME405 programs compiled to run on a PC use the port in lib/posix. */
+#ifdef POSIX_HOST
+	#include "../posix/portmacro.h"
+#endif
+
 #ifdef IAR_MEGA_AVR
 	#include "../portable/IAR/ATMega323/portmacro.h"
 #endif
@@ -0,0 +1,282 @@
+//*************************************************************************************
+/** @file    snapshotshare.h
+ *  @brief   Shared data items which hold a whole set of related values together.
+ *  @details This file contains a template class for a group of data items, usually
+ *           a @c struct, which is shared between tasks. All the items are written
+ *           at once, so a task which reads them always gets a matching set, never a
+ *           mix of values from two different measurements.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file, based on @c TaskShare
+ *
+ *  License:
+ *		This file is copyright 2026 by its authors and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _SNAPSHOTSHARE_H_
+#define _SNAPSHOTSHARE_H_
+
+#include <string.h>                         // C language string handling functions
+#include <avr/cpufunc.h>                    // For the compiler memory barrier
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "baseshare.h"                      // Base class for shared data items
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Class for a set of related data items shared as one snapshot.
+ *  @details This class shares a group of values, such as all the angles measured by
+ *           one reading of a sensor, between tasks. The values are kept together in
+ *           a plain @c struct which is given as the template parameter. A producer
+ *           task writes the whole @c struct with one call to @c put(), and consumers
+ *           read the whole @c struct with @c get(), so a consumer can never see the
+ *           heading from one measurement with the roll from another, as could happen
+ *           if each value had its own @c TaskShare.
+ *
+ *           Writing is done in a critical section, just as with a @c TaskShare.
+ *           Reading uses a sequence counter in the same way as @c ShareData does:
+ *           the counter is incremented by each write, and a reader which sees it
+ *           change while the data was being copied copies the data again. Reading
+ *           a snapshot therefore never disables interrupts.
+ *
+ *           Each snapshot also has a 16-bit version number which counts the writes.
+ *           A consumer which runs more often than the producer can keep the version
+ *           of the last snapshot it read and call @c get_if_changed(), which only
+ *           copies the data if a new snapshot has been written since.
+ *
+ *           Usage example, in which @c imu_sample is a @c struct:
+ *           @code
+ *           SnapshotShare<imu_sample>* imu_snapshot;      // In main.cpp
+ *           imu_snapshot = new SnapshotShare<imu_sample> ("IMU Snapshot");
+ *           ...
+ *           imu_sample sample;                            // In the producer
+ *           sample.heading = ...;
+ *           imu_snapshot->put (sample);
+ *           ...
+ *           uint16_t last_version = 0;                    // In a consumer
+ *           if (imu_snapshot->get_if_changed (sample, last_version))
+ *           {
+ *               ...use sample.heading, sample.roll, etc...
+ *           }
+ *           @endcode
+ */
+
+template <class DataType> class SnapshotShare : public BaseShare
+{
+	protected:
+		DataType the_data;					///< Holds the most recent snapshot
+
+		/// This counter is incremented each time the data is written
+		volatile uint8_t sequence;
+
+		/// This number counts the snapshots which have been written
+		uint16_t version;
+
+	public:
+		/** @brief   Construct a snapshot share.
+		 *  @details The data in the share is @b not initialized, and its version
+		 *           number begins at zero; the first snapshot written has version 1.
+		 *  @param   p_name A name to be shown in the list of task shares
+		 */
+		SnapshotShare<DataType> (const char* p_name) : BaseShare (p_name)
+		{
+			sequence = 0;
+			version = 0;
+		}
+
+		// Write a new snapshot into the share
+		void put (const DataType& new_data);
+
+		// Read the most recent snapshot from the share
+		DataType get (void);
+
+		// Read the most recent snapshot only if it's newer than the one last read
+		bool get_if_changed (DataType& copy, uint16_t& last_version);
+
+		// Get the version number of the most recent snapshot
+		uint16_t get_version (void);
+
+		/** @brief   Write a new snapshot into the share from within an ISR.
+		 *  @details This method must only be called from within an interrupt service
+		 *           routine or a critical section, not a normal task.
+		 *  @param   new_data The data which is to be written into the share
+		 */
+		void ISR_put (const DataType& new_data)
+		{
+			the_data = new_data;
+			version++;
+			_MemoryBarrier ();
+			sequence++;
+		}
+
+		/** @brief   Read the most recent snapshot from within an ISR.
+		 *  @details Because tasks write the data in critical sections, an ISR can't
+		 *           interrupt a write, so the data can be copied directly. This method
+		 *           must only be called from within an interrupt service routine.
+		 *  @return  A copy of the most recent snapshot
+		 */
+		DataType ISR_get (void)
+		{
+			return (the_data);
+		}
+
+		// Print the share's status within a list of all shares' statuses
+		void print_in_list (emstream* p_ser_dev);
+}; // class SnapshotShare<DataType>
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Write a new snapshot into the share.
+ *  @details This method copies a whole set of data into the share in a critical
+ *           section and increments the version number.
+ *  @param   new_data The data which is to be written into the share
+ */
+
+template <class DataType>
+inline void SnapshotShare<DataType>::put (const DataType& new_data)
+{
+	portENTER_CRITICAL ();
+	ISR_put (new_data);
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Read the most recent snapshot from the share.
+ *  @details This method copies the data without disabling interrupts. If the data is
+ *           written while it's being copied, the copy is made again.
+ *  @return  A copy of the most recent snapshot
+ */
+
+template <class DataType>
+DataType SnapshotShare<DataType>::get (void)
+{
+	DataType temporary_copy;				// Copy of the data which will be returned
+	uint8_t sequence_before;				// Sequence count from before the copy
+
+	do
+	{
+		sequence_before = sequence;
+		_MemoryBarrier ();
+		temporary_copy = the_data;
+		_MemoryBarrier ();
+	}
+	while (sequence_before != sequence);
+
+	return (temporary_copy);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Read the most recent snapshot only if it's newer than the one last read.
+ *  @details This method compares the version number of the snapshot in the share
+ *           with the version number of the one which was read last time. If they're
+ *           the same, nothing has changed and no copy is made. Otherwise the data and
+ *           the new version number are copied.
+ *  @param   copy A reference to the place where the data is to be copied
+ *  @param   last_version The version number of the snapshot which was read last
+ *           time, kept by the caller; it's updated when a new snapshot is read. To
+ *           get the first snapshot, start with a value of zero
+ *  @return  @c true if a new snapshot was copied and @c false if nothing's changed
+ */
+
+template <class DataType>
+bool SnapshotShare<DataType>::get_if_changed (DataType& copy, uint16_t& last_version)
+{
+	uint8_t sequence_before;				// Sequence count from before the copy
+	uint16_t current_version;				// Version of the snapshot in the share
+
+	do
+	{
+		sequence_before = sequence;
+		_MemoryBarrier ();
+		current_version = version;
+		if (current_version != last_version)
+		{
+			copy = the_data;
+		}
+		_MemoryBarrier ();
+	}
+	while (sequence_before != sequence);
+
+	if (current_version == last_version)
+	{
+		return (false);
+	}
+	last_version = current_version;
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Get the version number of the most recent snapshot.
+ *  @details The version number is incremented each time a snapshot is written, so a
+ *           task can find out whether there's new data without copying the data.
+ *  @return  The version number of the snapshot currently in the share
+ */
+
+template <class DataType>
+uint16_t SnapshotShare<DataType>::get_version (void)
+{
+	uint8_t sequence_before;				// Sequence count from before the copy
+	uint16_t current_version;				// Version of the snapshot in the share
+
+	do
+	{
+		sequence_before = sequence;
+		_MemoryBarrier ();
+		current_version = version;
+		_MemoryBarrier ();
+	}
+	while (sequence_before != sequence);
+
+	return (current_version);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the share's status within a list of all shares' statuses.
+ *  @details This method prints the name and type of the share and the version number
+ *           of the most recent snapshot. It then asks the next share in the linked
+ *           list of shares to print its status.
+ *  @param   p_ser_dev Pointer to a serial device on which to print the status
+ */
+
+template <class DataType>
+void SnapshotShare<DataType>::print_in_list (emstream* p_ser_dev)
+{
+	// Print this task's name and pad it to 16 characters
+	*p_ser_dev << name;
+	for (uint8_t cols = strlen (name); cols < 16; cols++)
+	{
+		p_ser_dev->putchar (' ');
+	}
+
+	p_ser_dev->puts ("snapshot\t");
+
+	// Print the number of snapshots which have been written
+	*p_ser_dev << get_version ();
+
+	// End the line
+	*p_ser_dev << endl;
+
+	// Call the next item
+	if (p_next != NULL)
+	{
+		p_next->print_in_list (p_ser_dev);
+	}
+}
+
+#endif  // _SNAPSHOTSHARE_H_
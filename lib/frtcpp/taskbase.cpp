@@ -109,8 +109,11 @@ TaskBase::TaskBase (const char* a_name, unsigned portBASE_TYPE a_priority,
 	// If stack tracing is being used, save the address of the top of the stack
 	top_of_stack = ++portStackTopForTask;
 
-	// Initialize the run counter
+	// Initialize the run counter and the overrun statistics
 	runs = 0;
+	on_overrun_do = OVERRUN_RUN_NOW;
+	overruns = 0;
+	max_overrun_ticks = 0;
 
 	// If the serial port is being used, let the user know if the task was created
 	// successfully
@@ -207,6 +210,53 @@ void TaskBase::transition_to (uint8_t new_state)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Count an overrun and deal with it according to the overrun policy.
+ *  @details This method is called by @c delay_from_for() when the task finds that the
+ *           time at which it should next wake up, @c from_ticks + @c for_how_long, 
+ *           has already come. The overrun is counted and the largest overrun kept. 
+ *           Then, if the policy is @c OVERRUN_SKIP, @c from_ticks is moved forward 
+ *           by whole periods so that the task will wake at the next period boundary
+ *           which is still in the future; if it's @c OVERRUN_CALL_HOOK, the task's 
+ *           @c on_overrun() method is called. 
+ *  @param   from_ticks The time from which the delay is being measured; it may be
+ *                      moved forward if missed runs are being skipped
+ *  @param   for_how_long The period of the task in RTOS ticks
+ */
+
+void TaskBase::handle_overrun (TickType_t& from_ticks, TickType_t for_how_long)
+{
+	TickType_t late_ticks = (TickType_t)(xTaskGetTickCount () - from_ticks) 
+							- for_how_long;
+
+	if (overruns < 0xFFFF)
+	{
+		overruns++;
+	}
+	if (late_ticks > max_overrun_ticks)
+	{
+		max_overrun_ticks = late_ticks;
+	}
+
+	switch (on_overrun_do)
+	{
+		case (OVERRUN_SKIP):
+			if (for_how_long > 0)
+			{
+				from_ticks += (late_ticks / for_how_long + 1) * for_how_long;
+			}
+			break;
+
+		case (OVERRUN_CALL_HOOK):
+			on_overrun (late_ticks);
+			break;
+
+		default:
+			break;
+	};
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Print an error message if possible and reset the processor.
  *  @details This method prints an error message (if there is a valid serial device 
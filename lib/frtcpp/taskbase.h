@@ -11,6 +11,8 @@
  *    \li 08-25-2012 JRR Modified to run with STM32's as well as AVR's
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
  *    \li 09-03-2014 JRR Minor upgrades; renamed method to @c delay_from_for()
+ *    \li 10-16-2026 ERR Added optional profiling of run time and lateness of each run
+ *    \li 10-16-2026 ERR Added counting of overruns and a policy for handling them
  *
  *  Credits:
  *      Much of this code uses techniques learned from Amigo software, which is 
@@ -49,6 +51,10 @@
 #include "mechutil.h"                       // Utility functions for the ME405 code
 #include "emstream.h"                       // Pull in the base class header file
 
+#ifdef TASK_PROFILE
+	#include "taskprofile.h"                // Measures how long each run takes
+#endif
+
 
 /* The forward declaration is needed so we can make last_created_task_pointer usable
  * from anywhere in this file. It would be nicer if this variable could be a static
@@ -70,6 +76,18 @@ extern TaskBase* last_created_task_pointer;
                 ((tskIDLE_PRIORITY) + (x)) : (configMAX_PRIORITIES))
 
 
+/** This enumeration holds the things a task can do when it has overrun, that is, when
+ *  a run through its loop took so long that the time at which it should next wake up
+ *  has already passed by the time it calls @c delay_from_for(). 
+ */
+enum overrun_policy
+{
+	OVERRUN_RUN_NOW,            ///< Start the next run at once, catching up as needed
+	OVERRUN_SKIP,               ///< Skip the missed runs and wait for the next period
+	OVERRUN_CALL_HOOK           ///< Call @c on_overrun(), then start the next run
+};
+
+
 /// @cond NO_DOXY 
 //-------------------------------------------------------------------------------------
 // If the AVR has 256KB flash, it uses a 3-byte program counter and the task function
@@ -270,6 +288,41 @@ class TaskBase
 		 */
 		uint32_t runs;
 
+		/// This is what the task does when it finds that it has overrun its period
+		overrun_policy on_overrun_do;
+
+		/// This counts how many times the task has overrun its period
+		uint16_t overruns;
+
+		/// This is the largest number of RTOS ticks by which the task has overrun
+		TickType_t max_overrun_ticks;
+
+		// Count an overrun and deal with it according to the overrun policy
+		void handle_overrun (TickType_t& from_ticks, TickType_t for_how_long);
+
+		/** @brief   Method which is called when a task has overrun its period.
+		 *  @details If a task's overrun policy is @c OVERRUN_CALL_HOOK, this method is
+		 *           called by @c delay_from_for() each time the task finds that it
+		 *           has overrun, just before the next run begins. The base method 
+		 *           does nothing; a task can override it to, for example, put its 
+		 *           outputs into a safe state or reset a filter which depends on a
+		 *           regular sample time. 
+		 *  @param   late_ticks The number of RTOS ticks by which the deadline was 
+		 *                      missed; zero means the run ended right at the deadline
+		 */
+		virtual void on_overrun (TickType_t late_ticks)
+		{
+			(void)late_ticks;
+		}
+
+		#ifdef TASK_PROFILE
+			/** If profiling is enabled, this object keeps statistics about how long
+			 *  each run of the task takes and how late the task wakes up. It's 
+			 *  updated by @c delay_from_for() and @c delay_from_for_ms(). 
+			 */
+			TaskProfile profile;
+		#endif
+
 		/** This method allows descendent classes to find out how many times the
 		 *  @c loop() method has run.
 		 *  @return The number of times the loop has been run
@@ -398,6 +451,11 @@ class TaskBase
 		 *           action, like a clown waking up to terrify children. Because the
 		 *           time at which each awakening takes place is recorded, this method
 		 *           won't accumulate errors as it is repeatedly invoked. 
+		 *
+		 *           If the task's run took so long that the time at which it should
+		 *           next wake up has already passed, the task has overrun. The 
+		 *           overrun is counted and then dealt with according to the policy
+		 *           set by @c set_overrun_policy(). 
 		 *  @param   from_ticks The beginning time of the duration to delay. It is
 		 *                      usually set equal to the time at which the previous
 		 *                      delay began so as to get precise, regular timing
@@ -405,7 +463,17 @@ class TaskBase
 		 */
 		void delay_from_for (TickType_t& from_ticks, TickType_t for_how_long)
 		{
+			#ifdef TASK_PROFILE
+				profile.end_run ();
+			#endif
+			if ((TickType_t)(xTaskGetTickCount () - from_ticks) >= for_how_long)
+			{
+				handle_overrun (from_ticks, for_how_long);
+			}
 			vTaskDelayUntil (&from_ticks, for_how_long);
+			#ifdef TASK_PROFILE
+				profile.start_run (from_ticks);
+			#endif
 		}
 
 		/** @brief   Stop the task from running for a precise number of milliseconds.
@@ -442,7 +510,7 @@ class TaskBase
         void delay_from_for_ms (TickType_t& from_ticks, TickType_t millisec)
         {
             TickType_t ticks = ((uint32_t)millisec * configTICK_RATE_HZ) / 1000UL;
-            vTaskDelayUntil (&from_ticks, ticks);
+            delay_from_for (from_ticks, ticks);
         }
 
 		/** @brief   Find out how many RTOS ticks since the scheduler was started.
@@ -614,6 +682,59 @@ class TaskBase
 		// Print the status of this task
 		virtual void print_status (emstream&);
 
+		/** @brief   Set what the task does when it overruns its period.
+		 *  @details The default policy, @c OVERRUN_RUN_NOW, is what FreeRTOS has 
+		 *           always done: the next run starts at once, and if several periods
+		 *           were missed, the task runs repeatedly without delay until it has
+		 *           caught up. @c OVERRUN_SKIP throws away the missed runs and waits
+		 *           for the next period to begin on schedule, which suits tasks such
+		 *           as sensor readers for which old readings are useless. 
+		 *           @c OVERRUN_CALL_HOOK calls the task's @c on_overrun() method and
+		 *           then starts the next run at once.
+		 *  @param   new_policy The new overrun policy
+		 */
+		void set_overrun_policy (overrun_policy new_policy)
+		{
+			on_overrun_do = new_policy;
+		}
+
+		/** @brief   Get the number of times this task has overrun its period.
+		 *  @return  The number of overruns, which stops counting at 65535
+		 */
+		uint16_t get_overruns (void)
+		{
+			return (overruns);
+		}
+
+		/** @brief   Get the largest number of ticks by which this task has overrun.
+		 *  @return  The largest overrun, in RTOS ticks past the missed deadline
+		 */
+		TickType_t get_max_overrun (void)
+		{
+			return (max_overrun_ticks);
+		}
+
+		// This method prints the task's overrun count, then asks the next task in the
+		// list to do so
+		void print_overruns_in_list (emstream*);
+
+		#ifdef TASK_PROFILE
+			/** @brief   Return a pointer to this task's timing statistics.
+			 *  @details This method is only available if @c TASK_PROFILE is defined.
+			 *           The statistics can be printed, or cleared so that a new set
+			 *           of measurements can be made.
+			 *  @return  A pointer to the task's profile
+			 */
+			TaskProfile* get_profile (void)
+			{
+				return (&profile);
+			}
+
+			// This method prints the task's run time histogram, then asks the next
+			// task in the list to do so
+			void print_profile_in_list (emstream*);
+		#endif
+
 		// Print an error message and reset the processor in an extreme emergency
 		void emergency_reset (const char* message);
 
@@ -631,6 +752,14 @@ void print_task_list (emstream* ser_dev);
 // This function has all the tasks print their stacks
 void print_task_stacks (emstream* ser_dev);
 
+// This function prints how many times each task has overrun its period
+void print_task_overruns (emstream* ser_dev);
+
+#ifdef TASK_PROFILE
+	// This function prints a histogram of run times for all the tasks
+	void print_task_profiles (emstream* ser_dev);
+#endif
+
 // Get time from the RTOS tick count, converted to seconds
 float get_tick_time_float (void);
 
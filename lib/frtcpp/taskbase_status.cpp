@@ -8,6 +8,8 @@
  *    \li 12-02-2012 JRR Split off from time_stamp.cpp to save memory in machine file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
  *    \li 01-04-2015 JRR Moved items around for more efficient use of screen space
+ *    \li 10-16-2026 ERR Run time and lateness shown for each task if profiling is on
+ *    \li 10-16-2026 ERR Added a list of the overruns of each task
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -39,6 +41,13 @@ void TaskBase::print_status_in_list (emstream* ser_device)
 {
 	*ser_device << *this << endl;
 
+	// If profiling is enabled, show run times and lateness on a line of their own
+	#ifdef TASK_PROFILE
+		*ser_device << PMS ("\t\t");
+		profile.print_summary (ser_device);
+		*ser_device << endl;
+	#endif
+
 	if (prev_task_pointer != NULL)
 	{
 		prev_task_pointer->print_status_in_list (ser_device);
@@ -141,3 +150,111 @@ void print_task_list (emstream* ser_dev)
 			<< endl;
 }
 
+
+//-------------------------------------------------------------------------------------
+/** This method prints the number of times this task has overrun its period and the 
+ *  largest overrun, then asks the next task in the list of tasks to do so. 
+ *  @param ser_device The serial device to which each task prints its overruns
+ */
+
+void TaskBase::print_overruns_in_list (emstream* ser_device)
+{
+	ser_device->puts (pcTaskGetTaskName (handle));
+	ser_device->putchar ('\t');
+	if (strlen ((const char*)(pcTaskGetTaskName (handle))) < 8)
+	{
+		ser_device->putchar ('\t');
+	}
+	switch (on_overrun_do)
+	{
+		case (OVERRUN_SKIP):
+			*ser_device << PMS ("skip");
+			break;
+		case (OVERRUN_CALL_HOOK):
+			*ser_device << PMS ("hook");
+			break;
+		default:
+			*ser_device << PMS ("run now");
+			break;
+	};
+	*ser_device << '\t' << overruns << '\t' << max_overrun_ticks << endl;
+
+	if (prev_task_pointer != NULL)
+	{
+		prev_task_pointer->print_overruns_in_list (ser_device);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints, for each task, what the task does when it overruns its 
+ *  period, how many times it has overrun, and the largest overrun in RTOS ticks. A
+ *  task which overruns is missing its real-time deadlines. Only tasks which use 
+ *  \c delay_from_for() or \c delay_from_for_ms() have periods which can be overrun.
+ *  @param ser_dev Pointer to a serial device on which the overruns will be printed
+ */
+
+void print_task_overruns (emstream* ser_dev)
+{
+	*ser_dev << PMS ("Task\t\tPolicy\tOverruns\tMax ticks late") << endl
+			 << PMS ("----\t\t------\t--------\t--------------") << endl;
+
+	if (last_created_task_pointer != NULL)
+	{
+		last_created_task_pointer->print_overruns_in_list (ser_dev);
+	}
+}
+
+
+#ifdef TASK_PROFILE
+//-------------------------------------------------------------------------------------
+/** This method prints the histogram of this task's run times, then asks the next task
+ *  in the list of tasks to do so. 
+ *  @param ser_device The serial device to which each task prints its histogram
+ */
+
+void TaskBase::print_profile_in_list (emstream* ser_device)
+{
+	ser_device->puts (pcTaskGetTaskName (handle));
+	ser_device->putchar ('\t');
+	if (strlen ((const char*)(pcTaskGetTaskName (handle))) < 8)
+	{
+		ser_device->putchar ('\t');
+	}
+	profile.print_histogram (ser_device);
+	*ser_device << endl;
+
+	if (prev_task_pointer != NULL)
+	{
+		prev_task_pointer->print_profile_in_list (ser_device);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints a histogram of the run times of all the tasks, one line for
+ *  each task. The heading of each column is the upper limit, in microseconds, of the
+ *  run times counted in that column; the last column counts all longer runs. Only 
+ *  runs which end in a call to \c delay_from_for() or \c delay_from_for_ms() are 
+ *  measured, so tasks which only use \c delay() show all zeros. 
+ *  @param ser_dev Pointer to a serial device on which the histograms will be printed
+ */
+
+void print_task_profiles (emstream* ser_dev)
+{
+	// Print the headings, which are the limits of the bins
+	*ser_dev << PMS ("Run time, us:");
+	uint32_t limit = PROFILE_FIRST_BIN_US;
+	for (uint8_t index = 0; index < PROFILE_BINS - 1; index++)
+	{
+		*ser_dev << PMS ("\t<") << limit;
+		limit <<= 1;
+	}
+	*ser_dev << PMS ("\tmore") << endl;
+
+	if (last_created_task_pointer != NULL)
+	{
+		last_created_task_pointer->print_profile_in_list (ser_dev);
+	}
+}
+#endif // TASK_PROFILE
@@ -0,0 +1,220 @@
+//*************************************************************************************
+/** @file    taskprofile.cpp
+ *  @brief   Source code for a class which measures how long each run of a task takes.
+ *  @details This file contains the methods of classes @c ProfileStat and
+ *           @c TaskProfile, which keep statistics about the timing of periodically
+ *           running tasks. Nothing in this file is compiled unless the macro
+ *           @c TASK_PROFILE is defined in the Makefile.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *    \li 10-16-2026 ERR Changed to measure times with raw hardware timer counts
+ *
+ *  License:
+ *		This file is copyright 2026 by its authors and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#ifdef TASK_PROFILE
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS tasks
+#include "taskprofile.h"                    // Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Construct a set of statistics with no measurements in it.
+ */
+
+ProfileStat::ProfileStat (void)
+{
+	clear ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Throw away all the measurements.
+ */
+
+void ProfileStat::clear (void)
+{
+	minimum = 0xFFFFFFFFUL;
+	maximum = 0;
+	sum = 0;
+	count = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Include one more time measurement in the statistics.
+ *  @param   time_us The time which was measured, in microseconds
+ */
+
+void ProfileStat::add (uint32_t time_us)
+{
+	if (time_us < minimum)
+	{
+		minimum = time_us;
+	}
+	if (time_us > maximum)
+	{
+		maximum = time_us;
+	}
+
+	// Keep the sum from overflowing by halving it and the count, which leaves the
+	// mean the same
+	if (sum > 0xFFFFFFFFUL - time_us)
+	{
+		sum /= 2;
+		count /= 2;
+	}
+	sum += time_us;
+	count++;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the minimum, mean and maximum times.
+ *  @details The times are printed in microseconds as "min/mean/max".
+ *  @param   p_ser_dev Pointer to a serial device on which to print the times
+ */
+
+void ProfileStat::print (emstream* p_ser_dev)
+{
+	*p_ser_dev << get_min () << '/' << get_mean () << '/' << get_max ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Construct a profile with no measurements in it.
+ */
+
+TaskProfile::TaskProfile (void)
+{
+	clear ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Throw away all the measurements.
+ *  @details This method can be called to begin a new set of measurements, for example
+ *           after startup is finished and a task has settled into its normal work.
+ */
+
+void TaskProfile::clear (void)
+{
+	running = false;
+	run_time.clear ();
+	lateness.clear ();
+	for (uint8_t index = 0; index < PROFILE_BINS; index++)
+	{
+		histogram[index] = 0;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Record that the task has woken up at the end of a delay.
+ *  @details This method is called by @c TaskBase::delay_from_for() just after the
+ *           task wakes up. The time at which the task should have woken up is the
+ *           beginning of the RTOS tick given, so the difference between that time
+ *           and now is how late the task is. Raw hardware timer counts are used
+ *           because subtracting them is much quicker than subtracting time stamps.
+ *  @param   wake_ticks The RTOS tick count at which the task was to wake up
+ */
+
+void TaskProfile::start_run (TickType_t wake_ticks)
+{
+	run_start = get_raw_time ();
+
+	// If the task somehow woke up before its tick began, the difference is negative;
+	// it's cast to a signed number so that case is counted as on time
+	int32_t late_counts = (int32_t)(run_start - (uint32_t)wake_ticks * TMR_MAX_CT);
+	lateness.add (late_counts > 0 ? raw_time_to_us ((uint32_t)late_counts) : 0);
+
+	running = true;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Record that the task has finished a run and is about to go to sleep.
+ *  @details This method is called by @c TaskBase::delay_from_for() just before the
+ *           task goes to sleep. The run time is measured from the time at which the
+ *           task woke up; the first time a task goes to sleep, there's no wake-up time
+ *           yet, so nothing is measured.
+ */
+
+void TaskProfile::end_run (void)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	uint32_t duration = raw_time_to_us (get_raw_time () - run_start);
+	run_time.add (duration);
+
+	// Find the bin; each one is twice as wide as the one before it
+	uint8_t bin = 0;
+	for (uint32_t limit = PROFILE_FIRST_BIN_US; duration >= limit && bin < PROFILE_BINS - 1;
+		 limit <<= 1)
+	{
+		bin++;
+	}
+	if (histogram[bin] < 0xFFFF)
+	{
+		histogram[bin]++;
+	}
+
+	running = false;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the run time and lateness statistics on one line.
+ *  @details The statistics are printed as "min/mean/max" in microseconds, for example
+ *           "run 120/135/410 us, late 8/15/96 us". 
+ *  @param   p_ser_dev Pointer to a serial device on which to print the statistics
+ */
+
+void TaskProfile::print_summary (emstream* p_ser_dev)
+{
+	*p_ser_dev << PMS ("run ");
+	run_time.print (p_ser_dev);
+	*p_ser_dev << PMS (" us, late ");
+	lateness.print (p_ser_dev);
+	*p_ser_dev << PMS (" us");
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Print the histogram of run times on one line.
+ *  @details The number of runs in each bin is printed, separated by tabs, from the
+ *           shortest runs to the longest.
+ *  @param   p_ser_dev Pointer to a serial device on which to print the histogram
+ */
+
+void TaskProfile::print_histogram (emstream* p_ser_dev)
+{
+	for (uint8_t index = 0; index < PROFILE_BINS; index++)
+	{
+		*p_ser_dev << histogram[index];
+		if (index < PROFILE_BINS - 1)
+		{
+			p_ser_dev->putchar ('\t');
+		}
+	}
+}
+
+#endif // TASK_PROFILE
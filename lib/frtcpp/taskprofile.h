@@ -0,0 +1,162 @@
+//*************************************************************************************
+/** @file    taskprofile.h
+ *  @brief   Headers for a class which measures how long each run of a task takes.
+ *  @details This file contains a class which keeps statistics about the timing of a
+ *           task which runs periodically: how long each run through its loop takes
+ *           and how late it wakes up. Each @c TaskBase object has one of these if the
+ *           macro @c TASK_PROFILE is defined in the Makefile; if not, no profiling
+ *           code is compiled at all.
+ *
+ *  Revised:
+ *    \li 10-16-2026 ERR Original file
+ *    \li 10-16-2026 ERR Changed to measure times with raw hardware timer counts
+ *
+ *  License:
+ *		This file is copyright 2026 by its authors and released under the Lesser GNU
+ *		Public License, version 2. It intended for educational use only, but its use
+ *		is not limited thereto. */
+/*		THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *		AND	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *		IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *		ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *		LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *		TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *		OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *		CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _TASKPROFILE_H_
+#define _TASKPROFILE_H_
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "emstream.h"                       // Base for text-type serial port objects
+#include "time_stamp.h"                     // Header for timekeeping class
+
+
+/** This is the number of bins in the histogram of run times. The first bin counts runs
+ *  which took less than @c PROFILE_FIRST_BIN_US microseconds, and each bin after that
+ *  is twice as wide as the one before; the last bin counts all the longer runs.
+ */
+#define PROFILE_BINS			8
+
+/// This is the upper limit, in microseconds, of the first bin in the histogram
+#define PROFILE_FIRST_BIN_US	64
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Minimum, maximum and mean of a set of times in microseconds.
+ *  @details The mean is found from a running sum and count. If the sum gets close to
+ *           overflowing, the sum and count are both halved, so the mean keeps working
+ *           (and favors recent runs slightly) no matter how long the program runs.
+ */
+
+class ProfileStat
+{
+	protected:
+		uint32_t minimum;					///< The smallest time measured
+		uint32_t maximum;					///< The largest time measured
+		uint32_t sum;						///< Sum of the times, for finding the mean
+		uint32_t count;						///< Number of times included in the sum
+
+	public:
+		// Construct a set of statistics with no measurements in it
+		ProfileStat (void);
+
+		// Throw away all the measurements
+		void clear (void);
+
+		// Include one more time measurement in the statistics
+		void add (uint32_t time_us);
+
+		/** @brief   Get the smallest time which has been measured.
+		 *  @return  The minimum time in microseconds, or zero if there are no times
+		 */
+		uint32_t get_min (void)
+		{
+			return (count ? minimum : 0);
+		}
+
+		/** @brief   Get the largest time which has been measured.
+		 *  @return  The maximum time in microseconds
+		 */
+		uint32_t get_max (void)
+		{
+			return (maximum);
+		}
+
+		/** @brief   Get the mean of the times which have been measured.
+		 *  @return  The mean time in microseconds, or zero if there are no times
+		 */
+		uint32_t get_mean (void)
+		{
+			return (count ? sum / count : 0);
+		}
+
+		// Print the minimum, mean and maximum as "min/mean/max"
+		void print (emstream* p_ser_dev);
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Timing statistics for one periodically running task.
+ *  @details A task which runs at regular intervals calls @c TaskBase::delay_from_for()
+ *           or @c delay_from_for_ms() at the end of each run through its loop. When
+ *           profiling is enabled, those methods call @c end_run() before the task
+ *           goes to sleep and @c start_run() when it wakes up. Two things are
+ *           measured with @c get_raw_time(), at about microsecond resolution:
+ *           \li The run time, from when the task woke up until it next went to sleep.
+ *               This includes any time during which the task was preempted by tasks
+ *               or interrupts of higher priority, so it's how long the task took to
+ *               get its work done, not only how much of the CPU it used.
+ *           \li The lateness, from the RTOS tick at which the task asked to be woken
+ *               up until it actually started running. A task which is late often is
+ *               being held up by higher priority tasks; a task whose run time is
+ *               longer than its period will be late every time.
+ *
+ *           For each of these the minimum, mean and maximum are kept, and the run
+ *           times are also counted in a small histogram so that rare long runs can be
+ *           told apart from runs which are always slow.
+ */
+
+class TaskProfile
+{
+	protected:
+		/// The raw time at which the current run began, when the task woke up
+		uint32_t run_start;
+
+		/// This flag is set when @c run_start holds the start of a run in progress
+		bool running;
+
+		/// Statistics about how long each run took
+		ProfileStat run_time;
+
+		/// Statistics about how late the task woke up
+		ProfileStat lateness;
+
+		/// The histogram counts how many runs have taken each range of time
+		uint16_t histogram[PROFILE_BINS];
+
+	public:
+		// Construct a profile with no measurements in it
+		TaskProfile (void);
+
+		// Throw away all the measurements
+		void clear (void);
+
+		// Record that the task has woken up at the end of a delay until the given tick
+		void start_run (TickType_t wake_ticks);
+
+		// Record that the task has finished a run and is about to go to sleep
+		void end_run (void);
+
+		// Print the run time and lateness statistics on one line
+		void print_summary (emstream* p_ser_dev);
+
+		// Print the histogram of run times on one line
+		void print_histogram (emstream* p_ser_dev);
+};
+
+#endif  // _TASKPROFILE_H_
@@ -11,6 +11,9 @@
  *    \li 08-26-2014 JRR Changed file names, class name to @c TaskShare, removed unused
  *                       version that uses semaphores, renamed @c put() and @c get()
  *    \li 10-18-2014 JRR Added linked list of all shares for tracking and debugging
+ *    \li 10-16-2026 ERR Reads no longer use critical sections; one-byte data is
+ *                       accessed directly, and wider data through a sequence counter
+ *    \li 10-16-2026 ERR Added atomic read-modify-write methods such as @c fetch_add()
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -33,10 +36,198 @@
 #define _TASKSHARE_H_
 
 #include <string.h>                         // C language string handling functions
+#include <avr/cpufunc.h>                    // For the compiler memory barrier
 #include "FreeRTOS.h"                       // Main header for FreeRTOS
 #include "baseshare.h"                      // Base class for shared data items
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Tells whether a type is a one-byte number which can be used as volatile.
+ *  @details The value is @c false for every type except the ones for which it's
+ *           specialized below. A one-byte structure or class isn't on the list, as a
+ *           @c volatile one can't be copied by its ordinary assignment operator; it
+ *           gets the general version of @c ShareData instead.
+ */
+
+template <class DataType> struct share_is_byte
+{
+	static const bool value = false;		///< Not a plain one-byte number
+};
+
+/// A @c bool can be read or written by one machine instruction
+template <> struct share_is_byte<bool> { static const bool value = true; };
+
+/// A @c char can be read or written by one machine instruction
+template <> struct share_is_byte<char> { static const bool value = true; };
+
+/// A @c signed @c char, or @c int8_t, can be read or written by one instruction
+template <> struct share_is_byte<signed char> { static const bool value = true; };
+
+/// An @c unsigned @c char, or @c uint8_t, can be read or written by one instruction
+template <> struct share_is_byte<unsigned char> { static const bool value = true; };
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Storage for the data in a task share, read and written without locking.
+ *  @details This class holds the data for a @c TaskShare and contains the code which
+ *           reads and writes it. The version of the class which is used is chosen by
+ *           the compiler according to the type of the data. This general version is
+ *           used for data which isn't a one-byte number, such as a @c int16_t or a
+ *           structure, which can't be copied by one machine instruction, so a copy
+ *           might be interrupted partway through.
+ *
+ *           Writes are done inside a critical section, as they always have been, so
+ *           two writers can't interfere with each other. Reads don't disable
+ *           interrupts; instead, each write increments a sequence counter, and a read
+ *           which sees the counter change while it was copying the data knows that the
+ *           copy may be corrupted, so it copies the data again. Writes are rare and
+ *           quick compared to the time between them, so a read almost never has to be
+ *           repeated, and interrupts such as encoder ISRs are never held off by tasks
+ *           which only read shared data.
+ *
+ *           The sequence counter is one byte long so that it can be read atomically. A
+ *           read could therefore miss a corrupted copy if exactly 256 writes (or some
+ *           multiple thereof) happened while that read was interrupted; data which is
+ *           written that often by a higher priority task than the reader's shouldn't
+ *           be in a share anyway.
+ */
+
+template <class DataType, bool is_byte = share_is_byte<DataType>::value>
+class ShareData
+{
+	protected:
+		DataType the_data;					///< Holds the data to be shared
+
+		/// This counter is incremented each time the data is changed
+		volatile uint8_t sequence;
+
+	public:
+		/** @brief   Construct the storage for a shared data item.
+		 *  @details This constructor only sets the sequence counter. As has always
+		 *           been the case with shares, the data is @b not initialized.
+		 */
+		ShareData (void)
+		{
+			sequence = 0;
+		}
+
+		/** @brief   Read data from the shared data item.
+		 *  @details This method reads the data from a task without disabling
+		 *           interrupts. The sequence counter is read before and after the data
+		 *           is copied; if the two readings differ, the data was changed while
+		 *           it was being copied, so the copy is made again. The memory barriers
+		 *           make sure the compiler doesn't move the copy outside the two checks.
+		 *  @return  The current value of the shared data item
+		 */
+		DataType get (void)
+		{
+			DataType temporary_copy;		// Copy of the data which will be returned
+			uint8_t sequence_before;		// Sequence count from before the copy
+
+			do
+			{
+				sequence_before = sequence;
+				_MemoryBarrier ();
+				temporary_copy = the_data;
+				_MemoryBarrier ();
+			}
+			while (sequence_before != sequence);
+
+			return (temporary_copy);
+		}
+
+		/** @brief   Put data into the shared data item.
+		 *  @details This method writes data into the shared data item from a task. The
+		 *           write takes place in a critical section so that the data and the
+		 *           sequence counter are changed together, without any other task or
+		 *           ISR being able to see or change the data in between.
+		 *  @param   new_data The data which is to be written
+		 */
+		void put (DataType new_data)
+		{
+			portENTER_CRITICAL ();
+			ISR_put (new_data);
+			portEXIT_CRITICAL ();
+		}
+
+		/** @brief   Read data from the shared data item, from within an ISR.
+		 *  @details Because tasks write the data in critical sections, an ISR can't
+		 *           interrupt a write, so no checking of the sequence is needed. This
+		 *           method must only be called from within an interrupt service routine
+		 *           or a critical section, not a normal task.
+		 *  @return  The current value of the shared data item
+		 */
+		DataType ISR_get (void)
+		{
+			return (the_data);
+		}
+
+		/** @brief   Put data into the shared data item from within an ISR.
+		 *  @details This method writes the data and increments the sequence counter so
+		 *           that any task which was interrupted while reading the data will
+		 *           know to read it again. It must only be called from within an
+		 *           interrupt service routine or a critical section.
+		 *  @param   new_data The data which is to be written into the shared data item
+		 */
+		void ISR_put (DataType new_data)
+		{
+			the_data = new_data;
+			_MemoryBarrier ();
+			sequence++;
+		}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   Storage for the data in a task share which holds a single byte.
+ *  @details This version of the @c ShareData class is chosen by the compiler for data
+ *           which is a one-byte number, such as a @c bool, @c char or @c uint8_t. A
+ *           byte is read or written by one machine instruction, which can't be
+ *           interrupted, so no protection is needed; the data is just declared
+ *           @c volatile so that the compiler will actually read and write memory each
+ *           time. No sequence counter is kept for one-byte data.
+ */
+
+template <class DataType> class ShareData<DataType, true>
+{
+	protected:
+		volatile DataType the_data;			///< Holds the data to be shared
+
+	public:
+		/** @brief   Read data from the shared data item.
+		 *  @return  The current value of the shared data item
+		 */
+		DataType get (void)
+		{
+			return (the_data);
+		}
+
+		/** @brief   Put data into the shared data item.
+		 *  @param   new_data The data which is to be written
+		 */
+		void put (DataType new_data)
+		{
+			the_data = new_data;
+		}
+
+		/** @brief   Read data from the shared data item, from within an ISR.
+		 *  @return  The current value of the shared data item
+		 */
+		DataType ISR_get (void)
+		{
+			return (the_data);
+		}
+
+		/** @brief   Put data into the shared data item from within an ISR.
+		 *  @param   new_data The data which is to be written into the shared data item
+		 */
+		void ISR_put (DataType new_data)
+		{
+			the_data = new_data;
+		}
+};
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Class for data to be shared in a thread-safe manner between tasks.
  *  @details This class implements an item of data which can be shared between tasks
@@ -46,25 +237,32 @@
  *           Shares therefore do not provide the task synchronization or incur the 
  *           overhead associated with queues. 
  * 
- *           The data is protected by using critical code sections (see the FreeRTOS 
- *           documentation of @c portENTER_CRITICAL() ) so that tasks can't interrupt 
- *           each other when reading or writing the data is taking place. This prevents
- *           data corruption due to thread switching. The C++ template mechanism is 
- *           used to ensure that only data of the correct type is put into or taken 
- *           from a shared data item. A @c TaskShare<DataType> object keeps its own 
- *           separate copy of the data. This uses some memory, but it is necessary to 
- *           reliably prevent data corruption; it prevents possible side effects from 
- *           causing the sender's copy of the data from being inadvertently changed. 
+ *           The data is kept in a @c ShareData object, the version of which is chosen
+ *           at compile time by the type of the data. A one-byte number is read and
+ *           written directly, as this can't be interrupted. Other data is written in
+ *           critical code sections (see the FreeRTOS documentation of
+ *           @c portENTER_CRITICAL() ) and read with a sequence counter which detects
+ *           whether a write happened during the read, so reading a share never holds
+ *           off interrupts. This prevents data corruption due to thread switching. The
+ *           C++ template mechanism is used to ensure that only data of the correct type
+ *           is put into or taken from a shared data item. A @c TaskShare<DataType>
+ *           object keeps its own separate copy of the data. This uses some memory, but
+ *           it is necessary to reliably prevent data corruption; it prevents possible
+ *           side effects from causing the sender's copy of the data from being
+ *           inadvertently changed.
+ *
+ *           The methods @c put(), @c get(), @c ISR_put() and @c ISR_get() are
+ *           inherited from @c ShareData. Data which is changed by more than one task
+ *           or ISR, such as a counter, should be changed with @c fetch_add(),
+ *           @c fetch_sub(), @c exchange() or @c compare_exchange() (or their ISR
+ *           versions), which read, change and write the data as one operation.
  * 
  *           TODO: Provide a usage example. For now, see examples of usage in example
  *                 code. 
  */
 
-template <class DataType> class TaskShare : public BaseShare
+template <class DataType> class TaskShare : public BaseShare, public ShareData<DataType>
 {
-	protected:
-		DataType the_data;					///< Holds the data to be shared
-
 	public:
 		/** @brief   Construct a shared data item.
 		 *  @details This default constructor for a shared data item doesn't do much
@@ -77,20 +275,84 @@ template <class DataType> class TaskShare : public BaseShare
 		{
 		}
 
-		// This method is used to write data into the shared data item
-		void put (DataType);
+		// Print the share's status within a list of all shares' statuses (statae?)
+		void print_in_list (emstream* p_ser_dev);
 
-		// This method is used to write data from within an ISR only
-		void ISR_put (DataType);
+		// Atomically add to the data, returning the value it had before
+		DataType fetch_add (DataType addend);
 
-		// This method is used to read data from the shared data item
-		DataType get (void);
+		// Atomically subtract from the data, returning the value it had before
+		DataType fetch_sub (DataType subtrahend);
 
-		// This method is used to read data from within an ISR only
-		DataType ISR_get (void);
+		// Atomically replace the data, returning the value it had before
+		DataType exchange (DataType new_data);
 
-		// Print the share's status within a list of all shares' statuses (statae?)
-		void print_in_list (emstream* p_ser_dev);
+		// Replace the data only if it holds an expected value
+		bool compare_exchange (DataType& expected, DataType new_data);
+
+		/** @brief   Add to the data from within an ISR.
+		 *  @details This method adds a number to the shared data and returns the
+		 *           value the data had before the addition. Like @c ISR_put(), it must
+		 *           only be called from within an interrupt service routine, or from a
+		 *           critical section, so that nothing can interrupt it.
+		 *  @param   addend The number to be added to the shared data
+		 *  @return  The value of the shared data before the addition
+		 */
+		DataType ISR_fetch_add (DataType addend)
+		{
+			DataType old_value = this->ISR_get ();
+			this->ISR_put (old_value + addend);
+			return (old_value);
+		}
+
+		/** @brief   Subtract from the data from within an ISR.
+		 *  @details This method must only be called from within an interrupt service
+		 *           routine or a critical section.
+		 *  @param   subtrahend The number to be subtracted from the shared data
+		 *  @return  The value of the shared data before the subtraction
+		 */
+		DataType ISR_fetch_sub (DataType subtrahend)
+		{
+			DataType old_value = this->ISR_get ();
+			this->ISR_put (old_value - subtrahend);
+			return (old_value);
+		}
+
+		/** @brief   Replace the data from within an ISR.
+		 *  @details This method must only be called from within an interrupt service
+		 *           routine or a critical section.
+		 *  @param   new_data The data which is to be written into the shared data item
+		 *  @return  The value of the shared data before it was replaced
+		 */
+		DataType ISR_exchange (DataType new_data)
+		{
+			DataType old_value = this->ISR_get ();
+			this->ISR_put (new_data);
+			return (old_value);
+		}
+
+		/** @brief   Replace the data from within an ISR if it holds an expected value.
+		 *  @details If the shared data equals @c expected, it's replaced by
+		 *           @c new_data; if not, the data is left alone and its value is put
+		 *           into @c expected. This method must only be called from within an
+		 *           interrupt service routine or a critical section.
+		 *  @param   expected The value the data is expected to have; if it has some
+		 *           other value, that value is written here
+		 *  @param   new_data The data which is to be written if the expected value was
+		 *           found
+		 *  @return  @c true if the data was replaced and @c false if it wasn't
+		 */
+		bool ISR_compare_exchange (DataType& expected, DataType new_data)
+		{
+			DataType old_value = this->ISR_get ();
+			if (old_value == expected)
+			{
+				this->ISR_put (new_data);
+				return (true);
+			}
+			expected = old_value;
+			return (false);
+		}
 
 		/**   @brief   The prefix increment causes the shared data to increase by one.
 		 *    @details This operator just increases by one the variable held by the 
@@ -100,23 +362,16 @@ template <class DataType> class TaskShare : public BaseShare
 		 */
 		DataType& operator ++ (void)
 		{
-			portENTER_CRITICAL ();
-			the_data++;
-			portEXIT_CRITICAL ();
+			fetch_add (1);
 
-			return (the_data);
+			return (const_cast<DataType&> (this->the_data));
 		}
 
 		/**   @brief The postfix increment causes the shared data to increase by one.
 		 */
 		DataType operator ++ (int)
 		{
-			DataType result = the_data;
-			portENTER_CRITICAL ();
-			the_data++;
-			portEXIT_CRITICAL ();
-
-			return (result);
+			return (fetch_add (1));
 		}
 
 		/**   @brief   The prefix decrement causes the shared data to decrease by one.
@@ -127,116 +382,108 @@ template <class DataType> class TaskShare : public BaseShare
 		 */
 		DataType& operator -- (void)
 		{
-			portENTER_CRITICAL ();
-			the_data--;
-			portEXIT_CRITICAL ();
+			fetch_sub (1);
 
-			return (the_data); //// *this);  The BUG
+			return (const_cast<DataType&> (this->the_data)); //// *this);  The BUG
 		}
 
 		/**   @brief The postfix decrement causes the shared data to decrease by one.
 		 */
 		DataType operator -- (int)
 		{
-			DataType result = the_data;
-			portENTER_CRITICAL ();
-			the_data--;
-			portEXIT_CRITICAL ();
-
-			return (result);
+			return (fetch_sub (1));
 		}
 }; // class TaskShare<DataType>
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Put data into the shared data item.
- *  @details This method is used to write data into the shared data item. It's 
- *           declared @c inline so that instead of a regular function call at the 
- *           assembly language level, <tt>an_object.put (x);</tt> will result in 
- *           the code within this function being inserted directly into the calling
- *           function. This is faster than doing a regular function call, which
- *           involves pushing the program counter on the stack, pushing parameters, 
- *           jumping, making space for local variables, jumping back and popping the 
- *           program counter, yawn, zzz...
- *  @param   new_data The data which is to be written
+/** @brief   Add a number to the shared data as one uninterruptible operation.
+ *  @details This method reads the shared data, adds to it and writes the result back
+ *           within one critical section, so no task or ISR can change the data in
+ *           between. Using <tt>a_share.put (a_share.get () + x);</tt> instead would
+ *           lose any change that happened between the @c get() and the @c put().
+ *  @param   addend The number to be added to the shared data
+ *  @return  The value of the shared data before the addition
  */
 
 template <class DataType>
-inline void TaskShare<DataType>::put (DataType new_data)
+inline DataType TaskShare<DataType>::fetch_add (DataType addend)
 {
 	portENTER_CRITICAL ();
-	the_data = new_data;
+	DataType old_value = ISR_fetch_add (addend);
 	portEXIT_CRITICAL ();
+
+	return (old_value);
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Put data into the shared data item from within an ISR.
- *  @details This method writes data from an ISR into the shared data item. It must 
- *           only be called from within a hardware interrupt, not a normal task. This 
- *           is because critical section protection isn't used here, which is OK, 
- *           assuming that an interrupt can't be interrupted by another interrupt, 
- *           which is the case on most small microcontrollers. 
- *  @param   new_data The data which is to be written into the shared data item
+/** @brief   Subtract a number from the shared data as one uninterruptible operation.
+ *  @param   subtrahend The number to be subtracted from the shared data
+ *  @return  The value of the shared data before the subtraction
  */
 
 template <class DataType>
-void TaskShare<DataType>::ISR_put (DataType new_data)
+inline DataType TaskShare<DataType>::fetch_sub (DataType subtrahend)
 {
-	the_data = new_data;
+	portENTER_CRITICAL ();
+	DataType old_value = ISR_fetch_sub (subtrahend);
+	portEXIT_CRITICAL ();
+
+	return (old_value);
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Read data from the shared data item.
- *  @details This method is used to read data from the shared data item with critical
- *           section protection to ensure that the data cannot be corrupted by a task
- *           switch. 
- *  @return  The current value of the shared data item
+/** @brief   Put new data into the share and get the old data in one operation.
+ *  @details This method is handy for taking a value which is being accumulated by
+ *           another task or an ISR, such as a count of events, and resetting it,
+ *           without missing anything which is added between the reading and the
+ *           resetting.
+ *  @param   new_data The data which is to be written into the shared data item
+ *  @return  The value of the shared data before it was replaced
  */
 
 template <class DataType>
-DataType TaskShare<DataType>::get (void)
+inline DataType TaskShare<DataType>::exchange (DataType new_data)
 {
-	// It's necessary to make an extra, temporary copy of the data so that the
-	// temporary copy can be returned. We can't call return() from within the
-	// critical section for reasons that are obvious if you think about it
-	DataType temporary_copy;
-
 	portENTER_CRITICAL ();
-	temporary_copy = the_data;
+	DataType old_value = ISR_exchange (new_data);
 	portEXIT_CRITICAL ();
 
-	return (temporary_copy);
+	return (old_value);
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Read data from the shared data item, from within an ISR.
- *  @details This method is used to enable code within an ISR to read data from the 
- *           shared data item. It must only be called from within an interrupt service
- *           routine, not a normal task. This is because critical section protection 
- *           isn't used here, which is OK, assuming that an interrupt can't be 
- *           interrupted by another interrupt, which is the case on most small 
- *           microcontrollers. 
- *  @return  The current value of the shared data item
+/** @brief   Put new data into the share only if the share holds an expected value.
+ *  @details If the shared data equals @c expected, it's replaced by @c new_data; if
+ *           not, the data is left alone and its value is put into @c expected. This
+ *           allows any calculation to be used to change the data safely: read the
+ *           data, compute a new value, then try to store it with this method, going
+ *           back to the calculation if the data was changed by someone else.
+ *  @param   expected The value the data is expected to have; if it has some other
+ *           value, that value is written here
+ *  @param   new_data The data which is to be written if the expected value was found
+ *  @return  @c true if the data was replaced and @c false if it wasn't
  */
 
 template <class DataType>
-DataType TaskShare<DataType>::ISR_get (void)
+inline bool TaskShare<DataType>::compare_exchange (DataType& expected,
+												   DataType new_data)
 {
-	return (the_data);
+	portENTER_CRITICAL ();
+	bool exchanged = ISR_compare_exchange (expected, new_data);
+	portEXIT_CRITICAL ();
+
+	return (exchanged);
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   Read data from the shared data item, from within an ISR.
- *  @details This method is used to enable code within an ISR to read data from the 
- *           shared data item. It must only be called from within an interrupt service
- *           routine, not a normal task. This is because critical section protection 
- *           isn't used here, which is OK, assuming that an interrupt can't be 
- *           interrupted by another interrupt, which is the case on most small 
- *           microcontrollers. 
+/** @brief   Print the share's status within a list of all shares' statuses.
+ *  @details This method prints the name of the share and its type. It then asks the
+ *           next share in the linked list of shares to print its status.
  *  @param   p_ser_dev Pointer to a serial device on which to print the status
  */
 
@@ -6,6 +6,9 @@
  *  Revised:
  *    \li 10-21-2012 JRR Original file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
+ *    \li 10-16-2026 ERR Changed from a FreeRTOS queue to a ring buffer written a
+ *                       block at a time, with semaphores to wake the reader
+ *    \li 10-16-2026 ERR Writers waiting for space are counted so each one is woken
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -24,6 +27,8 @@
 //*************************************************************************************
 
 #include <string.h>                         // C language string handling functions
+#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "task.h"                           // For suspending the scheduler
 #include "textqueue.h"                      // Pull in the base class header file
 
 
@@ -50,8 +55,15 @@ TextQueue::TextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_d
 	// Save the pointer to the serial device which is used for debugging
 	p_serial = p_ser_dev;
 
-	// Create a FreeRTOS queue object which holds the given number of characters
-	the_queue = xQueueCreate (queue_size, sizeof (char));
+	// Create the buffer which holds the given number of characters, and the
+	// semaphores which tell the reading and writing tasks when to look at it
+	p_buffer = new char[queue_size];
+	data_ready = xSemaphoreCreateBinary ();
+	space_ready = xSemaphoreCreateBinary ();
+	read_index = 0;
+	write_index = 0;
+	num_chars = 0;
+	writers_waiting = 0;
 
 	// Store the wait time; it will be used when writing to the queue
 	ticks_to_wait = a_wait_time;
@@ -61,6 +73,92 @@ TextQueue::TextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_d
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Write a block of characters to the text queue.
+ *  @details This method copies as many of the given characters as will fit into the
+ *           buffer in one go. The scheduler is suspended while copying so that no
+ *           other task can use the buffer at the same time; interrupts are left on.
+ *           If the buffer was empty, the reading task is woken up once for the whole
+ *           block. If the buffer fills up before all the characters have been copied,
+ *           this method waits for the reading task to make space, for up to the wait
+ *           time given to the constructor; if no space appears in that time, the
+ *           rest of the characters are thrown away. Several tasks may be waiting at
+ *           once, but the semaphore which says there's space wakes only one of them;
+ *           so a writer which has been woken and leaves space behind after copying
+ *           passes the signal on to the next one. 
+ *  @param   p_data A pointer to the characters which are to be written
+ *  @param   length The number of characters to be written
+ */
+
+void TextQueue::write (const char* p_data, size_t length)
+{
+	while (length > 0)
+	{
+		uint16_t to_copy;                   // Number of characters to copy now
+		uint16_t to_end;                    // Number of spaces before the wraparound
+		bool was_empty;                     // True if the reader may be waiting
+		bool pass_on;                       // True to wake another waiting writer
+
+		vTaskSuspendAll ();
+		was_empty = (num_chars == 0);
+		to_copy = buf_size - num_chars;
+		if (to_copy > length)
+		{
+			to_copy = length;
+		}
+
+		// Copy in up to two pieces, one before and one after the end of the buffer
+		to_end = buf_size - write_index;
+		if (to_copy < to_end)
+		{
+			memcpy (p_buffer + write_index, p_data, to_copy);
+			write_index += to_copy;
+		}
+		else
+		{
+			memcpy (p_buffer + write_index, p_data, to_end);
+			memcpy (p_buffer, p_data + to_end, to_copy - to_end);
+			write_index = to_copy - to_end;
+		}
+		num_chars += to_copy;
+		p_data += to_copy;
+		length -= to_copy;
+
+		// A writer which is about to wait is counted before anyone can make space
+		if (length > 0)
+		{
+			writers_waiting++;
+		}
+		pass_on = (writers_waiting > 0 && num_chars < buf_size);
+		xTaskResumeAll ();
+
+		if (was_empty && to_copy > 0)
+		{
+			xSemaphoreGive (data_ready);
+		}
+		if (pass_on)
+		{
+			xSemaphoreGive (space_ready);
+		}
+
+		// If there wasn't room for everything, wait for the reader to make room
+		if (length > 0)
+		{
+			bool got_space = (xSemaphoreTake (space_ready, ticks_to_wait) == pdTRUE);
+
+			vTaskSuspendAll ();
+			writers_waiting--;
+			xTaskResumeAll ();
+
+			if (!got_space)
+			{
+				return;
+			}
+		}
+	}
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Write one character to the text queue.
  *  @details This method writes one character to the queue. If the second constructor 
@@ -72,23 +170,21 @@ TextQueue::TextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_d
  *  @param   a_char The character to be sent to the queue
  */
 
-inline void TextQueue::putchar (char a_char)
+void TextQueue::putchar (char a_char)
 {
-	xQueueSendToBack (the_queue, &a_char, ticks_to_wait);
+	write (&a_char, 1);
 }
 
 
 //-------------------------------------------------------------------------------------
 /** @brief   Check if a character is ready to be read from the queue.
- *  @details This method checks if there is a character in the queue. It just calls 
- *           the FreeRTOS function @c uxQueueMessagesWaiting(); if there's anything in
- *           the queue, the return value from that function will be greater than zero. 
+ *  @details This method checks if there is a character in the buffer. 
  *  @return  True for character available, false for no character available
  */
 
-inline bool TextQueue::check_for_char (void)
+bool TextQueue::check_for_char (void)
 {
-	return (uxQueueMessagesWaiting (the_queue));
+	return (num_chars != 0);
 }
 
 
@@ -101,18 +197,37 @@ inline bool TextQueue::check_for_char (void)
  *  @return  The character which was received from the queue
  */
 
-inline char TextQueue::getchar (void)
+char TextQueue::getchar (void)
 {
 	char recv_char;							// Character read from the queue
+	bool wake_writer;						// True if a writer is waiting for space
 
-	// If xQueueReceive doesn't return pdTrue, nothing was found in the queue
-	if (xQueueReceive (the_queue, &recv_char, portMAX_DELAY) != pdTRUE)
+	for (;;)
 	{
-		return (-1);
-	}
+		vTaskSuspendAll ();
+		if (num_chars > 0)
+		{
+			wake_writer = (writers_waiting > 0);
+			recv_char = p_buffer[read_index];
+			if (++read_index >= buf_size)
+			{
+				read_index = 0;
+			}
+			num_chars--;
+			xTaskResumeAll ();
 
-	// OK, we got good data from the queue, so return it
-	return (recv_char);
+			// If a writing task is waiting for space, there's some now
+			if (wake_writer)
+			{
+				xSemaphoreGive (space_ready);
+			}
+			return (recv_char);
+		}
+		xTaskResumeAll ();
+
+		// The buffer's empty, so wait until a writer says there's something in it
+		xSemaphoreTake (data_ready, portMAX_DELAY);
+	}
 }
 
 
@@ -136,7 +251,7 @@ void TextQueue::print_in_list (emstream* p_ser_dev)
 	p_ser_dev->puts ("txt_q\t");
 
 	// Print the free and total number of spaces in the queue
-	*p_ser_dev << uxQueueSpacesAvailable (the_queue) << '/' << buf_size << '\t';
+	*p_ser_dev << (uint16_t)(buf_size - num_chars) << '/' << buf_size << '\t';
 
 	// End the line
 	*p_ser_dev << endl;
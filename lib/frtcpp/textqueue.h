@@ -6,6 +6,9 @@
  *  Revised:
  *    \li 10-21-2012 JRR Original file
  *    \li 08-26-2014 JRR Changed file names and base task class name to TaskBase
+ *    \li 10-16-2026 ERR Changed from a FreeRTOS queue to a ring buffer written a
+ *                       block at a time, with semaphores to wake the reader
+ *    \li 10-16-2026 ERR Count of writers waiting for space, so each one is woken
  *
  *  License:
  *		This file is copyright 2014 by JR Ridgely and released under the Lesser GNU 
@@ -29,6 +32,7 @@
 
 #include "FreeRTOS.h"                       // Main header for FreeRTOS
 #include "queue.h"                          // Header for FreeRTOS queues
+#include "semphr.h"                         // Header for FreeRTOS semaphores
 #include "emstream.h"                       // Pull in the base class header file
 #include "baseshare.h"                      // Base class for thread-safe shared data
 
@@ -90,13 +94,31 @@
  *  time, and a long SD card write could block the taking of data for several 
  *  milliseconds (very bad!) if the data were not being taken in another task and
  *  buffered in a queue. 
+ *
+ *  \section Implementation
+ *  The characters are kept in a ring buffer rather than a FreeRTOS queue. Each string
+ *  or number printed with @c << arrives as one block through @c write(), and the
+ *  whole block is copied into the buffer at once with the scheduler suspended, so
+ *  writing a line costs a few kernel calls rather than one queue send for every
+ *  character. Interrupts aren't disabled while copying, as ISRs don't use text
+ *  queues. A binary semaphore wakes the reading task when characters are put into an
+ *  empty buffer, and another wakes a writing task which is waiting for a full buffer
+ *  to have space in it. The waiting writers are counted; a writer which is woken
+ *  and leaves space behind gives the semaphore again for the next one, so no writer
+ *  misses its turn and times out while there's room. 
  */
 
 class TextQueue : public emstream, public BaseShare
 {
 	// This protected data can only be accessed from this class or its descendents
 	protected:
-		QueueHandle_t the_queue;            ///< The handle for the queue we use
+		char* p_buffer;                     ///< Ring buffer which holds characters
+		uint16_t read_index;                ///< Where the next character is read
+		uint16_t write_index;               ///< Where the next character is written
+		uint16_t num_chars;                 ///< Number of characters in the buffer
+		SemaphoreHandle_t data_ready;       ///< Given when an empty buffer gets data
+		SemaphoreHandle_t space_ready;      ///< Given when a full buffer gets space
+		uint8_t writers_waiting;            ///< Number of writers waiting for space
 		TickType_t ticks_to_wait;           ///< RTOS ticks to wait for empty queue
 		emstream* p_serial;                 ///< Serial device used for debugging
 		uint16_t buf_size;                  ///< Size of queue buffer in bytes
@@ -109,6 +131,7 @@ class TextQueue : public emstream, public BaseShare
 				   TickType_t = portMAX_DELAY);
 
 		void putchar (char);                // Write one character to the queue
+		void write (const char*, size_t);   // Write a block of characters
 		bool check_for_char (void);         // Check if a character is in the queue
 		char getchar (void);                // Read a character from the queue
 
@@ -118,18 +141,7 @@ class TextQueue : public emstream, public BaseShare
 		 */
 		operator bool () const
 		{
-			return (uxQueueMessagesWaiting (the_queue) != 0);
-		}
-
-		/** If somebody wants to do something which FreeRTOS queues can do but this
-		 *  class doesn't support, a handle for the queue inside this class can be
-		 *  used to access the queue directly. This isn't normally done.
-		 *  @return A handle to the FreeRTOS queue structure which is wrapped up by
-		 *          this handy C++ class
-		 */
-		QueueHandle_t get_handle (void)
-		{
-			return (the_queue);
+			return (num_chars != 0);
 		}
 
 		// Print the status of this queue in the table of queue status printouts
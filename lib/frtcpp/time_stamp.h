@@ -21,6 +21,8 @@
  *    \li 10-10-2012 JRR Made time_stamp::set_to_now() return a reference to the stamp
  *    \li 12-02-2012 JRR Split many methods and operators into their own \c .cpp files
  *                       in order to save memory in the compiled machine code
+ *    \li 10-16-2026 ERR Added a fast monotonic clock which gives raw timer counts
+ *                       and 64-bit microsecond times without run-time division
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -67,6 +69,23 @@ const uint32_t TMR_MAX_CT = configCPU_CLOCK_HZ /
 						   (configTICK_RATE_HZ * portCLOCK_PRESCALER);
 
 
+/// This constant holds the number of microseconds in each RTOS tick.
+const uint32_t US_PER_RTOS_TICK = 1000000UL / configTICK_RATE_HZ;
+
+/** This is the number of bits by which a product of hardware timer counts and 
+ *  @c HW_US_MULT is shifted right to get microseconds. Sixteen bits leave enough 
+ *  precision for any timer rate above a few tens of kilohertz. 
+ */
+#define HW_US_SHIFT			16
+
+/** This constant converts hardware timer counts to microseconds with a multiply and a
+ *  shift instead of a division: microseconds = (counts * HW_US_MULT) >> HW_US_SHIFT. 
+ *  It is computed by the compiler from the CPU clock and prescaler, so the slow 
+ *  32-bit division which the AVR would otherwise do in software is never run. 
+ */
+const uint32_t HW_US_MULT = (uint32_t)((1000000ULL << HW_US_SHIFT) / HW_TICK_RATE_HZ);
+
+
 //--------------------------------------------------------------------------------------
 /** \brief This class holds a time stamp which is used to measure the passage of real 
  *  time in the world of an AVR processor with approximately microsecond resolution. 
@@ -177,4 +196,38 @@ emstream& operator<< (emstream&, time_stamp&);
 // This function computes time quickly using only RTOS timer ticks and makes a string
 const char* tick_res_time (void);
 
+
+//--------------------------------------------------------------------------------------
+// These functions return the time since the scheduler started in hardware timer counts;
+// they're meant for measuring short intervals cheaply, as in profiling
+uint32_t get_raw_time (void);
+uint32_t get_raw_time_ISR (void);
+
+// These functions return the time since the scheduler started in microseconds
+uint64_t get_time_us (void);
+uint64_t get_time_us_ISR (void);
+
+
+/** This function converts a difference between two raw times, as returned by 
+ *  @c get_raw_time(), into microseconds. Because raw times are unsigned counts, the 
+ *  difference is correct even if the raw time has wrapped around between the two 
+ *  readings, as long as the interval is shorter than 2^32 hardware timer counts (about
+ *  35 minutes at 2 MHz). If the hardware timer runs at a whole number of counts per
+ *  microsecond, the conversion is a division by a constant, which the compiler turns
+ *  into a shift; otherwise a multiply and shift are used. 
+ *  @param raw_delta The difference between two raw times
+ *  @return The time difference in microseconds
+ */
+inline uint32_t raw_time_to_us (uint32_t raw_delta)
+{
+	if (HW_TICK_RATE_HZ % 1000000UL == 0)
+	{
+		return (raw_delta / (HW_TICK_RATE_HZ / 1000000UL));
+	}
+	else
+	{
+		return ((uint32_t)(((uint64_t)raw_delta * HW_US_MULT) >> HW_US_SHIFT));
+	}
+}
+
 #endif  // _TIME_STAMP_H_
@@ -5,6 +5,7 @@
  *
  *  Revisions:
  *    \li 12-02-2012 JRR Split off from time_stamp.cpp to save memory in machine file
+ *    \li 10-16-2026 ERR Borrow from the result's tick count rather than this one's
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -51,7 +52,7 @@ time_stamp time_stamp::operator - (const time_stamp& previous)
 	// hardware count, it's actually a negative number, so borrow from the tick count
 	if (ret_stamp.hardware_count >= TMR_MAX_CT)
 	{
-		tick_count--;
+		ret_stamp.tick_count--;
 		ret_stamp.hardware_count += TMR_MAX_CT;
 	}
 
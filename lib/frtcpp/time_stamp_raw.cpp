@@ -0,0 +1,194 @@
+//**************************************************************************************
+/** \file time_stamp_raw.cpp
+ *    This file contains functions which read a fast, monotonic clock made from the
+ *    RTOS tick count and the count in the hardware timer which drives the tick. The
+ *    time is given either as a raw count of hardware timer ticks, which is cheap to
+ *    get and to subtract, or as a 64-bit number of microseconds.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file
+ *    \li 10-16-2026 ERR Microsecond times count RTOS tick wraparounds, so they don't
+ *                       go back to zero after 2^32 ticks
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU 
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include <avr/interrupt.h>                  // For using interrupt service routines
+
+#include "FreeRTOS.h"                       // Main header for FreeRTOS 
+#include "task.h"                           // The FreeRTOS task functions header
+#include "time_stamp.h"                     // Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads the hardware timer count and the RTOS tick count together. It
+ *  must be called with interrupts disabled. If the hardware timer reaches its compare
+ *  match after interrupts were disabled, the tick interrupt can't run to increment the
+ *  tick count, so the timer count would be small while the tick count is one tick 
+ *  behind. The compare match flag shows when this has happened; then the timer is 
+ *  read again and one tick is added. This fixes the rollover problem noted in 
+ *  @c time_stamp::set_to_now(). 
+ *  @param ticks A reference to a variable which will hold the RTOS tick count
+ *  @param in_ISR True if called from an interrupt service routine
+ *  @return The count in the hardware timer
+ */
+
+static inline HW_CTR_TYPE read_clock (TickType_t& ticks, bool in_ISR)
+{
+	HW_CTR_TYPE count;						// Count read from the hardware timer
+
+	#if (defined TIMER5_COMPA_vect)
+		count = TCNT5;
+		ticks = in_ISR ? xTaskGetTickCountFromISR () : xTaskGetTickCount ();
+		if (TIFR5 & (1 << OCF5A))
+		{
+			count = TCNT5;
+			ticks++;
+		}
+	#elif (defined TIMER3_COMPA_vect)
+		count = TCNT3;
+		ticks = in_ISR ? xTaskGetTickCountFromISR () : xTaskGetTickCount ();
+		if (TIFR3 & (1 << OCF3A))
+		{
+			count = TCNT3;
+			ticks++;
+		}
+	#else
+		count = TCNT1;
+		ticks = in_ISR ? xTaskGetTickCountFromISR () : xTaskGetTickCount ();
+		if (TIFR1 & (1 << OCF1A))
+		{
+			count = TCNT1;
+			ticks++;
+		}
+	#endif
+
+	return (count);
+}
+
+
+/// The RTOS tick count the last time a microsecond time was read
+static TickType_t last_ticks = 0;
+
+/// The number of times the RTOS tick count has wrapped around to zero
+static uint32_t tick_wraps = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function makes a 64-bit tick count from the RTOS's 32-bit one, which goes
+ *  back to zero after 2^32 ticks, about 49.7 days at 1000 ticks per second. Each time
+ *  the tick count is found to be smaller than it was at the last call, it has wrapped
+ *  around, and that is counted. A wraparound is only seen if this function is called
+ *  at least once between two of them, which any program that wants microsecond times
+ *  will do. It must be called with interrupts disabled.
+ *  @param ticks The RTOS tick count, as read by @c read_clock()
+ *  @return The number of RTOS ticks since the scheduler started
+ */
+
+static inline uint64_t extend_ticks (TickType_t ticks)
+{
+	if (ticks < last_ticks)
+	{
+		tick_wraps++;
+	}
+	last_ticks = ticks;
+
+	return (((uint64_t)tick_wraps << 32) | ticks);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the time since the scheduler was started as a raw count of
+ *  hardware timer ticks; with a 16 MHz CPU and a prescaler of 8, each count is half a
+ *  microsecond. The count wraps around after 2^32 hardware ticks, so raw times are 
+ *  only useful for finding the time between two readings, which is done by simple 
+ *  unsigned subtraction followed by @c raw_time_to_us(). Only one multiplication by a
+ *  constant is done, so this is much faster than filling a @c time_stamp and asking
+ *  it for seconds and microseconds. This function must not be called within an ISR.
+ *  @return The time since the scheduler started, in hardware timer counts
+ */
+
+uint32_t get_raw_time (void)
+{
+	TickType_t ticks;						// RTOS tick count
+	HW_CTR_TYPE count;						// Hardware timer count
+
+	portENTER_CRITICAL ();
+	count = read_clock (ticks, false);
+	portEXIT_CRITICAL ();
+
+	return ((uint32_t)ticks * TMR_MAX_CT + count);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the time since the scheduler was started as a raw count of
+ *  hardware timer ticks. It is to be called only from within an interrupt service
+ *  routine, where interrupts are already disabled. 
+ *  @return The time since the scheduler started, in hardware timer counts
+ */
+
+uint32_t get_raw_time_ISR (void)
+{
+	TickType_t ticks;						// RTOS tick count
+	HW_CTR_TYPE count = read_clock (ticks, true);
+
+	return ((uint32_t)ticks * TMR_MAX_CT + count);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the time since the scheduler was started in microseconds. 
+ *  The RTOS tick count is made 64 bits wide by @c extend_ticks(), so the result won't
+ *  wrap around for hundreds of thousands of years and can be used as a monotonic
+ *  clock for time stamping data, as long as some microsecond time is read at least
+ *  once every 49 days. The RTOS ticks are multiplied
+ *  by the whole number of microseconds per tick and the hardware count is converted 
+ *  with a multiply and shift by constants, so no division is done while running. 
+ *  This function must not be called within an ISR.
+ *  @return The number of microseconds since the scheduler started
+ */
+
+uint64_t get_time_us (void)
+{
+	TickType_t ticks;						// RTOS tick count
+	HW_CTR_TYPE count;						// Hardware timer count
+	uint64_t all_ticks;						// Ticks including wraparounds
+
+	portENTER_CRITICAL ();
+	count = read_clock (ticks, false);
+	all_ticks = extend_ticks (ticks);
+	portEXIT_CRITICAL ();
+
+	return (all_ticks * US_PER_RTOS_TICK
+			+ (((uint32_t)count * HW_US_MULT) >> HW_US_SHIFT));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function returns the time since the scheduler was started in microseconds. 
+ *  It is to be called only from within an interrupt service routine. 
+ *  @return The number of microseconds since the scheduler started
+ */
+
+uint64_t get_time_us_ISR (void)
+{
+	TickType_t ticks;						// RTOS tick count
+	HW_CTR_TYPE count = read_clock (ticks, true);
+
+	return (extend_ticks (ticks) * US_PER_RTOS_TICK
+			+ (((uint32_t)count * HW_US_MULT) >> HW_US_SHIFT));
+}
@@ -0,0 +1,199 @@
+//*************************************************************************************
+/** \file avr_pin.h
+ *    This file contains classes which bind an I/O pin or register to a driver when
+ *    the program is compiled rather than when it runs. A driver which is given
+ *    @c &PORTC and a pin number keeps them in variables, so setting one bit means
+ *    loading the pointer, computing @c 1 @c << @c pin (a loop, since the AVR can
+ *    only shift by one bit at a time), reading the port, changing it and writing it
+ *    back. A driver which is given @c Pin<PortC, @c PC0> knows the address and bit
+ *    while it's being compiled, so the compiler makes a single @c sbi or @c cbi
+ *    instruction, which takes two cycles and can't be interrupted halfway.
+ *
+ *  Usage:
+ *    The classes have only static methods and are used as template parameters:
+ *    \code
+ *    typedef Pin<PortC, PC0> motor_in_a;
+ *    motor_in_a::make_output ();
+ *    motor_in_a::set ();
+ *    \endcode
+ *    Only constant addresses can be made into single instructions, so the port
+ *    classes return references to the registers themselves, as the @c PORTC macro
+ *    does, and 16-bit registers such as @c OCR1B have classes made with
+ *    @c AVR_REGISTER16().
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _AVR_PIN_H_
+#define _AVR_PIN_H_
+
+#include <stdint.h>                         // Standard integer types
+#include <avr/io.h>                         // Names of the I/O registers
+
+
+/** \brief This macro makes a class for one 8-bit I/O port, such as @c PortC.
+ *  \details The class has methods which return the port's @c PORTx, @c PINx and
+ *  @c DDRx registers, which sit at consecutive addresses on all AVR processors.
+ */
+#define AVR_PORT(letter) \
+	struct Port##letter \
+	{ \
+		static volatile uint8_t& port (void) { return (PORT##letter); } \
+		static volatile uint8_t& pin (void) { return (PIN##letter); } \
+		static volatile uint8_t& ddr (void) { return (DDR##letter); } \
+	}
+
+#ifdef PORTA
+	AVR_PORT (A);
+#endif
+#ifdef PORTB
+	AVR_PORT (B);
+#endif
+#ifdef PORTC
+	AVR_PORT (C);
+#endif
+#ifdef PORTD
+	AVR_PORT (D);
+#endif
+#ifdef PORTE
+	AVR_PORT (E);
+#endif
+#ifdef PORTF
+	AVR_PORT (F);
+#endif
+#ifdef PORTG
+	AVR_PORT (G);
+#endif
+
+
+/** \brief This macro makes a class for a 16-bit register, such as @c Reg_OCR1B.
+ *  \details The compiler writes a 16-bit register with two @c sts instructions, high
+ *  byte first as the AVR requires, when the address is a constant.
+ */
+#define AVR_REGISTER16(name) \
+	struct Reg_##name \
+	{ \
+		static volatile uint16_t& reg (void) { return (name); } \
+	}
+
+#ifdef OCR1A
+	AVR_REGISTER16 (OCR1A);
+	AVR_REGISTER16 (OCR1B);
+#endif
+#ifdef OCR1C
+	AVR_REGISTER16 (OCR1C);
+#endif
+#ifdef OCR3A
+	AVR_REGISTER16 (OCR3A);
+	AVR_REGISTER16 (OCR3B);
+	AVR_REGISTER16 (OCR3C);
+#endif
+#ifdef OCR4A
+	AVR_REGISTER16 (OCR4A);
+	AVR_REGISTER16 (OCR4B);
+	AVR_REGISTER16 (OCR4C);
+#endif
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class is one I/O pin, chosen when the program is compiled.
+ *  \details Every method is static and inline, and the port and bit are constants,
+ *  so each one compiles to one or two instructions: @c sbi and @c cbi for @c set()
+ *  and @c clear(), and @c in with a bit test for @c read(). @c toggle() writes a one
+ *  to the pin's bit in @c PINx, which newer AVRs such as the ATmega1281 take as a
+ *  command to toggle the output.
+ */
+
+template <class PortType, uint8_t bit> struct Pin
+{
+	/// The port which holds this pin
+	typedef PortType Port;
+
+	/// The pin's bit number and its mask
+	enum { BIT = bit, MASK = (1 << bit) };
+
+	/// Drive the pin high, or turn on its pull-up if it's an input
+	static void set (void) { PortType::port () |= MASK; }
+
+	/// Drive the pin low, or turn off its pull-up if it's an input
+	static void clear (void) { PortType::port () &= (uint8_t)~MASK; }
+
+	/// Change the output from high to low or low to high
+	static void toggle (void) { PortType::pin () = MASK; }
+
+	/// Read the level on the pin; returns true if it's high
+	static bool read (void) { return (PortType::pin () & MASK); }
+
+	/// Make the pin an output
+	static void make_output (void) { PortType::ddr () |= MASK; }
+
+	/** \brief Make the pin an input.
+	 *  \param pullup True to turn on the pin's pull-up resistor
+	 */
+	static void make_input (bool pullup = false)
+	{
+		PortType::ddr () &= (uint8_t)~MASK;
+		if (pullup)
+		{
+			set ();
+		}
+		else
+		{
+			clear ();
+		}
+	}
+
+	/** \brief Drive the pin high or low.
+	 *  \param high True to drive the pin high, false for low
+	 */
+	static void write (bool high)
+	{
+		if (high)
+		{
+			set ();
+		}
+		else
+		{
+			clear ();
+		}
+	}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class is a whole 8-bit port used as a parallel bus.
+ *  \details It's used for chips such as the HCTL-2000 which put a byte on eight
+ *  data lines; reading the bus is a single @c in instruction.
+ */
+
+template <class PortType> struct PortBus
+{
+	/// Make all eight lines inputs, without pull-ups
+	static void make_input (void)
+	{
+		PortType::ddr () = 0x00;
+		PortType::port () = 0x00;
+	}
+
+	/// Read the byte on the bus
+	static uint8_t read (void) { return (PortType::pin ()); }
+};
+
+#endif // _AVR_PIN_H_
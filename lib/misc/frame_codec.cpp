@@ -0,0 +1,265 @@
+//*************************************************************************************
+/** \file frame_codec.cpp
+ *    This file contains the encoder and the byte-at-a-time decoder for the framed
+ *    binary protocol used on links between boards. A frame is a message type, a
+ *    sequence number, the payload and a CRC-16, COBS encoded and followed by a zero.
+ *
+ *  Revisions
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include "frame_codec.h"
+
+
+//-------------------------------------------------------------------------------------
+/** This function makes a frame which is ready to be sent. The type, sequence number,
+ *  payload and CRC are COBS encoded: the data is split at each zero byte into blocks,
+ *  and each block starts with a code byte which is one more than the number of
+ *  non-zero bytes in it. A block which ends with a zero leaves the zero out, and
+ *  blocks of 254 bytes have no zero after them. The delimiter goes last.
+ *  @param type The type of message, such as \c FRAME_TYPE_JOYSTICK
+ *  @param seq The sequence number, usually one more than that of the last message
+ *  @param p_payload Pointer to the payload bytes
+ *  @param length The number of payload bytes; more than \c FRAME_PAYLOAD_MAX are
+ *                cut off
+ *  @param p_frame Pointer to a buffer of at least \c FRAME_ENCODED_MAX bytes which
+ *                 will hold the frame
+ *  @return The number of bytes in the frame, including the delimiter
+ */
+
+uint8_t frame_encode (uint8_t type, uint8_t seq, const uint8_t* p_payload,
+					  uint8_t length, uint8_t* p_frame)
+{
+	uint8_t raw[FRAME_RAW_MAX];             // The message before it's encoded
+	uint8_t raw_size;                       // Number of bytes in the raw message
+	uint16_t crc = 0xFFFF;
+
+	if (length > FRAME_PAYLOAD_MAX)
+	{
+		length = FRAME_PAYLOAD_MAX;
+	}
+
+	raw[0] = type;
+	raw[1] = seq;
+	for (uint8_t index = 0; index < length; index++)
+	{
+		raw[FRAME_HEADER_SIZE + index] = p_payload[index];
+	}
+	raw_size = FRAME_HEADER_SIZE + length;
+	for (uint8_t index = 0; index < raw_size; index++)
+	{
+		crc = frame_crc16 (crc, raw[index]);
+	}
+	raw[raw_size++] = (uint8_t)(crc >> 8);
+	raw[raw_size++] = (uint8_t)crc;
+
+	// Each block's code byte is filled in when the end of the block is found
+	uint8_t code_at = 0;                    // Where the current block's code goes
+	uint8_t code = 1;                       // The code byte for the current block
+	uint8_t out = 1;                        // Where the next encoded byte goes
+
+	for (uint8_t index = 0; index < raw_size; index++)
+	{
+		if (raw[index] == 0)
+		{
+			p_frame[code_at] = code;
+			code_at = out++;
+			code = 1;
+		}
+		else
+		{
+			p_frame[out++] = raw[index];
+			if (++code == 0xFF)
+			{
+				p_frame[code_at] = code;
+				code_at = out++;
+				code = 1;
+			}
+		}
+	}
+	p_frame[code_at] = code;
+	p_frame[out++] = FRAME_DELIMITER;
+
+	return (out);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor makes a decoder with an empty queue. Until the first delimiter
+ *  arrives, bytes are thrown away, as they may be the end of a frame whose start was
+ *  missed.
+ */
+
+frame_decoder::frame_decoder (void)
+{
+	restart ();
+	skipping = true;
+	next_seq = 0;
+	seq_known = false;
+	good_count = 0;
+	crc_errors = 0;
+	framing_errors = 0;
+	lost_count = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method gets the decoder ready for the first byte of a new frame.
+ */
+
+void frame_decoder::restart (void)
+{
+	fill = 0;
+	block_left = 0;
+	zero_next = false;
+	skipping = false;
+	crc = 0xFFFF;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts one decoded byte into the message being decoded and works it into
+ *  the CRC. If the message is already as long as one can be, the frame is counted as
+ *  badly framed and the rest of it is thrown away.
+ *  @param data The decoded byte
+ */
+
+void frame_decoder::store (uint8_t data)
+{
+	if (fill >= FRAME_RAW_MAX)
+	{
+		if (framing_errors < 0xFFFF)
+		{
+			framing_errors++;
+		}
+		skipping = true;
+		return;
+	}
+	raw[fill++] = data;
+	crc = frame_crc16 (crc, data);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method checks a frame whose delimiter has just arrived. The CRC of a good
+ *  frame, run over the message and its CRC together, is zero. A good message is put
+ *  in the queue, and any gap in its sequence number is counted as lost messages.
+ */
+
+void frame_decoder::finish (void)
+{
+	if (block_left != 0 || fill < FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+	{
+		if (framing_errors < 0xFFFF)
+		{
+			framing_errors++;
+		}
+		return;
+	}
+	if (crc != 0)
+	{
+		if (crc_errors < 0xFFFF)
+		{
+			crc_errors++;
+		}
+		return;
+	}
+
+	frame_message msg;
+	msg.type = raw[0];
+	msg.seq = raw[1];
+	msg.length = fill - FRAME_HEADER_SIZE - FRAME_CRC_SIZE;
+	for (uint8_t index = 0; index < msg.length; index++)
+	{
+		msg.payload[index] = raw[FRAME_HEADER_SIZE + index];
+	}
+
+	if (seq_known)
+	{
+		uint8_t gap = msg.seq - next_seq;
+		lost_count = (gap > (uint16_t)(0xFFFF - lost_count)) ? 0xFFFF : lost_count + gap;
+	}
+	next_seq = msg.seq + 1;
+	seq_known = true;
+	good_count++;
+
+	ready.put (msg);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method decodes one byte which has arrived from the link. A code byte starts
+ *  a new COBS block, putting the zero which ended the block before it into the
+ *  message; other bytes go straight into the message. A delimiter ends the frame.
+ *  Nothing here waits or loops over the message except the copy made when a good
+ *  frame ends, so it may be called from an interrupt service routine. Extra
+ *  delimiters between frames are ignored.
+ *  @param data The byte which arrived
+ *  @return True if the byte finished a good message, which is now in the queue
+ */
+
+bool frame_decoder::feed (uint8_t data)
+{
+	if (data == FRAME_DELIMITER)
+	{
+		uint32_t good_before = good_count;
+
+		if (!skipping && (fill != 0 || block_left != 0 || zero_next))
+		{
+			finish ();
+		}
+		restart ();
+		return (good_count != good_before);
+	}
+
+	if (skipping)
+	{
+		return (false);
+	}
+
+	if (block_left == 0)
+	{
+		// A code byte: the block before this one may have ended with a zero
+		if (zero_next)
+		{
+			store (0);
+		}
+		block_left = data - 1;
+		zero_next = (data != 0xFF);
+	}
+	else
+	{
+		store (data);
+		block_left--;
+	}
+	return (false);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method prints the numbers of good messages and of each kind of error.
+ *  @param p_ser_dev Pointer to the serial device on which to print
+ */
+
+void frame_decoder::print_status (emstream* p_ser_dev)
+{
+	*p_ser_dev << PMS ("Frames: ") << good_count << PMS (" good, ") << crc_errors
+			   << PMS (" bad CRC, ") << framing_errors << PMS (" bad framing, ")
+			   << lost_count << PMS (" lost, ") << ready.get_overflows ()
+			   << PMS (" overflowed") << endl;
+}
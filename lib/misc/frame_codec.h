@@ -0,0 +1,244 @@
+//*************************************************************************************
+/** \file frame_codec.h
+ *    This file contains a small framed binary protocol for links between boards, such
+ *    as the serial link from the joystick controller to the car. Each message has a
+ *    type, a sequence number and a short payload, followed by a CRC-16. The message
+ *    is then COBS encoded (Consistent Overhead Byte Stuffing), which takes every zero
+ *    byte out of it, and a single zero byte is sent after it to mark the end of the
+ *    frame. Any data can be sent, and a receiver which starts listening part way
+ *    through a frame, or which misses some bytes, finds the start of the next frame
+ *    at the next zero byte.
+ *
+ *    The decoder takes one byte at a time and does a small, fixed amount of work per
+ *    byte, so it can be run right from a serial port's receive interrupt.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _FRAME_CODEC_H_
+#define _FRAME_CODEC_H_
+
+#include <stdint.h>                         // Standard integer types
+#include "emstream.h"                       // Header for serial ports and devices
+#include "spsc_ring.h"                      // Lock-free buffer for decoded messages
+
+
+/// The byte which marks the end of each frame; COBS keeps it out of the frame itself
+#define FRAME_DELIMITER     0x00
+
+/// The largest number of payload bytes in one message
+#define FRAME_PAYLOAD_MAX   16
+
+/// The bytes before the payload: the message type and the sequence number
+#define FRAME_HEADER_SIZE   2
+
+/// The bytes after the payload, which hold the CRC-16, high byte first
+#define FRAME_CRC_SIZE      2
+
+/// The largest message before it's encoded, with its header and CRC
+#define FRAME_RAW_MAX       (FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE)
+
+/** The largest frame after encoding. COBS adds one byte per 254 bytes of data, plus
+ *  one, and the delimiter follows the frame; a buffer this size holds any frame.
+ */
+#define FRAME_ENCODED_MAX   (FRAME_RAW_MAX + FRAME_RAW_MAX / 254 + 2)
+
+/// The number of decoded messages which can wait for a task to read them
+#define FRAME_QUEUE_SIZE    4
+
+/// Message type which carries joystick positions from the controller to the car
+#define FRAME_TYPE_JOYSTICK 0x01
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This structure holds one message sent or received through a framed link.
+ */
+
+struct frame_message
+{
+	uint8_t type;							///< What the message is, such as a joystick
+	uint8_t seq;							///< Sequence number, one more than the last
+	uint8_t length;							///< Number of bytes in \c payload
+	uint8_t payload[FRAME_PAYLOAD_MAX];		///< The data carried by the message
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This function adds one byte to a CRC-16 with the CCITT polynomial 0x1021. A CRC
+ *  is started at 0xFFFF. The byte is worked in with a few shifts rather than a loop
+ *  over its bits or a 512-byte table, so it takes the same short time for any byte.
+ *  Because the CRC isn't reflected or inverted at the end, running the CRC over a
+ *  message followed by its own CRC, high byte first, always gives zero.
+ *  @param crc The CRC of the bytes before this one
+ *  @param data The byte to be added
+ *  @return The CRC of all the bytes including this one
+ */
+
+inline uint16_t frame_crc16 (uint16_t crc, uint8_t data)
+{
+	uint8_t x = (uint8_t)(crc >> 8) ^ data;
+	x ^= x >> 4;
+	return ((crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x);
+}
+
+// Encode a message into a frame which is ready to send, delimiter and all
+uint8_t frame_encode (uint8_t type, uint8_t seq, const uint8_t* p_payload,
+					  uint8_t length, uint8_t* p_frame);
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class decodes frames one byte at a time as they arrive.
+ *  \details The bytes of a frame are decoded as they come in, and the CRC is worked
+ *  out as they go, so each byte costs a few dozen instructions. Only a delimiter byte
+ *  which ends a good frame costs more, as the message is copied into a queue, and
+ *  that copy is never more than \c FRAME_RAW_MAX bytes. Nothing ever waits, so
+ *  \c feed() can be called from a receive interrupt service routine, with a task
+ *  taking the messages out with \c get(). The queue is a \c SpscRing, so there must
+ *  be only one caller of \c feed() and one of \c get().
+ *
+ *  Frames which are too long, which end part way through a COBS block, or whose CRC
+ *  is wrong are thrown away and counted. The sequence number of each good message is
+ *  checked against the one before, and a gap counts the messages which went missing
+ *  on the way. Counts are written by the caller of \c feed(); a two-byte count read
+ *  by a task while an interrupt is changing it might rarely be wrong.
+ *
+ *  \section Usage
+ *  \code
+ *  frame_decoder link;                       // Shared by the ISR and the task
+ *  ...
+ *  link.feed (UDR0);                         // Called from the receive ISR
+ *  ...
+ *  frame_message msg;                        // The task reads the messages
+ *  while (link.get (msg))
+ *  {
+ *      ...do something with msg...
+ *  }
+ *  \endcode
+ */
+
+class frame_decoder
+{
+	protected:
+		/// The message being decoded, followed by its CRC
+		uint8_t raw[FRAME_RAW_MAX];
+
+		/// The number of bytes which have been decoded into \c raw
+		uint8_t fill;
+
+		/// The number of data bytes left in the current COBS block
+		uint8_t block_left;
+
+		/// True if a zero byte goes after the current COBS block
+		bool zero_next;
+
+		/// True while bytes are being thrown away until the next delimiter
+		bool skipping;
+
+		/// The CRC of the bytes in \c raw so far
+		uint16_t crc;
+
+		/// The sequence number which the next message should have
+		uint8_t next_seq;
+
+		/// True once a message has been received, so \c next_seq means something
+		bool seq_known;
+
+		/// Messages which have been decoded, waiting for a task to read them
+		SpscRing<frame_message, FRAME_QUEUE_SIZE> ready;
+
+		uint32_t good_count;				///< Good messages received
+		uint16_t crc_errors;				///< Frames thrown away because of a bad CRC
+		uint16_t framing_errors;			///< Frames too long, short, or cut off
+		uint16_t lost_count;				///< Messages missing from the sequence
+
+		// Put a decoded byte into the message and the CRC
+		void store (uint8_t data);
+
+		// Check a finished frame and queue its message if it's good
+		void finish (void);
+
+		// Get ready for the first byte of a new frame
+		void restart (void);
+
+	public:
+		// Make a decoder which waits for a delimiter before decoding anything
+		frame_decoder (void);
+
+		// Decode one received byte, returning true if it finished a good message
+		bool feed (uint8_t data);
+
+		/** This method gets the oldest message which has been decoded. It must only
+		 *  be called by the one task which reads messages.
+		 *  @param msg A reference to a place where the message will be copied
+		 *  @return True if there was a message, false if none were waiting
+		 */
+		bool get (frame_message& msg)
+		{
+			return (ready.get (msg));
+		}
+
+		/** This method returns the number of good messages which have been received.
+		 *  @return The number of messages with good CRCs
+		 */
+		uint32_t get_good_count (void)
+		{
+			return (good_count);
+		}
+
+		/** This method returns the number of frames with bad CRCs.
+		 *  @return The number of frames thrown away for bad CRCs
+		 */
+		uint16_t get_crc_errors (void)
+		{
+			return (crc_errors);
+		}
+
+		/** This method returns the number of frames which were too long or short or
+		 *  which were cut off part way through.
+		 *  @return The number of badly framed frames thrown away
+		 */
+		uint16_t get_framing_errors (void)
+		{
+			return (framing_errors);
+		}
+
+		/** This method returns the number of messages which never arrived, as found
+		 *  from gaps in the sequence numbers of the messages which did.
+		 *  @return The number of messages lost
+		 */
+		uint16_t get_lost_count (void)
+		{
+			return (lost_count);
+		}
+
+		/** This method returns the number of good messages which were thrown away
+		 *  because the task hadn't read the ones before them.
+		 *  @return The number of messages dropped because the queue was full
+		 */
+		uint16_t get_overflows (void)
+		{
+			return (ready.get_overflows ());
+		}
+
+		// Print the numbers of good messages and errors
+		void print_status (emstream* p_ser_dev);
+};
+
+#endif // _FRAME_CODEC_H_
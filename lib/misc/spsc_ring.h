@@ -0,0 +1,319 @@
+//*************************************************************************************
+/** \file spsc_ring.h
+ *    This file implements a ring buffer through which one producer, such as an
+ *    interrupt service routine, hands data to one consumer, such as a task, without
+ *    either of them having to turn interrupts off. Unlike a \c circ_buffer, which
+ *    keeps a count of items that both sides change, each index in a \c SpscRing is
+ *    only ever written by one side, so the two sides can't interfere with each other.
+ *
+ *  Usage:
+ *    The template specifies the following:
+ *      \li The type of data being stored in the buffer is \c DataType.
+ *      \li The number of data items in the buffer is \c size, which must be a power
+ *          of two such as 16, 32 or 64, and no more than 128.
+ *    For example, a buffer for characters received by a serial port could be declared
+ *    as \c SpscRing<uint8_t,\c 32> \c rcv_ring.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, based on \c circ_buffer
+ *    \li 10-16-2026 ERR Size limited to 128 so the indices are always one byte
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+#include <stdint.h>                         // Standard integer types
+#include <stddef.h>                         // For size_t
+#include <avr/cpufunc.h>                    // For the compiler memory barrier
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class implements a lock-free first-in, first-out ring buffer with one
+ *  producer and one consumer.
+ *  \details The producer, usually an interrupt service routine, puts items in with
+ *  \c put() or \c put_many(); the consumer, usually a task, takes them out with
+ *  \c get() or \c get_many(). Only the producer writes the index \c i_put and only
+ *  the consumer writes the index \c i_get, and each side only moves its index after
+ *  the data has been copied, with a memory barrier in between so that the compiler
+ *  can't change the order. No critical sections are needed as long as there's only
+ *  one producer and one consumer; if several tasks put data into the same buffer,
+ *  they must take turns by some other means.
+ *
+ *  The size of the buffer must be a power of two so that the indices can be wrapped
+ *  with a bit mask rather than a slow division. The indices count up without being
+ *  wrapped and the number of items is found by subtracting them, so one-byte indices
+ *  allow up to 128 items. The size is limited to that because the AVR reads and
+ *  writes a byte in one instruction: a two-byte index which the task was half way
+ *  through writing when the ISR read it would be torn, and no second look by the ISR
+ *  could tell. A size which isn't a power of two, or is over 128, causes a compiler
+ *  error. All \c size places in the buffer can be filled.
+ *
+ *  If the buffer is full when the producer tries to put an item in, the new item is
+ *  thrown away and counted. The oldest item can't be thrown away instead because
+ *  only the consumer may move \c i_get. The producer also keeps track of the largest
+ *  number of items which have been in the buffer, which helps in choosing its size.
+ *
+ *  \section Usage
+ *  \code
+ *  SpscRing<uint8_t, 32> rcv_ring;           // Shared by the ISR and the task
+ *  ...
+ *  ISR (USART0_RX_vect)                      // The ISR is the producer
+ *  {
+ *      rcv_ring.put (UDR0);
+ *  }
+ *  ...
+ *  uint8_t a_char;                           // The task is the consumer
+ *  if (rcv_ring.get (a_char))
+ *  {
+ *      ...do something with a_char...
+ *  }
+ *  \endcode
+ */
+
+template <class DataType, size_t size>
+class SpscRing
+{
+	public:
+		/// The type of the indices, one byte so each side reads the other's at once
+		typedef uint8_t index_t;
+
+	protected:
+		/** This type causes a compiler error (an array with negative size) if the
+		 *  size of the buffer isn't a power of two or is too large for the indices.
+		 */
+		typedef char size_must_be_a_power_of_two
+			[((size & (size - 1)) == 0 && size > 0 && size <= 128U) ? 1 : -1];
+
+		DataType buffer[size];              ///< This memory buffer holds the contents
+		volatile index_t i_put;             ///< Count of items put in, by the producer
+		volatile index_t i_get;             ///< Count of items taken out, by the consumer
+		uint16_t overflows;                 ///< Items thrown away because of no room
+		index_t peak;                       ///< Largest number of items in the buffer
+
+	public:
+		/** This constructor creates an empty ring buffer. The memory for the data was
+		 *  allocated by the template mechanism at compile time.
+		 */
+		SpscRing (void)
+		{
+			i_put = 0;
+			i_get = 0;
+			overflows = 0;
+			peak = 0;
+		}
+
+		bool put (const DataType& item);    // Producer puts an item into the buffer
+		bool get (DataType& item);          // Consumer takes an item out of the buffer
+
+		// Producer puts as many items as will fit into the buffer
+		size_t put_many (const DataType* p_items, size_t count);
+
+		// Consumer takes up to the given number of items out of the buffer
+		size_t get_many (DataType* p_items, size_t count);
+
+		/** This method returns the number of items in the buffer. It may be called by
+		 *  either side; the number may change as soon as it has been read.
+		 *  @return The number of items currently in the buffer
+		 */
+		index_t num_items (void)
+		{
+			return ((index_t)(i_put - i_get));
+		}
+
+		/** This method returns true if the buffer is empty.
+		 *  @return True if there's nothing in the buffer, false if there's data
+		 */
+		bool is_empty (void)
+		{
+			return (i_put == i_get);
+		}
+
+		/** This method returns true if the buffer is full.
+		 *  @return True if the buffer is full, false if there is empty space left
+		 */
+		bool is_full (void)
+		{
+			return (num_items () >= size);
+		}
+
+		/** This method throws away everything in the buffer. It may only be called by
+		 *  the consumer.
+		 */
+		void flush (void)
+		{
+			i_get = i_put;
+		}
+
+		/** This method returns the number of items which were thrown away because the
+		 *  buffer was full when the producer tried to put them in. The count stops at
+		 *  its largest value rather than going back to zero. It's written by the
+		 *  producer, so if the producer is an ISR, a two-byte count read by a task
+		 *  might rarely be wrong.
+		 *  @return The number of items which have been thrown away
+		 */
+		uint16_t get_overflows (void)
+		{
+			return (overflows);
+		}
+
+		/** This method returns the largest number of items which have been in the
+		 *  buffer at one time. If it's the same as the size of the buffer, data may
+		 *  have been lost and a larger buffer may be needed.
+		 *  @return The peak number of items in the buffer
+		 */
+		index_t get_peak (void)
+		{
+			return (peak);
+		}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts an item into the buffer. It must only be called by the producer.
+ *  The item is copied into the buffer before \c i_put is moved, so the consumer can't
+ *  see the new item until it's all there.
+ *  @param item A reference to the item to be put into the buffer
+ *  @return True if the item was put in, false if the buffer was full
+ */
+
+template <class DataType, size_t size>
+bool SpscRing<DataType, size>::put (const DataType& item)
+{
+	index_t put_now = i_put;				// Only the producer changes this index
+	index_t waiting = put_now - i_get;
+
+	if (waiting >= size)
+	{
+		if (overflows < 0xFFFF)
+		{
+			overflows++;
+		}
+		return (false);
+	}
+
+	buffer[put_now & (size - 1)] = item;
+	_MemoryBarrier ();
+	i_put = put_now + 1;
+
+	if (++waiting > peak)
+	{
+		peak = waiting;
+	}
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method takes the oldest item out of the buffer. It must only be called by the
+ *  consumer. The item is copied out before \c i_get is moved, so the producer can't
+ *  write over it while it's being copied.
+ *  @param item A reference to a place where the item will be copied
+ *  @return True if an item was taken out, false if the buffer was empty
+ */
+
+template <class DataType, size_t size>
+bool SpscRing<DataType, size>::get (DataType& item)
+{
+	index_t get_now = i_get;				// Only the consumer changes this index
+
+	if (get_now == i_put)
+	{
+		return (false);
+	}
+
+	_MemoryBarrier ();
+	item = buffer[get_now & (size - 1)];
+	_MemoryBarrier ();
+	i_get = get_now + 1;
+
+	return (true);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts a block of items into the buffer at once. It must only be called
+ *  by the producer. As many items as there is room for are copied, then \c i_put is
+ *  moved once, so the consumer sees the whole block arrive together. Items which
+ *  don't fit are thrown away and counted as overflows.
+ *  @param p_items Pointer to the first of the items to be put into the buffer
+ *  @param count The number of items to be put into the buffer
+ *  @return The number of items which were put in
+ */
+
+template <class DataType, size_t size>
+size_t SpscRing<DataType, size>::put_many (const DataType* p_items, size_t count)
+{
+	index_t put_now = i_put;				// Only the producer changes this index
+	index_t waiting = put_now - i_get;
+	size_t room = size - waiting;
+
+	if (count > room)
+	{
+		size_t lost = count - room;
+		overflows = (lost > (size_t)(0xFFFF - overflows)) ? 0xFFFF : overflows + lost;
+		count = room;
+	}
+
+	for (size_t index = 0; index < count; index++)
+	{
+		buffer[(index_t)(put_now + index) & (size - 1)] = p_items[index];
+	}
+	_MemoryBarrier ();
+	i_put = put_now + count;
+
+	waiting += count;
+	if (waiting > peak)
+	{
+		peak = waiting;
+	}
+	return (count);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method takes a block of items out of the buffer at once. It must only be
+ *  called by the consumer. The items are copied out, then \c i_get is moved once.
+ *  @param p_items Pointer to memory with room for at least \c count items
+ *  @param count The largest number of items to be taken out
+ *  @return The number of items which were taken out, which may be zero
+ */
+
+template <class DataType, size_t size>
+size_t SpscRing<DataType, size>::get_many (DataType* p_items, size_t count)
+{
+	index_t get_now = i_get;				// Only the consumer changes this index
+	size_t waiting = (index_t)(i_put - get_now);
+
+	if (count > waiting)
+	{
+		count = waiting;
+	}
+
+	_MemoryBarrier ();
+	for (size_t index = 0; index < count; index++)
+	{
+		p_items[index] = buffer[(index_t)(get_now + index) & (size - 1)];
+	}
+	_MemoryBarrier ();
+	i_get = get_now + count;
+
+	return (count);
+}
+
+#endif // _SPSC_RING_H_
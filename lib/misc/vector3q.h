@@ -0,0 +1,187 @@
+//*************************************************************************************
+/** \file vector3q.h
+ *    This file contains a small three-axis vector which holds fixed-point numbers,
+ *    and a class which converts raw sensor counts into fixed-point numbers. An AVR
+ *    has no floating point hardware, so every division such as \c x \c / \c 100.0 is
+ *    done by a software routine which takes hundreds of processor cycles and pulls
+ *    the floating point library into the program. Fixed-point numbers are integers
+ *    with an implied binary point, so they're converted and added with the ordinary
+ *    integer instructions.
+ *
+ *  Usage:
+ *    A fixed-point number with \c frac_bits bits after the binary point is sometimes
+ *    called a "Q" number; a \c Vector3q<int16_t,\c 4> holds numbers in Q4 format, so
+ *    a stored value of 72 means 72 / 2^4 = 4.5. Raw sensor counts are changed to
+ *    Q format by \c FixedScale<lsb_per_unit,\c frac_bits>::to_q(), which multiplies
+ *    by a constant computed by the compiler and shifts right. Conversion to a
+ *    floating point vector is only done when \c to_vector() is called.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included more than once in a .cpp file
+#ifndef _VECTOR3Q_H_
+#define _VECTOR3Q_H_
+
+#include <stdint.h>                         // Standard integer types
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class converts raw sensor counts into fixed-point numbers.
+ *  \details A sensor which gives \c lsb_per_unit counts per unit (for example 100
+ *  counts per m/s^2) is converted to a number with \c frac_bits fractional bits by
+ *  multiplying by \c MULT = 2^(frac_bits + shift) / lsb_per_unit and shifting right
+ *  by \c shift bits. All of these are constants, so the compiler does the division
+ *  once when the program is compiled. When \c lsb_per_unit is exactly 2^frac_bits,
+ *  \c MULT is 2^shift and the raw count is already in the right format, so nothing
+ *  at all is done.
+ *
+ *  The product of a 16-bit count and \c MULT must fit in 32 bits, so \c MULT must be
+ *  less than 65536; the program won't compile if it isn't. The \c shift should be as
+ *  large as that allows, to keep \c MULT precise.
+ */
+
+template <int32_t lsb_per_unit, uint8_t frac_bits, uint8_t shift = 16>
+struct FixedScale
+{
+	/// The number of fractional bits in the result
+	enum { FRAC_BITS = frac_bits };
+
+	/// The constant by which raw counts are multiplied, rounded to the nearest integer
+	static const int32_t MULT = ((((int32_t)1 << (frac_bits + shift)) + lsb_per_unit / 2)
+								 / lsb_per_unit);
+
+	/// The compiler makes this an array of -1 elements, an error, if \c MULT is too big
+	typedef char mult_fits_in_16_bits[(MULT < 65536L) ? 1 : -1];
+
+	/** @brief   Convert a raw sensor count into a fixed-point number.
+	 *  @param   raw The count from the sensor
+	 *  @return  The same measurement with @c frac_bits fractional bits
+	 */
+	static int16_t to_q (int16_t raw)
+	{
+		if (MULT == ((int32_t)1 << shift))
+		{
+			return (raw);
+		}
+		return ((int16_t)(((int32_t)raw * MULT) >> shift));
+	}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This class holds a three-axis vector of fixed-point numbers.
+ *  \details Each element is an integer of type \c IntType whose lowest \c frac_bits
+ *  bits are the fractional part. Addition and subtraction work on the integers
+ *  directly. A floating point vector, such as an \c imu::Vector<3>, is only made when
+ *  \c to_vector() is called, and that multiplies by a constant instead of dividing.
+ */
+
+template <class IntType, uint8_t frac_bits> class Vector3q
+{
+public:
+	/// The number of fractional bits in each element
+	enum { FRAC_BITS = frac_bits };
+
+	/// The three elements, usually X, Y and Z or heading, roll and pitch
+	IntType data[3];
+
+	/** @brief   Create a vector with all its elements zero.
+	 */
+	Vector3q (void)
+	{
+		data[0] = data[1] = data[2] = 0;
+	}
+
+	/** @brief   Create a vector from three fixed-point numbers.
+	 *  @param   x The first element, already in fixed-point format
+	 *  @param   y The second element
+	 *  @param   z The third element
+	 */
+	Vector3q (IntType x, IntType y, IntType z)
+	{
+		data[0] = x;
+		data[1] = y;
+		data[2] = z;
+	}
+
+	/** @brief   Get a reference to one element of the vector.
+	 *  @param   index The number of the element, 0 to 2
+	 *  @return  A reference to the element in fixed-point format
+	 */
+	IntType& operator[] (uint8_t index)
+	{
+		return (data[index]);
+	}
+
+	/** @brief   Get one element of the vector.
+	 *  @param   index The number of the element, 0 to 2
+	 *  @return  The element in fixed-point format
+	 */
+	IntType operator[] (uint8_t index) const
+	{
+		return (data[index]);
+	}
+
+	/** @brief   Get the whole number part of one element, rounded toward minus
+	 *           infinity as the arithmetic shift does.
+	 *  @param   index The number of the element, 0 to 2
+	 *  @return  The integer part of the element
+	 */
+	IntType whole (uint8_t index) const
+	{
+		return (data[index] >> frac_bits);
+	}
+
+	/** @brief   Add another vector with the same format to this one.
+	 *  @param   other The vector to be added
+	 *  @return  The sum of the two vectors
+	 */
+	Vector3q operator + (const Vector3q& other) const
+	{
+		return (Vector3q (data[0] + other.data[0], data[1] + other.data[1],
+						  data[2] + other.data[2]));
+	}
+
+	/** @brief   Subtract another vector with the same format from this one.
+	 *  @param   other The vector to be subtracted
+	 *  @return  The difference of the two vectors
+	 */
+	Vector3q operator - (const Vector3q& other) const
+	{
+		return (Vector3q (data[0] - other.data[0], data[1] - other.data[1],
+						  data[2] - other.data[2]));
+	}
+
+	/** @brief   Make a floating point vector with the same values as this one.
+	 *  @details This is the only place where floating point arithmetic is used, so
+	 *           programs which never call it don't need the floating point library
+	 *           for their vectors. The vector type must have a constructor which
+	 *           takes three numbers, as @c imu::Vector<3> does.
+	 *  @return  A floating point vector of type @c VectorType
+	 */
+	template <class VectorType> VectorType to_vector (void) const
+	{
+		const double scale = 1.0 / (double)((int32_t)1 << frac_bits);
+
+		return (VectorType (data[0] * scale, data[1] * scale, data[2] * scale));
+	}
+};
+
+#endif // _VECTOR3Q_H_
@@ -0,0 +1,32 @@
+//*************************************************************************************
+/** @file    avr/cpufunc.h
+ *  @brief   Stand-in for the avr-libc CPU function header when compiling for a PC host.
+ *  @details The AVR's \c nop instruction is used to wait a cycle for pins to settle;
+ *           on the host it only needs to stop the compiler from moving memory accesses.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _AVR_CPUFUNC_H_
+#define _AVR_CPUFUNC_H_
+
+#define _NOP()                  __asm__ __volatile__ ("nop" ::: "memory")
+#define _MemoryBarrier()        __asm__ __volatile__ ("" ::: "memory")
+
+#endif // _AVR_CPUFUNC_H_
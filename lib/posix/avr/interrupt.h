@@ -0,0 +1,89 @@
+//*************************************************************************************
+/** @file    avr/interrupt.h
+ *  @brief   Stand-in for the avr-libc interrupt header when compiling for a PC host.
+ *  @details Interrupt service routines are compiled as ordinary C functions with the
+ *           names avr-libc would give them, so that simulated peripherals can call
+ *           them through vPortHostInterrupt(). The global interrupt enable and disable
+ *           instructions are passed to the host port's simulated interrupt flag.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _AVR_INTERRUPT_H_
+#define _AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// This function turns the simulated global interrupt enable on; it's in port.c
+extern void vPortEnableInterrupts (void);
+
+/// This function turns the simulated global interrupt enable off; it's in port.c
+extern void vPortDisableInterrupts (void);
+
+/// This function runs an interrupt service routine as if its interrupt had happened
+extern void vPortHostInterrupt (void (*pxISR)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+/// Enable interrupts globally, as the AVR's \c sei instruction does
+#define sei()                   vPortEnableInterrupts ()
+
+/// Disable interrupts globally, as the AVR's \c cli instruction does
+#define cli()                   vPortDisableInterrupts ()
+
+/// Return from an interrupt; on the host this is just a return from a function
+#define reti()                  return
+
+// Attributes which avr-libc allows in ISR() declarations. They don't do anything here
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define ISR_FLATTEN
+#define ISR_ALIASOF(v)
+
+#ifdef __cplusplus
+	#define __HOST_ISR_LINKAGE  extern "C"
+#else
+	#define __HOST_ISR_LINKAGE
+#endif
+
+/** This macro declares an interrupt service routine. The routine is an ordinary 
+ *  function which takes no parameters and returns nothing. 
+ */
+#define ISR(vector, ...) \
+	__HOST_ISR_LINKAGE void vector (void); \
+	void vector (void)
+
+/// This macro makes an interrupt service routine which does nothing at all
+#define EMPTY_INTERRUPT(vector) \
+	__HOST_ISR_LINKAGE void vector (void); \
+	void vector (void) { }
+
+/// This macro makes one interrupt vector call the service routine for another
+#define ISR_ALIAS(vector, target_vector) \
+	__HOST_ISR_LINKAGE void vector (void); \
+	void vector (void) { target_vector (); }
+
+#endif // _AVR_INTERRUPT_H_
@@ -0,0 +1,984 @@
+//*************************************************************************************
+/** @file    avr/io.h
+ *  @brief   Stand-in for the avr-libc I/O header when compiling for a PC host.
+ *  @details This file lets programs written for the ATmega1281 on the ME405 board be
+ *           compiled on a POSIX computer. Each special function register is given the
+ *           same name and address that it has on the AVR, but the registers live in an
+ *           ordinary block of memory which belongs to the host port in lib/posix/port.c.
+ *           Writing to a register therefore doesn't make any hardware do anything, and
+ *           flags which the hardware would set (such as a USART's "data register empty"
+ *           bit) must be set by whatever code is simulating that piece of hardware. The
+ *           exception is \c TCNT5, which is read from the port's simulated RTOS tick
+ *           timer so that time stamps have sub-tick resolution. 
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _AVR_IO_H_
+#define _AVR_IO_H_
+
+#include <stdint.h>
+
+#ifdef __AVR
+	#error "lib/posix/avr/io.h is only for PC hosts; use the avr-libc header on an AVR"
+#endif
+
+// The simulated processor is the one on the ME405 board
+#ifndef __AVR_ATmega1281__
+	#define __AVR_ATmega1281__
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// This is the number of bytes of (simulated) register space, which covers all of
+/// the I/O and extended I/O registers of an ATmega1281
+#define portHOST_SFR_SIZE   0x200
+
+/// This block of memory holds the simulated registers. It's defined in port.c
+extern volatile uint8_t ucPortHostSFR[portHOST_SFR_SIZE];
+
+/// This function returns the count in the simulated RTOS tick timer (Timer 5)
+extern uint16_t usPortHostTimerCount (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+//-------------------------------------------------------------------------------------
+// Register access macros, which work as they do in avr-libc's <avr/sfr_defs.h> except
+// that the addresses are offsets into the simulated register block
+
+#define _SFR_MEM8(mem_addr)     (*(volatile uint8_t*)(ucPortHostSFR + (mem_addr)))
+#define _SFR_MEM16(mem_addr)    (*(volatile uint16_t*)(ucPortHostSFR + (mem_addr)))
+#define _SFR_IO8(io_addr)       _SFR_MEM8 ((io_addr) + 0x20)
+#define _SFR_IO16(io_addr)      _SFR_MEM16 ((io_addr) + 0x20)
+#define _SFR_MEM_ADDR(sfr)      ((uint16_t)((volatile uint8_t*)&(sfr) - ucPortHostSFR))
+#define _SFR_IO_ADDR(sfr)       (_SFR_MEM_ADDR (sfr) - 0x20)
+#define _SFR_BYTE(sfr)          (sfr)
+#define _SFR_WORD(sfr)          (sfr)
+
+#ifndef _BV
+	#define _BV(bit)            (1 << (bit))
+#endif
+#define bit_is_set(sfr, bit)    (_SFR_BYTE (sfr) & _BV (bit))
+#define bit_is_clear(sfr, bit)  (!(_SFR_BYTE (sfr) & _BV (bit)))
+#define loop_until_bit_is_set(sfr, bit)   do { } while (bit_is_clear (sfr, bit))
+#define loop_until_bit_is_clear(sfr, bit) do { } while (bit_is_set (sfr, bit))
+
+// Memory sizes of the ATmega1281
+#define RAMSTART                0x200
+#define RAMEND                  0x21FF
+#define XRAMEND                 0xFFFF
+#define E2END                   0xFFF
+#define FLASHEND                0x1FFFF
+#define SPM_PAGESIZE            256
+
+
+//-------------------------------------------------------------------------------------
+// Digital I/O ports A through G
+
+#define PINA                    _SFR_MEM8 (0x20)
+#define DDRA                    _SFR_MEM8 (0x21)
+#define PORTA                   _SFR_MEM8 (0x22)
+#define PINB                    _SFR_MEM8 (0x23)
+#define DDRB                    _SFR_MEM8 (0x24)
+#define PORTB                   _SFR_MEM8 (0x25)
+#define PINC                    _SFR_MEM8 (0x26)
+#define DDRC                    _SFR_MEM8 (0x27)
+#define PORTC                   _SFR_MEM8 (0x28)
+#define PIND                    _SFR_MEM8 (0x29)
+#define DDRD                    _SFR_MEM8 (0x2A)
+#define PORTD                   _SFR_MEM8 (0x2B)
+#define PINE                    _SFR_MEM8 (0x2C)
+#define DDRE                    _SFR_MEM8 (0x2D)
+#define PORTE                   _SFR_MEM8 (0x2E)
+#define PINF                    _SFR_MEM8 (0x2F)
+#define DDRF                    _SFR_MEM8 (0x30)
+#define PORTF                   _SFR_MEM8 (0x31)
+#define PING                    _SFR_MEM8 (0x32)
+#define DDRG                    _SFR_MEM8 (0x33)
+#define PORTG                   _SFR_MEM8 (0x34)
+
+#define PA0 0
+#define PINA0 0
+#define DDA0 0
+#define PORTA0 0
+#define PA1 1
+#define PINA1 1
+#define DDA1 1
+#define PORTA1 1
+#define PA2 2
+#define PINA2 2
+#define DDA2 2
+#define PORTA2 2
+#define PA3 3
+#define PINA3 3
+#define DDA3 3
+#define PORTA3 3
+#define PA4 4
+#define PINA4 4
+#define DDA4 4
+#define PORTA4 4
+#define PA5 5
+#define PINA5 5
+#define DDA5 5
+#define PORTA5 5
+#define PA6 6
+#define PINA6 6
+#define DDA6 6
+#define PORTA6 6
+#define PA7 7
+#define PINA7 7
+#define DDA7 7
+#define PORTA7 7
+#define PB0 0
+#define PINB0 0
+#define DDB0 0
+#define PORTB0 0
+#define PB1 1
+#define PINB1 1
+#define DDB1 1
+#define PORTB1 1
+#define PB2 2
+#define PINB2 2
+#define DDB2 2
+#define PORTB2 2
+#define PB3 3
+#define PINB3 3
+#define DDB3 3
+#define PORTB3 3
+#define PB4 4
+#define PINB4 4
+#define DDB4 4
+#define PORTB4 4
+#define PB5 5
+#define PINB5 5
+#define DDB5 5
+#define PORTB5 5
+#define PB6 6
+#define PINB6 6
+#define DDB6 6
+#define PORTB6 6
+#define PB7 7
+#define PINB7 7
+#define DDB7 7
+#define PORTB7 7
+#define PC0 0
+#define PINC0 0
+#define DDC0 0
+#define PORTC0 0
+#define PC1 1
+#define PINC1 1
+#define DDC1 1
+#define PORTC1 1
+#define PC2 2
+#define PINC2 2
+#define DDC2 2
+#define PORTC2 2
+#define PC3 3
+#define PINC3 3
+#define DDC3 3
+#define PORTC3 3
+#define PC4 4
+#define PINC4 4
+#define DDC4 4
+#define PORTC4 4
+#define PC5 5
+#define PINC5 5
+#define DDC5 5
+#define PORTC5 5
+#define PC6 6
+#define PINC6 6
+#define DDC6 6
+#define PORTC6 6
+#define PC7 7
+#define PINC7 7
+#define DDC7 7
+#define PORTC7 7
+#define PD0 0
+#define PIND0 0
+#define DDD0 0
+#define PORTD0 0
+#define PD1 1
+#define PIND1 1
+#define DDD1 1
+#define PORTD1 1
+#define PD2 2
+#define PIND2 2
+#define DDD2 2
+#define PORTD2 2
+#define PD3 3
+#define PIND3 3
+#define DDD3 3
+#define PORTD3 3
+#define PD4 4
+#define PIND4 4
+#define DDD4 4
+#define PORTD4 4
+#define PD5 5
+#define PIND5 5
+#define DDD5 5
+#define PORTD5 5
+#define PD6 6
+#define PIND6 6
+#define DDD6 6
+#define PORTD6 6
+#define PD7 7
+#define PIND7 7
+#define DDD7 7
+#define PORTD7 7
+#define PE0 0
+#define PINE0 0
+#define DDE0 0
+#define PORTE0 0
+#define PE1 1
+#define PINE1 1
+#define DDE1 1
+#define PORTE1 1
+#define PE2 2
+#define PINE2 2
+#define DDE2 2
+#define PORTE2 2
+#define PE3 3
+#define PINE3 3
+#define DDE3 3
+#define PORTE3 3
+#define PE4 4
+#define PINE4 4
+#define DDE4 4
+#define PORTE4 4
+#define PE5 5
+#define PINE5 5
+#define DDE5 5
+#define PORTE5 5
+#define PE6 6
+#define PINE6 6
+#define DDE6 6
+#define PORTE6 6
+#define PE7 7
+#define PINE7 7
+#define DDE7 7
+#define PORTE7 7
+#define PF0 0
+#define PINF0 0
+#define DDF0 0
+#define PORTF0 0
+#define PF1 1
+#define PINF1 1
+#define DDF1 1
+#define PORTF1 1
+#define PF2 2
+#define PINF2 2
+#define DDF2 2
+#define PORTF2 2
+#define PF3 3
+#define PINF3 3
+#define DDF3 3
+#define PORTF3 3
+#define PF4 4
+#define PINF4 4
+#define DDF4 4
+#define PORTF4 4
+#define PF5 5
+#define PINF5 5
+#define DDF5 5
+#define PORTF5 5
+#define PF6 6
+#define PINF6 6
+#define DDF6 6
+#define PORTF6 6
+#define PF7 7
+#define PINF7 7
+#define DDF7 7
+#define PORTF7 7
+#define PG0 0
+#define PING0 0
+#define DDG0 0
+#define PORTG0 0
+#define PG1 1
+#define PING1 1
+#define DDG1 1
+#define PORTG1 1
+#define PG2 2
+#define PING2 2
+#define DDG2 2
+#define PORTG2 2
+#define PG3 3
+#define PING3 3
+#define DDG3 3
+#define PORTG3 3
+#define PG4 4
+#define PING4 4
+#define DDG4 4
+#define PORTG4 4
+#define PG5 5
+#define PING5 5
+#define DDG5 5
+#define PORTG5 5
+
+
+//-------------------------------------------------------------------------------------
+// Interrupt flag and mask registers, status register, and other system registers
+
+#define TIFR0                   _SFR_MEM8 (0x35)
+#define TIFR1                   _SFR_MEM8 (0x36)
+#define TIFR2                   _SFR_MEM8 (0x37)
+#define TIFR3                   _SFR_MEM8 (0x38)
+#define TIFR4                   _SFR_MEM8 (0x39)
+#define TIFR5                   _SFR_MEM8 (0x3A)
+#define PCIFR                   _SFR_MEM8 (0x3B)
+#define EIFR                    _SFR_MEM8 (0x3C)
+#define EIMSK                   _SFR_MEM8 (0x3D)
+#define GPIOR0                  _SFR_MEM8 (0x3E)
+#define EECR                    _SFR_MEM8 (0x3F)
+#define EEDR                    _SFR_MEM8 (0x40)
+#define EEAR                    _SFR_MEM16 (0x41)
+#define EEARL                   _SFR_MEM8 (0x41)
+#define EEARH                   _SFR_MEM8 (0x42)
+#define GTCCR                   _SFR_MEM8 (0x43)
+#define GPIOR1                  _SFR_MEM8 (0x4A)
+#define GPIOR2                  _SFR_MEM8 (0x4B)
+#define ACSR                    _SFR_MEM8 (0x50)
+#define SMCR                    _SFR_MEM8 (0x53)
+#define MCUSR                   _SFR_MEM8 (0x54)
+#define MCUCR                   _SFR_MEM8 (0x55)
+#define SPMCSR                  _SFR_MEM8 (0x57)
+#define RAMPZ                   _SFR_MEM8 (0x5B)
+#define SP                      _SFR_MEM16 (0x5D)
+#define SPL                     _SFR_MEM8 (0x5D)
+#define SPH                     _SFR_MEM8 (0x5E)
+#define SREG                    _SFR_MEM8 (0x5F)
+#define WDTCSR                  _SFR_MEM8 (0x60)
+#define CLKPR                   _SFR_MEM8 (0x61)
+#define PRR0                    _SFR_MEM8 (0x64)
+#define PRR1                    _SFR_MEM8 (0x65)
+#define OSCCAL                  _SFR_MEM8 (0x66)
+#define PCICR                   _SFR_MEM8 (0x68)
+#define EICRA                   _SFR_MEM8 (0x69)
+#define EICRB                   _SFR_MEM8 (0x6A)
+#define PCMSK0                  _SFR_MEM8 (0x6B)
+#define PCMSK1                  _SFR_MEM8 (0x6C)
+#define PCMSK2                  _SFR_MEM8 (0x6D)
+#define TIMSK0                  _SFR_MEM8 (0x6E)
+#define TIMSK1                  _SFR_MEM8 (0x6F)
+#define TIMSK2                  _SFR_MEM8 (0x70)
+#define TIMSK3                  _SFR_MEM8 (0x71)
+#define TIMSK4                  _SFR_MEM8 (0x72)
+#define TIMSK5                  _SFR_MEM8 (0x73)
+#define XMCRA                   _SFR_MEM8 (0x74)
+#define XMCRB                   _SFR_MEM8 (0x75)
+
+//-------------------------------------------------------------------------------------
+// SPI port
+
+#define SPCR                    _SFR_MEM8 (0x4C)
+#define SPSR                    _SFR_MEM8 (0x4D)
+#define SPDR                    _SFR_MEM8 (0x4E)
+
+//-------------------------------------------------------------------------------------
+// A/D converter
+
+#define ADC                     _SFR_MEM16 (0x78)
+#define ADCW                    _SFR_MEM16 (0x78)
+#define ADCL                    _SFR_MEM8 (0x78)
+#define ADCH                    _SFR_MEM8 (0x79)
+#define ADCSRA                  _SFR_MEM8 (0x7A)
+#define ADCSRB                  _SFR_MEM8 (0x7B)
+#define ADMUX                   _SFR_MEM8 (0x7C)
+#define DIDR2                   _SFR_MEM8 (0x7D)
+#define DIDR0                   _SFR_MEM8 (0x7E)
+#define DIDR1                   _SFR_MEM8 (0x7F)
+
+//-------------------------------------------------------------------------------------
+// 8-bit timers 0 and 2
+
+#define TCCR0A                  _SFR_MEM8 (0x44)
+#define TCCR0B                  _SFR_MEM8 (0x45)
+#define TCNT0                   _SFR_MEM8 (0x46)
+#define OCR0A                   _SFR_MEM8 (0x47)
+#define OCR0B                   _SFR_MEM8 (0x48)
+#define TCCR2A                  _SFR_MEM8 (0xB0)
+#define TCCR2B                  _SFR_MEM8 (0xB1)
+#define TCNT2                   _SFR_MEM8 (0xB2)
+#define OCR2A                   _SFR_MEM8 (0xB3)
+#define OCR2B                   _SFR_MEM8 (0xB4)
+#define ASSR                    _SFR_MEM8 (0xB6)
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 1
+
+#define TCCR1A                  _SFR_MEM8 (0x80)
+#define TCCR1B                  _SFR_MEM8 (0x81)
+#define TCCR1C                  _SFR_MEM8 (0x82)
+#define TCNT1                   _SFR_MEM16 (0x84)
+#define TCNT1L                  _SFR_MEM8 (0x84)
+#define TCNT1H                  _SFR_MEM8 (0x85)
+#define ICR1                    _SFR_MEM16 (0x86)
+#define ICR1L                   _SFR_MEM8 (0x86)
+#define ICR1H                   _SFR_MEM8 (0x87)
+#define OCR1A                   _SFR_MEM16 (0x88)
+#define OCR1AL                  _SFR_MEM8 (0x88)
+#define OCR1AH                  _SFR_MEM8 (0x89)
+#define OCR1B                   _SFR_MEM16 (0x8A)
+#define OCR1BL                  _SFR_MEM8 (0x8A)
+#define OCR1BH                  _SFR_MEM8 (0x8B)
+#define OCR1C                   _SFR_MEM16 (0x8C)
+#define OCR1CL                  _SFR_MEM8 (0x8C)
+#define OCR1CH                  _SFR_MEM8 (0x8D)
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 3
+
+#define TCCR3A                  _SFR_MEM8 (0x90)
+#define TCCR3B                  _SFR_MEM8 (0x91)
+#define TCCR3C                  _SFR_MEM8 (0x92)
+#define TCNT3                   _SFR_MEM16 (0x94)
+#define TCNT3L                  _SFR_MEM8 (0x94)
+#define TCNT3H                  _SFR_MEM8 (0x95)
+#define ICR3                    _SFR_MEM16 (0x96)
+#define ICR3L                   _SFR_MEM8 (0x96)
+#define ICR3H                   _SFR_MEM8 (0x97)
+#define OCR3A                   _SFR_MEM16 (0x98)
+#define OCR3AL                  _SFR_MEM8 (0x98)
+#define OCR3AH                  _SFR_MEM8 (0x99)
+#define OCR3B                   _SFR_MEM16 (0x9A)
+#define OCR3BL                  _SFR_MEM8 (0x9A)
+#define OCR3BH                  _SFR_MEM8 (0x9B)
+#define OCR3C                   _SFR_MEM16 (0x9C)
+#define OCR3CL                  _SFR_MEM8 (0x9C)
+#define OCR3CH                  _SFR_MEM8 (0x9D)
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 4
+
+#define TCCR4A                  _SFR_MEM8 (0xA0)
+#define TCCR4B                  _SFR_MEM8 (0xA1)
+#define TCCR4C                  _SFR_MEM8 (0xA2)
+#define TCNT4                   _SFR_MEM16 (0xA4)
+#define TCNT4L                  _SFR_MEM8 (0xA4)
+#define TCNT4H                  _SFR_MEM8 (0xA5)
+#define ICR4                    _SFR_MEM16 (0xA6)
+#define ICR4L                   _SFR_MEM8 (0xA6)
+#define ICR4H                   _SFR_MEM8 (0xA7)
+#define OCR4A                   _SFR_MEM16 (0xA8)
+#define OCR4AL                  _SFR_MEM8 (0xA8)
+#define OCR4AH                  _SFR_MEM8 (0xA9)
+#define OCR4B                   _SFR_MEM16 (0xAA)
+#define OCR4BL                  _SFR_MEM8 (0xAA)
+#define OCR4BH                  _SFR_MEM8 (0xAB)
+#define OCR4C                   _SFR_MEM16 (0xAC)
+#define OCR4CL                  _SFR_MEM8 (0xAC)
+#define OCR4CH                  _SFR_MEM8 (0xAD)
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 5
+
+#define TCCR5A                  _SFR_MEM8 (0x120)
+#define TCCR5B                  _SFR_MEM8 (0x121)
+#define TCCR5C                  _SFR_MEM8 (0x122)
+
+/// The Timer 5 counter is read from the simulated RTOS tick timer, so it can only be
+/// read; the RTOS owns this timer on the ME405 board and nobody else should write it
+#define TCNT5                   (usPortHostTimerCount ())
+#define TCNT5L                  _SFR_MEM8 (0x124)
+#define TCNT5H                  _SFR_MEM8 (0x125)
+#define ICR5                    _SFR_MEM16 (0x126)
+#define ICR5L                   _SFR_MEM8 (0x126)
+#define ICR5H                   _SFR_MEM8 (0x127)
+#define OCR5A                   _SFR_MEM16 (0x128)
+#define OCR5AL                  _SFR_MEM8 (0x128)
+#define OCR5AH                  _SFR_MEM8 (0x129)
+#define OCR5B                   _SFR_MEM16 (0x12A)
+#define OCR5BL                  _SFR_MEM8 (0x12A)
+#define OCR5BH                  _SFR_MEM8 (0x12B)
+#define OCR5C                   _SFR_MEM16 (0x12C)
+#define OCR5CL                  _SFR_MEM8 (0x12C)
+#define OCR5CH                  _SFR_MEM8 (0x12D)
+
+//-------------------------------------------------------------------------------------
+// Two-wire (I2C) interface
+
+#define TWBR                    _SFR_MEM8 (0xB8)
+#define TWSR                    _SFR_MEM8 (0xB9)
+#define TWAR                    _SFR_MEM8 (0xBA)
+#define TWDR                    _SFR_MEM8 (0xBB)
+#define TWCR                    _SFR_MEM8 (0xBC)
+#define TWAMR                   _SFR_MEM8 (0xBD)
+
+//-------------------------------------------------------------------------------------
+// USART 0
+
+#define UCSR0A                  _SFR_MEM8 (0xC0)
+#define UCSR0B                  _SFR_MEM8 (0xC1)
+#define UCSR0C                  _SFR_MEM8 (0xC2)
+#define UBRR0                   _SFR_MEM16 (0xC4)
+#define UBRR0L                  _SFR_MEM8 (0xC4)
+#define UBRR0H                  _SFR_MEM8 (0xC5)
+#define UDR0                    _SFR_MEM8 (0xC6)
+
+//-------------------------------------------------------------------------------------
+// USART 1
+
+#define UCSR1A                  _SFR_MEM8 (0xC8)
+#define UCSR1B                  _SFR_MEM8 (0xC9)
+#define UCSR1C                  _SFR_MEM8 (0xCA)
+#define UBRR1                   _SFR_MEM16 (0xCC)
+#define UBRR1L                  _SFR_MEM8 (0xCC)
+#define UBRR1H                  _SFR_MEM8 (0xCD)
+#define UDR1                    _SFR_MEM8 (0xCE)
+
+
+//=====================================================================================
+// Bit numbers within the registers
+
+
+//-------------------------------------------------------------------------------------
+// Status register
+
+#define SREG_C                  0
+#define SREG_Z                  1
+#define SREG_N                  2
+#define SREG_V                  3
+#define SREG_S                  4
+#define SREG_H                  5
+#define SREG_T                  6
+#define SREG_I                  7
+
+//-------------------------------------------------------------------------------------
+// External interrupts
+
+#define INT0                    0
+#define INT1                    1
+#define INT2                    2
+#define INT3                    3
+#define INT4                    4
+#define INT5                    5
+#define INT6                    6
+#define INT7                    7
+#define INTF0                   0
+#define INTF1                   1
+#define INTF2                   2
+#define INTF3                   3
+#define INTF4                   4
+#define INTF5                   5
+#define INTF6                   6
+#define INTF7                   7
+#define ISC00                   0
+#define ISC01                   1
+#define ISC10                   2
+#define ISC11                   3
+#define ISC20                   4
+#define ISC21                   5
+#define ISC30                   6
+#define ISC31                   7
+#define ISC40                   0
+#define ISC41                   1
+#define ISC50                   2
+#define ISC51                   3
+#define ISC60                   4
+#define ISC61                   5
+#define ISC70                   6
+#define ISC71                   7
+#define PCIE0                   0
+#define PCIE1                   1
+#define PCIE2                   2
+#define PCIF0                   0
+#define PCIF1                   1
+#define PCIF2                   2
+
+//-------------------------------------------------------------------------------------
+// MCU control and status, watchdog, and power reduction registers
+
+#define PORF                    0
+#define EXTRF                   1
+#define BORF                    2
+#define WDRF                    3
+#define JTRF                    4
+#define IVCE                    0
+#define IVSEL                   1
+#define PUD                     4
+#define JTD                     7
+#define WDP0                    0
+#define WDP1                    1
+#define WDP2                    2
+#define WDE                     3
+#define WDCE                    4
+#define WDP3                    5
+#define WDIE                    6
+#define WDIF                    7
+#define PRADC                   0
+#define PRUSART0                1
+#define PRSPI                   2
+#define PRTIM1                  3
+#define PRTIM0                  5
+#define PRTIM2                  6
+#define PRTWI                   7
+#define PRUSART1                0
+#define PRTIM3                  3
+#define PRTIM4                  4
+#define PRTIM5                  5
+
+//-------------------------------------------------------------------------------------
+// SPI port
+
+#define SPR0                    0
+#define SPR1                    1
+#define CPHA                    2
+#define CPOL                    3
+#define MSTR                    4
+#define DORD                    5
+#define SPE                     6
+#define SPIE                    7
+#define SPI2X                   0
+#define WCOL                    6
+#define SPIF                    7
+
+//-------------------------------------------------------------------------------------
+// A/D converter
+
+#define ADPS0                   0
+#define ADPS1                   1
+#define ADPS2                   2
+#define ADIE                    3
+#define ADIF                    4
+#define ADATE                   5
+#define ADSC                    6
+#define ADEN                    7
+#define ADTS0                   0
+#define ADTS1                   1
+#define ADTS2                   2
+#define MUX5                    3
+#define ACME                    6
+#define MUX0                    0
+#define MUX1                    1
+#define MUX2                    2
+#define MUX3                    3
+#define MUX4                    4
+#define ADLAR                   5
+#define REFS0                   6
+#define REFS1                   7
+
+//-------------------------------------------------------------------------------------
+// 8-bit timers 0 and 2
+
+#define WGM00                   0
+#define WGM01                   1
+#define COM0B0                  4
+#define COM0B1                  5
+#define COM0A0                  6
+#define COM0A1                  7
+#define CS00                    0
+#define CS01                    1
+#define CS02                    2
+#define WGM02                   3
+#define FOC0B                   6
+#define FOC0A                   7
+#define TOIE0                   0
+#define OCIE0A                  1
+#define OCIE0B                  2
+#define TOV0                    0
+#define OCF0A                   1
+#define OCF0B                   2
+#define WGM20                   0
+#define WGM21                   1
+#define COM2B0                  4
+#define COM2B1                  5
+#define COM2A0                  6
+#define COM2A1                  7
+#define CS20                    0
+#define CS21                    1
+#define CS22                    2
+#define WGM22                   3
+#define FOC2B                   6
+#define FOC2A                   7
+#define TOIE2                   0
+#define OCIE2A                  1
+#define OCIE2B                  2
+#define TOV2                    0
+#define OCF2A                   1
+#define OCF2B                   2
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 1
+
+#define WGM10                   0
+#define WGM11                   1
+#define COM1C0                  2
+#define COM1C1                  3
+#define COM1B0                  4
+#define COM1B1                  5
+#define COM1A0                  6
+#define COM1A1                  7
+#define CS10                    0
+#define CS11                    1
+#define CS12                    2
+#define WGM12                   3
+#define WGM13                   4
+#define ICES1                   6
+#define ICNC1                   7
+#define FOC1C                   5
+#define FOC1B                   6
+#define FOC1A                   7
+#define TOIE1                   0
+#define OCIE1A                  1
+#define OCIE1B                  2
+#define OCIE1C                  3
+#define ICIE1                   5
+#define TOV1                    0
+#define OCF1A                   1
+#define OCF1B                   2
+#define OCF1C                   3
+#define ICF1                    5
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 3
+
+#define WGM30                   0
+#define WGM31                   1
+#define COM3C0                  2
+#define COM3C1                  3
+#define COM3B0                  4
+#define COM3B1                  5
+#define COM3A0                  6
+#define COM3A1                  7
+#define CS30                    0
+#define CS31                    1
+#define CS32                    2
+#define WGM32                   3
+#define WGM33                   4
+#define ICES3                   6
+#define ICNC3                   7
+#define FOC3C                   5
+#define FOC3B                   6
+#define FOC3A                   7
+#define TOIE3                   0
+#define OCIE3A                  1
+#define OCIE3B                  2
+#define OCIE3C                  3
+#define ICIE3                   5
+#define TOV3                    0
+#define OCF3A                   1
+#define OCF3B                   2
+#define OCF3C                   3
+#define ICF3                    5
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 4
+
+#define WGM40                   0
+#define WGM41                   1
+#define COM4C0                  2
+#define COM4C1                  3
+#define COM4B0                  4
+#define COM4B1                  5
+#define COM4A0                  6
+#define COM4A1                  7
+#define CS40                    0
+#define CS41                    1
+#define CS42                    2
+#define WGM42                   3
+#define WGM43                   4
+#define ICES4                   6
+#define ICNC4                   7
+#define FOC4C                   5
+#define FOC4B                   6
+#define FOC4A                   7
+#define TOIE4                   0
+#define OCIE4A                  1
+#define OCIE4B                  2
+#define OCIE4C                  3
+#define ICIE4                   5
+#define TOV4                    0
+#define OCF4A                   1
+#define OCF4B                   2
+#define OCF4C                   3
+#define ICF4                    5
+
+//-------------------------------------------------------------------------------------
+// 16-bit timer 5
+
+#define WGM50                   0
+#define WGM51                   1
+#define COM5C0                  2
+#define COM5C1                  3
+#define COM5B0                  4
+#define COM5B1                  5
+#define COM5A0                  6
+#define COM5A1                  7
+#define CS50                    0
+#define CS51                    1
+#define CS52                    2
+#define WGM52                   3
+#define WGM53                   4
+#define ICES5                   6
+#define ICNC5                   7
+#define FOC5C                   5
+#define FOC5B                   6
+#define FOC5A                   7
+#define TOIE5                   0
+#define OCIE5A                  1
+#define OCIE5B                  2
+#define OCIE5C                  3
+#define ICIE5                   5
+#define TOV5                    0
+#define OCF5A                   1
+#define OCF5B                   2
+#define OCF5C                   3
+#define ICF5                    5
+
+//-------------------------------------------------------------------------------------
+// Two-wire (I2C) interface
+
+#define TWIE                    0
+#define TWEN                    2
+#define TWWC                    3
+#define TWSTO                   4
+#define TWSTA                   5
+#define TWEA                    6
+#define TWINT                   7
+#define TWPS0                   0
+#define TWPS1                   1
+#define TWS3                    3
+#define TWS4                    4
+#define TWS5                    5
+#define TWS6                    6
+#define TWS7                    7
+#define TWGCE                   0
+#define TWA0                    1
+
+//-------------------------------------------------------------------------------------
+// USART 0
+
+#define MPCM0                   0
+#define U2X0                    1
+#define UPE0                    2
+#define DOR0                    3
+#define FE0                     4
+#define UDRE0                   5
+#define TXC0                    6
+#define RXC0                    7
+#define TXB80                   0
+#define RXB80                   1
+#define UCSZ02                  2
+#define TXEN0                   3
+#define RXEN0                   4
+#define UDRIE0                  5
+#define TXCIE0                  6
+#define RXCIE0                  7
+#define UCPOL0                  0
+#define UCSZ00                  1
+#define UCSZ01                  2
+#define USBS0                   3
+#define UPM00                   4
+#define UPM01                   5
+#define UMSEL00                 6
+#define UMSEL01                 7
+
+//-------------------------------------------------------------------------------------
+// USART 1
+
+#define MPCM1                   0
+#define U2X1                    1
+#define UPE1                    2
+#define DOR1                    3
+#define FE1                     4
+#define UDRE1                   5
+#define TXC1                    6
+#define RXC1                    7
+#define TXB81                   0
+#define RXB81                   1
+#define UCSZ12                  2
+#define TXEN1                   3
+#define RXEN1                   4
+#define UDRIE1                  5
+#define TXCIE1                  6
+#define RXCIE1                  7
+#define UCPOL1                  0
+#define UCSZ10                  1
+#define UCSZ11                  2
+#define USBS1                   3
+#define UPM10                   4
+#define UPM11                   5
+#define UMSEL10                 6
+#define UMSEL11                 7
+
+
+//=====================================================================================
+// Interrupt vectors. On the host, an interrupt service routine is an ordinary function
+// named as it is by avr-libc; the simulation of a peripheral calls it through
+// vPortHostInterrupt() in the port so that it runs as if it were in an interrupt
+
+#define _VECTOR(N)              __vector_ ## N
+#define _VECTORS_SIZE           (51 * 4)
+
+#define INT0_vect               _VECTOR(1)
+#define INT1_vect               _VECTOR(2)
+#define INT2_vect               _VECTOR(3)
+#define INT3_vect               _VECTOR(4)
+#define INT4_vect               _VECTOR(5)
+#define INT5_vect               _VECTOR(6)
+#define INT6_vect               _VECTOR(7)
+#define INT7_vect               _VECTOR(8)
+#define PCINT0_vect             _VECTOR(9)
+#define PCINT1_vect             _VECTOR(10)
+#define PCINT2_vect             _VECTOR(11)
+#define WDT_vect                _VECTOR(12)
+#define TIMER2_COMPA_vect       _VECTOR(13)
+#define TIMER2_COMPB_vect       _VECTOR(14)
+#define TIMER2_OVF_vect         _VECTOR(15)
+#define TIMER1_CAPT_vect        _VECTOR(16)
+#define TIMER1_COMPA_vect       _VECTOR(17)
+#define TIMER1_COMPB_vect       _VECTOR(18)
+#define TIMER1_COMPC_vect       _VECTOR(19)
+#define TIMER1_OVF_vect         _VECTOR(20)
+#define TIMER0_COMPA_vect       _VECTOR(21)
+#define TIMER0_COMPB_vect       _VECTOR(22)
+#define TIMER0_OVF_vect         _VECTOR(23)
+#define SPI_STC_vect            _VECTOR(24)
+#define USART0_RX_vect          _VECTOR(25)
+#define USART0_UDRE_vect        _VECTOR(26)
+#define USART0_TX_vect          _VECTOR(27)
+#define ANALOG_COMP_vect        _VECTOR(28)
+#define ADC_vect                _VECTOR(29)
+#define EE_READY_vect           _VECTOR(30)
+#define TIMER3_CAPT_vect        _VECTOR(31)
+#define TIMER3_COMPA_vect       _VECTOR(32)
+#define TIMER3_COMPB_vect       _VECTOR(33)
+#define TIMER3_COMPC_vect       _VECTOR(34)
+#define TIMER3_OVF_vect         _VECTOR(35)
+#define USART1_RX_vect          _VECTOR(36)
+#define USART1_UDRE_vect        _VECTOR(37)
+#define USART1_TX_vect          _VECTOR(38)
+#define TWI_vect                _VECTOR(39)
+#define SPM_READY_vect          _VECTOR(40)
+#define TIMER4_CAPT_vect        _VECTOR(41)
+#define TIMER4_COMPA_vect       _VECTOR(42)
+#define TIMER4_COMPB_vect       _VECTOR(43)
+#define TIMER4_COMPC_vect       _VECTOR(44)
+#define TIMER4_OVF_vect         _VECTOR(45)
+#define TIMER5_CAPT_vect        _VECTOR(46)
+#define TIMER5_COMPA_vect       _VECTOR(47)
+#define TIMER5_COMPB_vect       _VECTOR(48)
+#define TIMER5_COMPC_vect       _VECTOR(49)
+#define TIMER5_OVF_vect         _VECTOR(50)
+
+#endif // _AVR_IO_H_
@@ -0,0 +1,53 @@
+//*************************************************************************************
+/** @file    avr/pgmspace.h
+ *  @brief   Stand-in for the avr-libc program memory header when compiling for a PC host.
+ *  @details A PC has only one address space, so constant data which would be put into
+ *           program memory on an AVR stays in ordinary memory, and reading it from
+ *           "program memory" is just a normal memory read.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                   const char*
+#define PGM_VOID_P              const void*
+#define PSTR(s)                 (s)
+
+#define pgm_read_byte_near(addr)    (*(const uint8_t*)(addr))
+#define pgm_read_word_near(addr)    (*(const uint16_t*)(addr))
+#define pgm_read_dword_near(addr)   (*(const uint32_t*)(addr))
+#define pgm_read_float_near(addr)   (*(const float*)(addr))
+#define pgm_read_byte(addr)         pgm_read_byte_near (addr)
+#define pgm_read_word(addr)         pgm_read_word_near (addr)
+#define pgm_read_dword(addr)        pgm_read_dword_near (addr)
+#define pgm_read_float(addr)        pgm_read_float_near (addr)
+
+#define memcpy_P                memcpy
+#define strcpy_P                strcpy
+#define strncpy_P               strncpy
+#define strcmp_P                strcmp
+#define strlen_P                strlen
+
+#endif // __PGMSPACE_H_
@@ -0,0 +1,64 @@
+//*************************************************************************************
+/** @file    avr/wdt.h
+ *  @brief   Stand-in for the avr-libc watchdog timer header when compiling for a PC host.
+ *  @details There's no watchdog timer on the host. Turning the watchdog on is only done
+ *           by ME405 programs which want the processor to be reset, so on the host,
+ *           enabling the watchdog ends the program through vPortHostReset().
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _AVR_WDT_H_
+#define _AVR_WDT_H_
+
+#include <avr/io.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// This function ends a simulation run as a processor reset would; it's in port.c
+extern void vPortHostReset (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Watchdog timeouts, which are ignored on the host
+#define WDTO_15MS               0
+#define WDTO_30MS               1
+#define WDTO_60MS               2
+#define WDTO_120MS              3
+#define WDTO_250MS              4
+#define WDTO_500MS              5
+#define WDTO_1S                 6
+#define WDTO_2S                 7
+#define WDTO_4S                 8
+#define WDTO_8S                 9
+
+/// Resetting the watchdog timer does nothing on the host
+#define wdt_reset()             do { } while (0)
+
+/// The watchdog is never running on the host, so there's nothing to turn off
+#define wdt_disable()           do { } while (0)
+
+/// Turning on the watchdog is taken as a request to reset, which ends the program
+#define wdt_enable(timeout)     do { (void)(timeout); vPortHostReset (); } while (0)
+
+#endif // _AVR_WDT_H_
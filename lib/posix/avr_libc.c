@@ -0,0 +1,219 @@
+//*************************************************************************************
+/** @file    avr_libc.c
+ *  @brief   Host versions of the avr-libc functions which ME405 code uses.
+ *  @details The avr-libc library has some functions that aren't found in the C library
+ *           of a PC. The ones which are used by the ME405 library, namely the integer
+ *           to text conversions and the floating point conversion engine used by class
+ *           \c emstream, are written here in plain C so they can run on the host.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+
+/// These are the flags put at the beginning of the buffer by __ftoa_engine()
+#define FTOA_MINUS      1
+#define FTOA_ZERO       2
+#define FTOA_INF        4
+#define FTOA_NAN        8
+
+int __ftoa_engine (double val, char *buf, uint8_t prec, uint8_t maxdgs);
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts an unsigned long integer to text in the given radix. It is
+ *  used by all the integer conversions below. 
+ *  @param value The number to be converted
+ *  @param string A buffer into which the text is written
+ *  @param radix The base of the number system, from 2 to 36
+ *  @return A pointer to the string
+ */
+
+static char* ulong_to_text (unsigned long value, char* string, int radix)
+{
+	char digits[8 * sizeof (unsigned long) + 1];
+	uint8_t count = 0;
+
+	if (radix < 2 || radix > 36)
+	{
+		*string = '\0';
+		return (string);
+	}
+
+	// Find the digits from least to most significant, then copy them out backwards
+	do
+	{
+		uint8_t digit = (uint8_t)(value % (unsigned long)radix);
+		digits[count++] = (char)((digit < 10) ? ('0' + digit) : ('a' + digit - 10));
+		value /= (unsigned long)radix;
+	}
+	while (value);
+
+	char* p_out = string;
+	while (count)
+	{
+		*p_out++ = digits[--count];
+	}
+	*p_out = '\0';
+
+	return (string);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts a signed long integer to text. As in avr-libc, a minus sign
+ *  is only put in front of negative numbers when the radix is 10; in other bases, the
+ *  number is converted as if it were unsigned. 
+ *  @param value The number to be converted
+ *  @param string A buffer into which the text is written
+ *  @param radix The base of the number system, from 2 to 36
+ *  @return A pointer to the string
+ */
+
+char* ltoa (long value, char* string, int radix)
+{
+	if (radix == 10 && value < 0)
+	{
+		*string = '-';
+		ulong_to_text (-(unsigned long)value, string + 1, radix);
+		return (string);
+	}
+	return (ulong_to_text ((unsigned long)value, string, radix));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts an unsigned long integer to text. 
+ *  @param value The number to be converted
+ *  @param string A buffer into which the text is written
+ *  @param radix The base of the number system, from 2 to 36
+ *  @return A pointer to the string
+ */
+
+char* ultoa (unsigned long value, char* string, int radix)
+{
+	return (ulong_to_text (value, string, radix));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts an integer to text. Non-decimal numbers are printed with as
+ *  many digits as the host's integer needs, which is more than on an AVR. 
+ *  @param value The number to be converted
+ *  @param string A buffer into which the text is written
+ *  @param radix The base of the number system, from 2 to 36
+ *  @return A pointer to the string
+ */
+
+char* itoa (int value, char* string, int radix)
+{
+	if (radix == 10)
+	{
+		return (ltoa ((long)value, string, radix));
+	}
+	return (ulong_to_text ((unsigned int)value, string, radix));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts an unsigned integer to text.
+ *  @param value The number to be converted
+ *  @param string A buffer into which the text is written
+ *  @param radix The base of the number system, from 2 to 36
+ *  @return A pointer to the string
+ */
+
+char* utoa (unsigned int value, char* string, int radix)
+{
+	return (ulong_to_text ((unsigned long)value, string, radix));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function does the same job as the avr-libc floating point conversion engine.
+ *  The first byte of the buffer gets flags showing whether the number is negative, 
+ *  zero, infinite, or not a number. The following bytes get the significant digits of
+ *  the number, one digit before the decimal point and \c prec after it (but no more
+ *  than \c maxdgs digits in all), followed by a '\\0'. The decimal exponent of the 
+ *  number is returned. The host's \c snprintf() does the actual rounding. 
+ *  @param val The number to be converted
+ *  @param buf A buffer into which the flags and digits are written
+ *  @param prec The number of digits to show after the first significant digit
+ *  @param maxdgs The maximum number of significant digits to show
+ *  @return The exponent, as a power of ten, of the first significant digit
+ */
+
+int __ftoa_engine (double val, char *buf, uint8_t prec, uint8_t maxdgs)
+{
+	char text[40];
+	int exponent = 0;
+	uint8_t n_digits = prec + 1;
+
+	if (n_digits > maxdgs)
+	{
+		n_digits = maxdgs;
+	}
+	if (n_digits < 1)
+	{
+		n_digits = 1;
+	}
+
+	buf[0] = signbit (val) ? FTOA_MINUS : 0;
+	if (isnan (val))
+	{
+		buf[0] |= FTOA_NAN;
+		buf[1] = '\0';
+		return (0);
+	}
+	if (isinf (val))
+	{
+		buf[0] |= FTOA_INF;
+		buf[1] = '\0';
+		return (0);
+	}
+	if (val == 0.0)
+	{
+		buf[0] |= FTOA_ZERO;
+	}
+
+	// Format as d.ddddde+xx, then pick out the digits and the exponent
+	snprintf (text, sizeof (text), "%.*e", n_digits - 1, fabs (val));
+
+	char* p_out = buf + 1;
+	const char* p_in;
+	for (p_in = text; *p_in && *p_in != 'e'; p_in++)
+	{
+		if (*p_in >= '0' && *p_in <= '9')
+		{
+			*p_out++ = *p_in;
+		}
+	}
+	*p_out = '\0';
+
+	if (*p_in == 'e')
+	{
+		exponent = atoi (p_in + 1);
+	}
+
+	return (exponent);
+}
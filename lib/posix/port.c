@@ -0,0 +1,753 @@
+//*************************************************************************************
+//
+// This version of port.c runs Cal Poly ME405 FreeRTOS programs on a POSIX (Linux) host
+// computer so that task graphs written for the ATmega1281 can be run, profiled, and
+// tested without an AVR. Each task gets its own thread, but only the thread belonging
+// to the task which FreeRTOS says is running may run; the rest wait on condition
+// variables. The RTOS tick comes from SIGALRM, and interrupts are simulated with a
+// flag which works like the AVR's global interrupt enable bit.
+//
+// Two settings, which may be given as -D options in the makefile or as environment
+// variables of the same name when the program is run, control a simulation run:
+//   configHOST_TICK_PERIOD_US  How many real microseconds one RTOS tick takes. The
+//                              default is one tick period at configTICK_RATE_HZ; a
+//                              smaller number runs busy programs faster
+//   configHOST_RUN_TICKS       How many RTOS ticks to run before stopping the
+//                              scheduler and printing run time statistics. The
+//                              default of 0 means run forever
+// Because tickless idle mode is used, time during which every task is blocked is
+// skipped over, so programs that spend most of their time waiting run many times
+// faster than real time.
+//
+// Limitation: a task may be preempted while it's inside the host's C library. If it
+// was holding a library lock (as malloc() and stdio functions do), another task
+// which needs the same lock will wait forever. ME405 code allocates memory with
+// pvPortMalloc() and prints through serial port objects which write to the host's
+// stdout with write(), so this is only a problem if tasks call such functions
+// directly after the scheduler has been started.
+//
+//*************************************************************************************
+
+/*
+    FreeRTOS V8.1.2 - Copyright (C) 2014 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>!AND MODIFIED BY!<< the FreeRTOS exception.
+
+    >>!   NOTE: The modification to the GPL is included to allow you to     !<<
+    >>!   distribute a combined work that includes FreeRTOS without being   !<<
+    >>!   obliged to provide the source code for proprietary components     !<<
+    >>!   outside of the FreeRTOS kernel.                                   !<<
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available from the following
+    link: http://www.freertos.org/a00114.html
+
+    1 tab == 4 spaces!
+*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <avr/io.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the POSIX host port.
+ *----------------------------------------------------------*/
+
+/* Default length of one tick in real time, and default length of a run. */
+#ifndef configHOST_TICK_PERIOD_US
+	#define configHOST_TICK_PERIOD_US	( 1000000UL / configTICK_RATE_HZ )
+#endif
+#ifndef configHOST_RUN_TICKS
+	#define configHOST_RUN_TICKS		0
+#endif
+
+/* The most interrupts from simulated peripherals which can wait for interrupts to
+be enabled again. */
+#define portHOST_MAX_PENDING_ISRS		16
+
+/* The tick timer's compare match value, as it would be set up on an AVR. */
+#define portHOST_TIMER_TOP				( ( uint16_t ) ( configCPU_CLOCK_HZ \
+										/ ( configTICK_RATE_HZ * portCLOCK_PRESCALER ) ) - 1 )
+
+/*-----------------------------------------------------------*/
+
+/* Each task's thread is described by one of these records. The record is kept at
+the top of the task's FreeRTOS stack, and the stack pointer saved in the task's TCB
+points to it; the thread itself runs on a stack belonging to the host. */
+typedef struct xHOST_THREAD
+{
+	pthread_t xThread;							/* The host thread running the task. */
+	pthread_cond_t xResume;						/* Signalled when the thread may run. */
+	TaskFunction_t pxCode;						/* The task function and... */
+	void *pvParameters;							/* ...its parameter. */
+	UBaseType_t uxCriticalNesting;				/* Saved while the task is switched out. */
+	BaseType_t xInISR;							/* Also saved while switched out. */
+} xHostThread;
+
+/* We require the address of the pxCurrentTCB variable, but don't want to know
+any details of its type. */
+typedef void TCB_t;
+extern volatile TCB_t * volatile pxCurrentTCB;
+
+/*-----------------------------------------------------------*/
+
+/* If stack tracing is active, declare a variable which will be used by the task
+ * wrapper class to get the address of the top of the stack just after a task has
+ * been created. The variable is static so it retains its value. */
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+	size_t portStackTopForTask;
+#endif
+
+/* The simulated special function registers, which are declared in avr/io.h. */
+volatile uint8_t ucPortHostSFR[ portHOST_SFR_SIZE ] __attribute__ ( ( aligned ( 8 ) ) );
+
+/* Only the thread which owns the running token may run. The token is handed over
+while holding this mutex. */
+static pthread_mutex_t xRunMutex = PTHREAD_MUTEX_INITIALIZER;
+static xHostThread * volatile pxRunningThread = NULL;
+
+/* The main thread waits on this until the scheduler is ended. */
+static pthread_cond_t xEndCondition = PTHREAD_COND_INITIALIZER;
+static volatile BaseType_t xSchedulerEnded = pdFALSE;
+
+/* The simulated processor state. The interrupt flag works like the AVR's I bit and
+the tick pending flag like the timer's compare match flag. These are only changed by
+the running thread, either in task code or in its tick signal handler. */
+static volatile sig_atomic_t xInterruptsEnabled = pdFALSE;
+static volatile sig_atomic_t xTickPending = pdFALSE;
+static volatile sig_atomic_t xInISR = pdFALSE;
+static volatile sig_atomic_t xSwitchRequired = pdFALSE;
+static volatile UBaseType_t uxCriticalNesting = 0;
+
+/* Interrupts from simulated peripherals which came while interrupts were off. */
+static void ( * volatile pxPendingISRs[ portHOST_MAX_PENDING_ISRS ] )( void );
+static volatile UBaseType_t uxPendingISRs = 0;
+
+/* Timing of the simulation. Times are in nanoseconds of the host's monotonic clock. */
+static sigset_t xTickSignal;
+static uint32_t ulTickPeriodUs = configHOST_TICK_PERIOD_US;
+static TickType_t xRunTicks = configHOST_RUN_TICKS;
+static volatile uint64_t ullLastTickTime = 0;
+static uint64_t ullStartTime = 0;
+static uint64_t ullEndTime = 0;
+static volatile TickType_t xIdleTicksSkipped = 0;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the host's monotonic clock in nanoseconds.
+ */
+static uint64_t prvGetTime( void );
+
+/*
+ * Read a number from an environment variable, keeping the default if it's not set.
+ */
+static uint32_t prvGetSetting( const char *pcName, uint32_t ulDefault );
+
+/*
+ * Find the thread record belonging to the task FreeRTOS has chosen to run.
+ */
+static xHostThread *prvCurrentThread( void );
+
+/*
+ * Hand the processor from the running thread to another one, then wait until
+ * this thread is given the processor back.
+ */
+static void prvSwitchThread( xHostThread *pxNext, xHostThread *pxSelf, BaseType_t xFromSignal );
+
+/*
+ * The function which every task's thread runs; it waits its turn then calls the task.
+ */
+static void *prvThreadStart( void *pvThread );
+
+/*
+ * Run an interrupt service routine as the AVR would, with interrupts disabled.
+ */
+static void prvRunISR( void ( *pxISR )( void ), BaseType_t xFromSignal );
+
+/*
+ * The simulated tick timer's interrupt service routine, and the signal handler
+ * which calls it.
+ */
+static void prvTickISR( void );
+static void prvTickSignalHandler( int iSignal );
+
+/*
+ * Start the host's interval timer to generate SIGALRM at the tick rate.
+ */
+static void prvSetupTimerInterrupt( void );
+
+/*
+ * Let the main thread know the scheduler has stopped, then stop this thread.
+ */
+static void prvEndScheduler( void );
+static void prvParkThread( void ) __attribute__ ( ( noreturn ) );
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTime( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetSetting( const char *pcName, uint32_t ulDefault )
+{
+const char *pcValue = getenv( pcName );
+
+	if( ( pcValue != NULL ) && ( *pcValue != '\0' ) )
+	{
+		return ( uint32_t ) strtoul( pcValue, NULL, 0 );
+	}
+	return ulDefault;
+}
+/*-----------------------------------------------------------*/
+
+static xHostThread *prvCurrentThread( void )
+{
+	/* The first member of a TCB is the saved stack pointer, which points to the
+	thread record. */
+	return *( xHostThread ** ) pxCurrentTCB;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack,
+									  TaskFunction_t pxCode, void *pvParameters )
+{
+xHostThread *pxThread;
+pthread_attr_t xAttributes;
+sigset_t xOldMask;
+
+	// This is a kludge, but it should work. If stack tracing is active, keep a static
+	// variable here which holds the address of the top of the stack. It will be
+	// grabbed by the task's wrapper object just after xTaskCreate() is called so that
+	// the task object knows where its stack is.
+	#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+		portStackTopForTask = (size_t)pxTopOfStack;
+	#endif
+
+	/* Put the thread record at the top of the task's stack, suitably aligned. */
+	pxThread = ( xHostThread * ) ( ( ( size_t ) ( pxTopOfStack + 1 ) - sizeof( xHostThread ) )
+								   & ~( size_t ) 0x0f );
+	memset( pxThread, 0, sizeof( xHostThread ) );
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pthread_cond_init( &pxThread->xResume, NULL );
+
+	/* The new thread must never take a tick signal until it's been given the
+	processor, so it's created with the signal blocked. */
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, &xOldMask );
+	pthread_attr_init( &xAttributes );
+	pthread_attr_setdetachstate( &xAttributes, PTHREAD_CREATE_DETACHED );
+	if( pthread_create( &pxThread->xThread, &xAttributes, prvThreadStart, pxThread ) != 0 )
+	{
+		fprintf( stderr, "FreeRTOS host port: cannot create thread: %s\n", strerror( errno ) );
+		exit( EXIT_FAILURE );
+	}
+	pthread_attr_destroy( &xAttributes );
+	pthread_sigmask( SIG_SETMASK, &xOldMask, NULL );
+
+	return ( StackType_t * ) pxThread;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvThreadStart( void *pvThread )
+{
+xHostThread *pxThread = ( xHostThread * ) pvThread;
+
+	/* Wait until the scheduler chooses this task for the first time. */
+	pthread_mutex_lock( &xRunMutex );
+	while( pxRunningThread != pxThread )
+	{
+		pthread_cond_wait( &pxThread->xResume, &xRunMutex );
+	}
+	pthread_mutex_unlock( &xRunMutex );
+
+	/* Start tasks with interrupts enabled. */
+	uxCriticalNesting = 0;
+	xInISR = pdFALSE;
+	xInterruptsEnabled = pdTRUE;
+	pthread_sigmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	if( xTickPending != pdFALSE )
+	{
+		pthread_kill( pthread_self(), SIGALRM );
+	}
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* Task functions must never return. */
+	fprintf( stderr, "FreeRTOS host port: a task function returned\n" );
+	vTaskEndScheduler();
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( xHostThread *pxNext, xHostThread *pxSelf, BaseType_t xFromSignal )
+{
+	if( pxNext == pxSelf )
+	{
+		return;
+	}
+
+	/* Save the parts of the simulated processor state which belong to this task. */
+	pxSelf->uxCriticalNesting = uxCriticalNesting;
+	pxSelf->xInISR = xInISR;
+
+	/* Only the running thread may take tick signals. A signal handler already has
+	the signal blocked; task code must block it before giving up the processor. */
+	if( xFromSignal == pdFALSE )
+	{
+		pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+	}
+
+	pthread_mutex_lock( &xRunMutex );
+	pxRunningThread = pxNext;
+	pthread_cond_signal( &pxNext->xResume );
+	while( pxRunningThread != pxSelf )
+	{
+		pthread_cond_wait( &pxSelf->xResume, &xRunMutex );
+	}
+	pthread_mutex_unlock( &xRunMutex );
+
+	/* This task has the processor again. */
+	uxCriticalNesting = pxSelf->uxCriticalNesting;
+	xInISR = pxSelf->xInISR;
+
+	if( xFromSignal == pdFALSE )
+	{
+		pthread_sigmask( SIG_UNBLOCK, &xTickSignal, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xAction;
+xHostThread *pxFirst;
+
+	ulTickPeriodUs = prvGetSetting( "configHOST_TICK_PERIOD_US", ulTickPeriodUs );
+	xRunTicks = ( TickType_t ) prvGetSetting( "configHOST_RUN_TICKS", xRunTicks );
+	if( ulTickPeriodUs == 0 )
+	{
+		ulTickPeriodUs = 1;
+	}
+
+	/* The main thread never runs tasks, so it never takes the tick signal. */
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+
+	memset( &xAction, 0, sizeof( xAction ) );
+	xAction.sa_handler = prvTickSignalHandler;
+	xAction.sa_flags = SA_RESTART;
+	sigfillset( &xAction.sa_mask );
+	sigaction( SIGALRM, &xAction, NULL );
+
+	/* Give the processor to the first task, then start the tick. */
+	ullStartTime = prvGetTime();
+	ullLastTickTime = ullStartTime;
+	pxFirst = prvCurrentThread();
+	prvSetupTimerInterrupt();
+
+	pthread_mutex_lock( &xRunMutex );
+	pxRunningThread = pxFirst;
+	pthread_cond_signal( &pxFirst->xResume );
+
+	/* Now wait until some task ends the scheduler. */
+	while( xSchedulerEnded == pdFALSE )
+	{
+		pthread_cond_wait( &xEndCondition, &xRunMutex );
+	}
+	pthread_mutex_unlock( &xRunMutex );
+
+	/* Every task's thread is stopped now, so it's safe to look at them all. */
+	vPortHostPrintRunTimeStats();
+
+	/* Returning false tells vTaskStartScheduler() the scheduler has been ended. */
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	prvEndScheduler();
+	prvParkThread();
+}
+/*-----------------------------------------------------------*/
+
+static void prvEndScheduler( void )
+{
+struct itimerval xTimer;
+
+	memset( &xTimer, 0, sizeof( xTimer ) );
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+	ullEndTime = prvGetTime();
+
+	pthread_mutex_lock( &xRunMutex );
+	xSchedulerEnded = pdTRUE;
+	pthread_cond_signal( &xEndCondition );
+	pthread_mutex_unlock( &xRunMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvParkThread( void )
+{
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+	for( ;; )
+	{
+		pause();
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Manual context switch. In an interrupt service routine the switch is put off until
+ * the routine returns, as the AVR port would do when it left the ISR.
+ */
+void vPortYield( void )
+{
+xHostThread *pxSelf = pxRunningThread;
+sig_atomic_t xWasEnabled;
+
+	if( xInISR != pdFALSE )
+	{
+		xSwitchRequired = pdTRUE;
+		return;
+	}
+	if( ( pxSelf == NULL ) || ( xSchedulerEnded != pdFALSE ) )
+	{
+		return;
+	}
+
+	xWasEnabled = xInterruptsEnabled;
+	xInterruptsEnabled = pdFALSE;
+	vTaskSwitchContext();
+	prvSwitchThread( prvCurrentThread(), pxSelf, pdFALSE );
+	xInterruptsEnabled = xWasEnabled;
+
+	/* A tick which came due while this task was switching is serviced now. */
+	if( ( xInterruptsEnabled != pdFALSE ) && ( xTickPending != pdFALSE ) )
+	{
+		pthread_kill( pthread_self(), SIGALRM );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	xInterruptsEnabled = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	/* In an ISR, interrupts come back on when the ISR returns. */
+	if( xInISR != pdFALSE )
+	{
+		return;
+	}
+
+	/* Run the peripheral interrupts which have been waiting, oldest first, then let
+	the tick in if it has been waiting. */
+	while( uxPendingISRs != 0 )
+	{
+		void ( *pxISR )( void ) = pxPendingISRs[ 0 ];
+		UBaseType_t uxIndex;
+
+		uxPendingISRs--;
+		for( uxIndex = 0; uxIndex < uxPendingISRs; uxIndex++ )
+		{
+			pxPendingISRs[ uxIndex ] = pxPendingISRs[ uxIndex + 1 ];
+		}
+		prvRunISR( pxISR, pdFALSE );
+	}
+
+	xInterruptsEnabled = pdTRUE;
+	if( ( xTickPending != pdFALSE ) && ( pxRunningThread != NULL ) )
+	{
+		pthread_kill( pthread_self(), SIGALRM );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	vPortDisableInterrupts();
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( uxCriticalNesting > 0 )
+	{
+		uxCriticalNesting--;
+		if( uxCriticalNesting == 0 )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunISR( void ( *pxISR )( void ), BaseType_t xFromSignal )
+{
+xHostThread *pxSelf = pxRunningThread;
+
+	xInterruptsEnabled = pdFALSE;
+	xInISR = pdTRUE;
+	xSwitchRequired = pdFALSE;
+
+	pxISR();
+
+	xInISR = pdFALSE;
+	if( xSchedulerEnded != pdFALSE )
+	{
+		prvParkThread();
+	}
+	if( ( xSwitchRequired != pdFALSE ) && ( pxSelf != NULL ) )
+	{
+		xSwitchRequired = pdFALSE;
+		vTaskSwitchContext();
+		prvSwitchThread( prvCurrentThread(), pxSelf, xFromSignal );
+	}
+
+	/* Leaving the ISR turns interrupts back on, as the AVR's reti instruction does. */
+	xInterruptsEnabled = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostInterrupt( void ( *pxISR )( void ) )
+{
+	/* If interrupts are off, the interrupt waits until they're turned on again. An
+	interrupt which is already waiting isn't queued twice, just as an AVR interrupt
+	flag which is already set can't be set again. */
+	if( ( xInterruptsEnabled == pdFALSE ) || ( xInISR != pdFALSE ) )
+	{
+		UBaseType_t uxIndex;
+
+		for( uxIndex = 0; uxIndex < uxPendingISRs; uxIndex++ )
+		{
+			if( pxPendingISRs[ uxIndex ] == pxISR )
+			{
+				return;
+			}
+		}
+		if( uxPendingISRs < portHOST_MAX_PENDING_ISRS )
+		{
+			pxPendingISRs[ uxPendingISRs++ ] = pxISR;
+		}
+		return;
+	}
+
+	prvRunISR( pxISR, pdFALSE );
+
+	if( xTickPending != pdFALSE )
+	{
+		pthread_kill( pthread_self(), SIGALRM );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortHostInISR( void )
+{
+	return ( BaseType_t ) xInISR;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickISR( void )
+{
+	ullLastTickTime = prvGetTime();
+	if( xTaskIncrementTick() != pdFALSE )
+	{
+		xSwitchRequired = pdTRUE;
+	}
+
+	if( ( xRunTicks != 0 ) && ( xTaskGetTickCountFromISR() >= xRunTicks ) )
+	{
+		prvEndScheduler();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	if( xSchedulerEnded != pdFALSE )
+	{
+		return;
+	}
+
+	/* If interrupts are off, the tick waits until they're turned back on. */
+	if( ( xInterruptsEnabled == pdFALSE ) || ( xInISR != pdFALSE ) )
+	{
+		xTickPending = pdTRUE;
+		errno = iSavedErrno;
+		return;
+	}
+
+	xTickPending = pdFALSE;
+	prvRunISR( prvTickISR, pdTRUE );
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+		/* This is called by the idle task with the scheduler suspended. Rather than
+		sleep, skip straight to the tick before the next task wakes, then deliver that
+		tick now; xTaskResumeAll() will then let the woken task run. */
+		portDISABLE_INTERRUPTS();
+		if( eTaskConfirmSleepModeStatus() != eAbortSleep )
+		{
+			vTaskStepTick( xExpectedIdleTime - 1 );
+			xIdleTicksSkipped += xExpectedIdleTime;
+
+			xInISR = pdTRUE;
+			prvTickISR();
+			xInISR = pdFALSE;
+			xSwitchRequired = pdFALSE;
+			xTickPending = pdFALSE;
+
+			if( xSchedulerEnded != pdFALSE )
+			{
+				prvParkThread();
+			}
+		}
+		portENABLE_INTERRUPTS();
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+uint16_t usPortHostTimerCount( void )
+{
+uint64_t ullElapsed = prvGetTime() - ullLastTickTime;
+uint64_t ullCount;
+
+	/* Scale the real time since the last tick to the AVR timer's counting rate. If a
+	tick is overdue, the count waits at the top, as it would while the tick interrupt
+	was held off on an AVR. */
+	ullCount = ( ullElapsed * ( portHOST_TIMER_TOP + 1ULL ) ) / ( ulTickPeriodUs * 1000ULL );
+	if( ullCount > portHOST_TIMER_TOP )
+	{
+		ullCount = portHOST_TIMER_TOP;
+	}
+	return ( uint16_t ) ullCount;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t func_get_run_time_counter( void )
+{
+	/* Run time statistics are kept in microseconds of real (host) time. */
+	return ( uint32_t ) ( ( prvGetTime() - ullStartTime ) / 1000ULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostPrintRunTimeStats( void )
+{
+#if( ( configUSE_TRACE_FACILITY == 1 ) && ( configGENERATE_RUN_TIME_STATS == 1 ) )
+TaskStatus_t xStatus[ 32 ];
+UBaseType_t uxCount, uxIndex;
+uint32_t ulTotalTime;
+uint64_t ullRealUs;
+TickType_t xTicks = xTaskGetTickCount();
+
+	uxCount = uxTaskGetSystemState( xStatus, 32, &ulTotalTime );
+	ullRealUs = ( ( ullEndTime != 0 ) ? ullEndTime : prvGetTime() ) - ullStartTime;
+	ullRealUs /= 1000ULL;
+
+	printf( "\nRTOS run: %lu ticks (%lu idle ticks skipped) in %llu us of host time",
+			( unsigned long ) xTicks, ( unsigned long ) xIdleTicksSkipped,
+			( unsigned long long ) ullRealUs );
+	if( ullRealUs > 0 )
+	{
+		printf( ", %.1f times real time",
+				( ( double ) xTicks * 1.0e6 / configTICK_RATE_HZ ) / ( double ) ullRealUs );
+	}
+	printf( "\n%-12s %4s %12s %7s %10s\n", "Task", "Pri", "Host us", "CPU %", "Stack free" );
+	for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+	{
+		printf( "%-12s %4u %12lu %7.2f %10u\n", xStatus[ uxIndex ].pcTaskName,
+				( unsigned ) xStatus[ uxIndex ].uxCurrentPriority,
+				( unsigned long ) xStatus[ uxIndex ].ulRunTimeCounter,
+				( ulTotalTime > 0 ) ? ( 100.0 * xStatus[ uxIndex ].ulRunTimeCounter
+										/ ( double ) ulTotalTime ) : 0.0,
+				( unsigned ) xStatus[ uxIndex ].usStackHighWaterMark );
+	}
+	fflush( stdout );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostReset( void )
+{
+	/* On a PC, a reset just ends the program after saying how it went. */
+	if( pxRunningThread != NULL )
+	{
+		ullEndTime = prvGetTime();
+		vPortHostPrintRunTimeStats();
+	}
+	fflush( stdout );
+	_exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+//-------------------------------------------------------------------------------------
+/** This function sets up the host's interval timer to deliver SIGALRM once every
+ *  simulated tick. It also puts the values which the AVR port would have put into
+ *  the Timer 5 registers into the simulated registers, so that programs which print
+ *  them (as some status displays do) print what they would on an AVR.
+ */
+
+static void prvSetupTimerInterrupt( void )
+{
+struct itimerval xTimer;
+
+	OCR5A = portHOST_TIMER_TOP;
+	TCCR5B = (1 << CS51) | (1 << WGM52);
+	TIMSK5 |= (1 << OCIE5A);
+
+	xTimer.it_interval.tv_sec = ulTickPeriodUs / 1000000UL;
+	xTimer.it_interval.tv_usec = ulTickPeriodUs % 1000000UL;
+	xTimer.it_value = xTimer.it_interval;
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+}
+/*-----------------------------------------------------------*/
+
+/* The tick signal set must be ready before the first task is created, which may be
+in a C++ constructor that runs before main(). */
+static void prvInitialiseTickSignal( void ) __attribute__ ( ( constructor ) );
+static void prvInitialiseTickSignal( void )
+{
+	sigemptyset( &xTickSignal );
+	sigaddset( &xTickSignal, SIGALRM );
+}
@@ -0,0 +1,149 @@
+//*************************************************************************************
+//
+// This version of portmacro.h is set up for running Cal Poly ME405 projects on a
+// POSIX (Linux) host computer instead of an AVR. Each task runs in its own thread, but
+// only one thread is allowed to run at a time, so the program behaves as it would on
+// a single processor. The RTOS tick is made from SIGALRM. Like the AVR version, this
+// file declares portStackTopForTask so that the task wrapper class can find stacks.
+//
+//*************************************************************************************
+
+/*
+    FreeRTOS V8.1.2 - Copyright (C) 2014 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>!AND MODIFIED BY!<< the FreeRTOS exception.
+
+    >>!   NOTE: The modification to the GPL is included to allow you to     !<<
+    >>!   distribute a combined work that includes FreeRTOS without being   !<<
+    >>!   obliged to provide the source code for proprietary components     !<<
+    >>!   outside of the FreeRTOS kernel.                                   !<<
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available from the following
+    link: http://www.freertos.org/a00114.html
+
+    1 tab == 4 spaces!
+*/
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * The settings in this file configure FreeRTOS correctly for a POSIX host
+ * compiled with GCC.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions. The base type is an int rather than a long so that it can
+be printed by the emstream operators for 32-bit numbers. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	size_t
+#define portBASE_TYPE	int
+
+typedef portSTACK_TYPE StackType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+/* The host pretends to have the same tick timer as the AVR, so the prescaler used
+by the clock that generates RTOS ticks is the same too. */
+#define portCLOCK_PRESCALER	8
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+/*-----------------------------------------------------------*/
+
+/* Critical section management. Interrupts are simulated, so disabling them only
+sets a flag; a tick which arrives while the flag is set is held pending, just as
+the AVR holds an interrupt flag until the I bit is set again. */
+extern void vPortDisableInterrupts( void );
+extern void vPortEnableInterrupts( void );
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+
+#define portENTER_CRITICAL()		vPortEnterCritical()
+#define portEXIT_CRITICAL()			vPortExitCritical()
+#define portDISABLE_INTERRUPTS()	vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()		vPortEnableInterrupts()
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT			8
+#define portNOP()					__asm volatile ( "nop" )
+/*-----------------------------------------------------------*/
+
+/* Kernel utilities. A yield from a (simulated) interrupt service routine is held
+off until the ISR returns. */
+extern void vPortYield( void );
+#define portYIELD()					vPortYield()
+#define portYIELD_FROM_ISR()		vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired ) \
+	do { if( xSwitchRequired ) vPortYield(); } while( 0 )
+/*-----------------------------------------------------------*/
+
+/* Tickless idle. When every task is blocked there's nothing to simulate, so rather
+than waiting for the tick timer the idle task jumps the tick count forward to the
+next time a task will wake up. This is what makes the host run faster than real
+time when the processor would have been idle. */
+#if( configUSE_TICKLESS_IDLE == 1 )
+	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) \
+		vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Host-only services. The tick timer count imitates the AVR's TCNT5 register, which
+counts from 0 to OCR5A between ticks; the remaining functions report on and end a
+simulation run. */
+extern uint16_t usPortHostTimerCount( void );
+extern BaseType_t xPortHostInISR( void );
+extern void vPortHostPrintRunTimeStats( void );
+extern void vPortHostReset( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+//-------------------------------------------------------------------------------------
+/* If stack tracing is active, declare a variable which will be used by the task
+ * wrapper class to get the address of the top of the stack just after a task has
+ * been created. */
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+	extern size_t portStackTopForTask;
+#endif
+
+#endif /* PORTMACRO_H */
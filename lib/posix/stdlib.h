@@ -0,0 +1,47 @@
+//*************************************************************************************
+/** @file    stdlib.h
+ *  @brief   Wrapper for the host's standard library header which adds avr-libc extras.
+ *  @details The avr-libc version of <stdlib.h> has some non-standard functions for
+ *           converting integers to text which ME405 code uses. This file includes the
+ *           host's own <stdlib.h>, then declares those functions, which are written
+ *           in avr_libc.c. It's found first because lib/posix is at the front of the
+ *           include path in host builds.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This wrapper is included along with the real header, so it gets its own guard
+#ifndef _POSIX_AVR_STDLIB_H_
+#define _POSIX_AVR_STDLIB_H_
+
+#include_next <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char* itoa (int value, char* string, int radix);
+char* utoa (unsigned int value, char* string, int radix);
+char* ltoa (long value, char* string, int radix);
+char* ultoa (unsigned long value, char* string, int radix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _POSIX_AVR_STDLIB_H_
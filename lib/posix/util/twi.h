@@ -0,0 +1,72 @@
+//*************************************************************************************
+/** @file    util/twi.h
+ *  @brief   Stand-in for the avr-libc TWI (I2C) status code header when compiling for a PC host.
+ *  @details These are the status codes found in the TWSR register of the AVR's two-wire
+ *           interface, copied from the values given in the AVR data sheets.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, for the POSIX host port
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//*************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _UTIL_TWI_H_
+#define _UTIL_TWI_H_
+
+#include <avr/io.h>
+
+// Master mode status codes
+#define TW_START                0x08
+#define TW_REP_START            0x10
+#define TW_MT_SLA_ACK           0x18
+#define TW_MT_SLA_NACK          0x20
+#define TW_MT_DATA_ACK          0x28
+#define TW_MT_DATA_NACK         0x30
+#define TW_MT_ARB_LOST          0x38
+#define TW_MR_ARB_LOST          0x38
+#define TW_MR_SLA_ACK           0x40
+#define TW_MR_SLA_NACK          0x48
+#define TW_MR_DATA_ACK          0x50
+#define TW_MR_DATA_NACK         0x58
+
+// Slave mode status codes
+#define TW_ST_SLA_ACK           0xA8
+#define TW_ST_ARB_LOST_SLA_ACK  0xB0
+#define TW_ST_DATA_ACK          0xB8
+#define TW_ST_DATA_NACK         0xC0
+#define TW_ST_LAST_DATA         0xC8
+#define TW_SR_SLA_ACK           0x60
+#define TW_SR_ARB_LOST_SLA_ACK  0x68
+#define TW_SR_GCALL_ACK         0x70
+#define TW_SR_ARB_LOST_GCALL_ACK 0x78
+#define TW_SR_DATA_ACK          0x80
+#define TW_SR_DATA_NACK         0x88
+#define TW_SR_GCALL_DATA_ACK    0x90
+#define TW_SR_GCALL_DATA_NACK   0x98
+#define TW_SR_STOP              0xA0
+
+// Miscellaneous codes
+#define TW_NO_INFO              0xF8
+#define TW_BUS_ERROR            0x00
+
+#define TW_STATUS_MASK          (_BV (TWS7) | _BV (TWS6) | _BV (TWS5) | _BV (TWS4) \
+                                | _BV (TWS3))
+#define TW_STATUS               (TWSR & TW_STATUS_MASK)
+
+#define TW_READ                 1
+#define TW_WRITE                0
+
+#endif // _UTIL_TWI_H_
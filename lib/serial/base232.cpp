@@ -27,7 +27,7 @@
  */
 //*************************************************************************************
 
-#ifdef __AVR
+#if defined (__AVR) || defined (POSIX_HOST)
 	#include <avr/io.h>						// Definitions of AVR's I/O registers
 #else
 	#include <stdlib.h>						// Standard stuff such as exit()
@@ -50,8 +50,8 @@
  *                     1 only exists on some processors). The default is port 0 
  */
 
-// This section compiles for the AVR microcontroller
-#ifdef __AVR
+// This section compiles for the AVR microcontroller (real or simulated)
+#if defined (__AVR) || defined (POSIX_HOST)
 base232::base232 (unsigned int baud_rate, unsigned char port_number)
 {
 	// If we're compiling for a chip with UCSR0A defined, it has dual serial ports
@@ -126,6 +126,11 @@ base232::base232 (unsigned int baud_rate, unsigned char port_number)
 	// Read the data register to ensure that it's empty
 	port_number = *p_UDR;
 	port_number = *p_UDR;
+
+	// A simulated transmitter is always empty and has always finished sending
+	#ifdef POSIX_HOST
+		*p_USR |= mask_UDRE | mask_TXC;
+	#endif
 }
 #else // If not AVR, we must be compiling for a Linux PC
 base232::base232 (char* port_name)
@@ -153,7 +158,7 @@ base232::base232 (char* port_name)
 
 bool base232::ready_to_send (void)
 {
-#ifdef __AVR
+#if defined (__AVR) || defined (POSIX_HOST)
 	// If transmitter buffer is full, we're not ready to send
 	if (*p_USR & mask_UDRE)
 		return (true);
@@ -176,7 +181,7 @@ bool base232::ready_to_send (void)
 
 bool base232::is_sending (void)
 {
-#ifdef __AVR
+#if defined (__AVR) || defined (POSIX_HOST)
 	if (*p_USR & mask_TXC)
 		return (false);
 	else
@@ -76,13 +76,15 @@
  *  useful things such as sending text messages and packets. 
  * 
  *  Code is present in this class to allow use in a Linux PC if \c __AVR is not
- *  defined. This may be helpful for testing and debugging RS-232 based code. 
+ *  defined. This may be helpful for testing and debugging RS-232 based code. If
+ *  \c POSIX_HOST is defined, the program is being compiled for the FreeRTOS host
+ *  port in \c lib/posix; then the AVR code is used with simulated registers. 
  */
 
 class base232
 {
 	protected:
-	#ifdef __AVR
+	#if defined (__AVR) || defined (POSIX_HOST)
 		/// This is a pointer to the data register used by the UART
 		volatile unsigned char* p_UDR;
 
@@ -106,7 +108,7 @@ class base232
 	#endif // __AVR
 
 	public:
-	#ifdef __AVR
+	#if defined (__AVR) || defined (POSIX_HOST)
 		/// The constructor sets up the port with the given baud rate and port number.
 		base232 (unsigned int = 9600, unsigned char = 0);
 	#else
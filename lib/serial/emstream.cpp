@@ -27,6 +27,7 @@
  *    \li 11-12-2012 JRR Made puts() non-virtual; made ENDL_STYLE() a function macro
  *    \li 12-21-2013 JRR Ported to ChibiOS
  *    \li 10-17-2014 JRR Made compatible with FreeRTOS for Cal Poly class use
+ *    \li 10-16-2026 ERR Added write(); puts() sends strings through it in blocks
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -163,28 +164,59 @@ void emstream::clear_screen (void)
 }
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   Write a block of characters to a serial device.
+ *  @details This method writes a given number of characters to the serial device.
+ *           This version just calls \c putchar() for each character; descendent
+ *           classes for which sending each character separately is slow, such as
+ *           queues, should override it with a method that sends the whole block at
+ *           once. The characters don't need to end with a null character, and any
+ *           null characters in the block are sent like all the others.
+ *  @param   p_data A pointer to the characters which are to be written
+ *  @param   length The number of characters to be written
+ */
+
+void emstream::write (const char* p_data, size_t length)
+{
+	while (length--)
+	{
+		putchar (*p_data++);
+	}
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   Write a character string to a serial device.
- *  @details This method writes a string to the serial device. It goes through the 
- *           character buffer to which its parameter points, calling \c putchar() to 
- *           print each character until and end of string character (the null 
- *           character, \c '\0') is reached.
+ *  @details This method writes a string to the serial device. A string in RAM is sent
+ *           with one call to \c write(). A string in program memory can't be given
+ *           to \c write() directly, so it is copied into a small buffer a piece at a
+ *           time and each piece is written, until the end of string character (the
+ *           null character, \c '\0') is reached.
  *  @param   p_string A pointer to the string which is to be printed
  */
 
 void emstream::puts (const char* p_string)
 {
 #ifdef __AVR
-	char ch;                                // Temporary storage for a character
-
 	// If the program-string variable is set, this string is to be found in program
 	// memory rather than data memory
 	if (pgm_string)
 	{
+		char buffer[16];                    // Holds pieces of the string from flash
+		uint8_t count = 0;                  // Number of characters in the buffer
+
 		pgm_string = false;
-		while ((ch = pgm_read_byte_near (p_string++)))
+		while ((buffer[count] = pgm_read_byte_near (p_string++)))
 		{
-			putchar (ch);
+			if (++count >= sizeof (buffer))
+			{
+				write (buffer, count);
+				count = 0;
+			}
+		}
+		if (count)
+		{
+			write (buffer, count);
 		}
 	}
 	// If the program-string variable is not set, the string is in RAM and printed
@@ -192,10 +224,7 @@ void emstream::puts (const char* p_string)
 	else
 #endif
 	{
-		while (*p_string)
-		{
-			putchar (*p_string++);
-		}
+		write (p_string, strlen (p_string));
 	}
 }
 
@@ -23,6 +23,7 @@
  *    \li 10-22-2012 JRR Fixed (OK, hacked around) bug which caused spurious warning 
  *                       for all Program Memory Strings
  *    \li 11-12-2012 JRR Made puts() non-virtual; made ENDL_STYLE() a function macro
+ *    \li 10-16-2026 ERR Added write() so strings are sent as blocks, not one by one
  *
  *  License:
  *    This file released under the Lesser GNU Public License, version 2. This program
@@ -97,7 +98,7 @@ extern "C"
  *  \details Different recieving programs want different end-of-line markers. 
  *  Traditionally, UNIX uses "\r" while PC's use "\r\n" and Macs use "\n" (I think). 
  */
-#define ENDL_STYLE()        putchar ('\r'); putchar ('\n')
+#define ENDL_STYLE()        write ("\r\n", 2)
 
 
 /** \brief This define selects the character which asks a terminal to clear its screen.
@@ -239,6 +240,11 @@ ser_manipulator setbase (uint8_t new_base);
  *    \li \c check_for_char() - Checks if a character is ready to be read
  *    \li \c getchar() - Reads a character from the device when one becomes available
  * 
+ *  Strings, numbers and end-of-line markers are sent through \c write() as blocks
+ *  of characters. The version of \c write() in this class just calls \c putchar()
+ *  for each character, but a device which has a lot of work to do for each transfer,
+ *  such as a queue, should override \c write() to move the whole block at once.
+ * 
  *  Other methods may optionally be overridden; for example \c clear_screen() is only
  *  needed by devices which have a screen, and some devices may be read-only or 
  *  write-only, so some methods may not be needed. 
@@ -307,6 +313,9 @@ class emstream
 
 		void puts (const char*);            // Write a string to the serial device
 
+		// Write a block of characters to the serial device
+		virtual void write (const char* p_data, size_t length);
+
 		virtual bool check_for_char (void); // Check if a character is in the buffer
 		virtual char getchar (void);        // Get a character; wait if none is ready
 		virtual void transmit_now (void);   // Immediately transmit any buffered data
@@ -49,18 +49,23 @@ emstream& emstream::operator<< (uint8_t num)
 	}
 	else if (base == 2)
 	{
+		char out_str[8];
+		char* p_out = out_str;
 		for (uint8_t bmask = 0x80; bmask != 0; bmask >>= 1)
 		{
-			if (num & bmask) putchar ('1');
-			else             putchar ('0');
+			if (num & bmask) *p_out++ = '1';
+			else             *p_out++ = '0';
 		}
+		write (out_str, 8);
 	}
 	else if (base == 16)
 	{
+		char out_str[2];
 		temp_char = (num >> 4) & 0x0F;
-		putchar ((temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0');
+		out_str[0] = (temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0';
 		temp_char = num & 0x0F;
-		putchar ((temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0');
+		out_str[1] = (temp_char > 9) ? temp_char + ('A' - 10) : temp_char + '0';
+		write (out_str, 2);
 	}
 	else
 	{
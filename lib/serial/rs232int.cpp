@@ -23,6 +23,10 @@
  *    \li 07-05-2008 JRR Changed from 1 to 2 stop bits to placate finicky receivers
  *    \li 12-22-2008 JRR Split off stuff in base232.h for efficiency
  *    \li 06-30-2009 JRR Received data interrupt and buffer added
+ *    \li 10-16-2026 ERR Transmitter interrupt and buffer added, with overflow policy
+ *    \li 10-16-2026 ERR Receiver interrupt can hand characters to a hook function
+ *    \li 10-16-2026 ERR Receiver interrupt can wake a task waiting for characters
+ *    \li 10-16-2026 ERR A full buffer puts a blocked sender to sleep rather than spin
  *
  *  License:
  *		This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -43,32 +47,161 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <avr/io.h>
+#include "FreeRTOS.h"						// For critical sections around the buffers
+#include "task.h"							// For sleeping while the buffer is full
+#include "spsc_ring.h"						// Lock-free buffers for received characters
 #include "rs232int.h"
 
+// On a PC running the FreeRTOS host port, the simulated USART's data register is
+// connected to the terminal through the standard input and output files
+#ifdef POSIX_HOST
+	#include <fcntl.h>
+	#include <unistd.h>
+
+	extern "C" void RSI_CHAR_RECV_INT_0 (void);
+	extern "C" void RSI_DATA_EMPTY_INT_0 (void);
+	#ifdef RSI_CHAR_RECV_INT_1
+		extern "C" void RSI_CHAR_RECV_INT_1 (void);
+	#endif
+	#ifdef RSI_DATA_EMPTY_INT_1
+		extern "C" void RSI_DATA_EMPTY_INT_1 (void);
+	#endif
+#endif
+
 
 // Every AVR has at least one serial port, so enable at least one receiver buffer
 /// This buffer holds characters received through serial port 0 by the ISR. 
-uint8_t* rcv0_buffer = NULL;
+SpscRing<uint8_t, RSINT_BUF_SIZE> rcv0_ring;
+
+// If there's a UCSR1A register, there are 2 serial ports, so enable another buffer
+#ifdef UCSR1A
+	/// This buffer holds characters received through serial port 1 by the ISR. 
+	SpscRing<uint8_t, RSINT_BUF_SIZE> rcv1_ring;
+#endif
 
-/// This index is used to write into serial character receiver buffer 0.
-uint16_t rcv0_read_index;
+/// If not NULL, the function to which the ISR hands characters from serial port 0
+volatile rs232_rx_hook rcv0_hook = NULL;
 
-/// This index is used to read from serial character receiver buffer 0. 
-uint16_t rcv0_write_index;
+#ifdef UCSR1A
+	/// If not NULL, the function to which the ISR hands characters from port 1
+	volatile rs232_rx_hook rcv1_hook = NULL;
+#endif
+
+/// This structure holds how the ISR for serial port 0 wakes a task waiting for input.
+rs232_rx_wake rcv0_wake = {NULL, RS232_NO_DELIMITER, 0};
 
-// If there's a UCSR0A register, there are 2 serial ports, so enable another buffer
 #ifdef UCSR1A
-	/// This buffer holds characters received through serial port 1 by the ISR. 
-	uint8_t* rcv1_buffer = NULL;
+	/// This structure holds how the ISR for serial port 1 wakes a waiting task.
+	rs232_rx_wake rcv1_wake = {NULL, RS232_NO_DELIMITER, 0};
+#endif
 
-	/// This index is used to write into serial character receiver buffer 1.
-	uint16_t rcv1_read_index;
+/// This structure holds characters waiting to be sent through serial port 0.
+rs232_tx_buffer xmt0 = {NULL, 0, 0, 0, NULL, NULL, NULL, 0, 0};
 
-	/// This index is used to read from serial character receiver buffer 1. 
-	uint16_t rcv1_write_index;
+#ifdef UCSR1A
+	/// This structure holds characters waiting to be sent through serial port 1.
+	rs232_tx_buffer xmt1 = {NULL, 0, 0, 0, NULL, NULL, NULL, 0, 0};
 #endif
 
 
+//-------------------------------------------------------------------------------------
+/** This function sends the oldest character in a transmitter buffer to the USART. It
+ *  must only be called from an ISR or a critical section, and only when the buffer 
+ *  isn't empty and the USART's data register is empty. 
+ *  @param p_buf Pointer to the transmitter buffer for the serial port
+ */
+
+static inline void xmt_send (rs232_tx_buffer* p_buf)
+{
+	uint8_t chout = p_buf->p_data[p_buf->read_index];
+
+	if (++(p_buf->read_index) >= p_buf->size)
+	{
+		p_buf->read_index = 0;
+	}
+
+	// Clear the TXCn bit so it can be used to check if the serial port is busy.  This
+	// check needs to be done prior to putting the processor into sleep mode.  Oddly,
+	// the TXCn bit is cleared by writing a one to its bit location
+	*(p_buf->p_USR) |= p_buf->mask_TXC;
+	*(p_buf->p_UDR) = chout;
+
+	// A simulated USART "transmits" by writing to the terminal
+	#ifdef POSIX_HOST
+		::write (STDOUT_FILENO, &chout, 1);
+	#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function does the work of the data register empty interrupt service routines.
+ *  It sends one character from the transmitter buffer; when the buffer is empty, it
+ *  turns off the interrupt, which would otherwise keep happening as long as the data
+ *  register is empty. A simulated USART is always empty, so on a PC the whole buffer
+ *  is sent at once. 
+ *  @param p_buf Pointer to the transmitter buffer for the serial port
+ */
+
+static inline void xmt_isr (rs232_tx_buffer* p_buf)
+{
+	#ifdef POSIX_HOST
+		while (p_buf->read_index != p_buf->write_index)
+	#else
+		if (p_buf->read_index != p_buf->write_index)
+	#endif
+	{
+		xmt_send (p_buf);
+	}
+
+	if (p_buf->read_index == p_buf->write_index)
+	{
+		*(p_buf->p_UCR) &= ~(p_buf->mask_UDRIE);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function does the work of the character received interrupt service routines.
+ *  The character is handed to the hook function if there is one, or else put into
+ *  the receiver buffer. If a task is waiting for characters and the hook asks for it
+ *  to be woken, or the character is the delimiter, or enough characters are waiting,
+ *  the task's semaphore is given. A task which was woken and has a higher priority 
+ *  than the one interrupted is switched to before the ISR returns, as FreeRTOS's own
+ *  AVR serial port demonstration does, rather than waiting for the next tick. 
+ *  @param data The character which was received
+ *  @param p_hook Pointer to the port's hook function, or NULL if it has none
+ *  @param ring The port's receiver buffer
+ *  @param wake The structure which says when to wake a waiting task
+ */
+
+static inline void rcv_isr (uint8_t data, rs232_rx_hook p_hook, 
+							SpscRing<uint8_t, RSINT_BUF_SIZE>& ring, rs232_rx_wake& wake)
+{
+	bool wake_task;
+
+	if (p_hook)
+	{
+		wake_task = p_hook (data);
+	}
+	else
+	{
+		ring.put (data);
+		wake_task = ((int16_t)data == wake.delimiter) 
+			|| (wake.threshold != 0 && ring.num_items () >= wake.threshold);
+	}
+
+	if (wake_task && wake.signal != NULL)
+	{
+		BaseType_t task_awakened = pdFALSE;
+		xSemaphoreGiveFromISR (wake.signal, &task_awakened);
+		if (task_awakened != pdFALSE)
+		{
+			portYIELD ();
+		}
+	}
+}
+
+
 //-------------------------------------------------------------------------------------
 /** This method sets up the AVR UART for communications.  It calls the emstream
  *  constructor, which prepares to convert numbers to text strings, and the base232 
@@ -80,46 +213,96 @@ uint16_t rcv0_write_index;
  *  @param baud_rate The desired baud rate for serial communications. Default is 9600
  *  @param port_number The number of the serial port, 0 or 1 (the second port numbered
  *                     1 only exists on some processors). The default is port 0 
+ *  @param tx_buf_size The size of the buffer which holds characters waiting to be
+ *                     sent. The default is \c RSINT_TX_BUF_SIZE 
+ *  @param policy What to do when a character is to be sent but the transmitter 
+ *                buffer is full. The default, \c RS232_TX_BLOCK, waits for room 
  */
 
-rs232::rs232 (uint16_t baud_rate, uint8_t port_number)
+rs232::rs232 (uint16_t baud_rate, uint8_t port_number, uint16_t tx_buf_size,
+			  rs232_tx_policy policy)
 	: emstream (), base232 (baud_rate, port_number)
 {
 	// Save the number of the serial port, 0 or 1
 	port_num = port_number;
 
+	tx_policy = policy;
+	tx_dropped = 0;
+	tx_peak = 0;
+
+	// Find the transmitter buffer and data register empty interrupt enable bit for 
+	// this port. The base232 constructor has just turned the interrupt off
+	#if defined UCSR1A
+		if (port_number == 0)
+		{
+			p_xmt = &xmt0;
+			p_xmt->mask_UDRIE = (1 << UDRIE0);
+			p_wake = &rcv0_wake;
+		}
+		else
+		{
+			p_xmt = &xmt1;
+			p_xmt->mask_UDRIE = (1 << UDRIE1);
+			p_wake = &rcv1_wake;
+		}
+	#elif defined UCSR0A
+		p_xmt = &xmt0;
+		p_xmt->mask_UDRIE = (1 << UDRIE0);
+		p_wake = &rcv0_wake;
+	#else
+		p_xmt = &xmt0;
+		p_xmt->mask_UDRIE = (1 << UDRIE);
+		p_wake = &rcv0_wake;
+	#endif
+
+	// Allocate memory for the transmitter buffer and start with it empty. If another
+	// object on the same port already has a buffer, this one shares it, size and all,
+	// as characters which that object put in may still be waiting to be sent. The
+	// buffer needs room for at least one character as well as the place which is
+	// always left empty
+	if (tx_buf_size < 2)
+	{
+		tx_buf_size = 2;
+	}
+	if (p_xmt->p_data == NULL)
+	{
+		p_xmt->p_data = new uint8_t[tx_buf_size];
+		p_xmt->size = tx_buf_size;
+		p_xmt->read_index = 0;
+		p_xmt->write_index = 0;
+	}
+	p_xmt->p_UDR = p_UDR;
+	p_xmt->p_USR = p_USR;
+	p_xmt->p_UCR = p_UCR;
+	p_xmt->mask_TXC = mask_TXC;
+
+	// The base232 constructor turned the interrupt off; turn it back on if there are
+	// characters left in a shared buffer
+	if (p_xmt->read_index != p_xmt->write_index)
+	{
+		*p_UCR |= p_xmt->mask_UDRIE;
+	}
+
 	// If we're compiling for a chip with UCSR0A defined, it has dual serial ports
 	// (examples are ATmega324P and ATmega128). Set up Port 0 or Port 1
 	#if defined UCSR0A // Serial port number 0
 		if (port_number == 0)
 		{
+			rcv0_ring.flush ();				// Start with an empty receiver buffer
 			UCSR0B |= (1 << RXCIE0);		// Receive complete interrupt enable
-
-			// Allocate some memory for the receiver buffer and reset the indices
-			rcv0_buffer = new uint8_t[RSINT_BUF_SIZE];
-			rcv0_read_index = 0;
-			rcv0_write_index = 0;
 		}
 		else  // Serial port number 1
 		{
 		#if defined UCSR1A
+			rcv1_ring.flush ();				// Start with an empty receiver buffer
 			UCSR1B |= (1 << RXCIE1);		// Receive complete interrupt enable
-
-			// Allocate some memory for the receiver buffer and reset the indices
-			rcv1_buffer = new uint8_t[RSINT_BUF_SIZE];
-			rcv1_read_index = 0;
-			rcv1_write_index = 0;
 		#endif // UCSR1A
 		}
 	// We're compiling for a chip which doesn't define UCSR0A; assume it has only one
 	// serial port.
 	#else
+		rcv0_ring.flush ();					// Start with an empty receiver buffer
 		UCSRB |= (1 << RXCIE);				// Receive complete interrupt enable
-
-		// Allocate some memory for the receiver buffer and reset the indices
-		rcv0_buffer = new uint8_t[RSINT_BUF_SIZE];
-		rcv0_read_index = 0;
-		rcv0_write_index = 0;
 	#endif
 
 	// The Xiphos 1.0 board may need the pullup activated on the RXD1 line in order to
@@ -128,40 +311,198 @@ rs232::rs232 (uint16_t baud_rate, uint8_t port_number)
 		if (port_number == 1)
 			PORTD |= 0x04;
 	#endif
+
+	// Don't let the simulated receiver wait for the user to type something
+	#ifdef POSIX_HOST
+		fcntl (STDIN_FILENO, F_SETFL, fcntl (STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+	#endif
 }
 
 
 //-------------------------------------------------------------------------------------
-/** This method sends one character to the serial port.  It waits until the port is
- *  ready, so it can hold up the system for a while.  It times out if it waits too 
- *  long to send the character; you can check the return value to see if the character
- *  was successfully sent, or just cross your fingers and ignore the return value.
- *  Note 1:  It's possible that at slower baud rates and/or higher processor speeds, 
- *  this routine might time out even when the port is working fine.  A solution would
- *  be to change the count variable to an integer and use a larger starting number. 
- *  Note 2:  Fixed!  The count is now an integer and it works at lower baud rates.
+/** This method sends one character to the serial port. The character is put into the
+ *  transmitter buffer and the data register empty interrupt is turned on; the ISR 
+ *  will send the character when the USART is ready for it. If the buffer is full, 
+ *  what happens depends on the port's \c rs232_tx_policy. With \c RS232_TX_BLOCK, 
+ *  this method waits for room. Once the scheduler is running, the task sleeps for a
+ *  tick at a time while the ISR sends characters, so other tasks can run, and gives
+ *  up after \c UART_TX_TOUT_TICKS ticks; before then it sends characters itself, as
+ *  interrupts may be off, and gives up after \c UART_TX_TOUT tries. A character
+ *  which can't be sent in time is dropped, as earlier versions did when the port
+ *  was stuck. With \c RS232_TX_DROP the new character is thrown away,
+ *  and with \c RS232_TX_OVERWRITE the oldest one in the buffer is thrown away to 
+ *  make room for it. 
  *  @param chout The character to be sent out
- *  @return True if everything was OK and false if there was a timeout
  */
 
 void rs232::putchar (char chout)
 {
-	// Now wait for the serial port transmitter buffer to be empty	 
-	for (uint16_t count = 0; ((*p_USR & mask_UDRE) == 0); count++)
+	uint16_t next_index;					// Where the write index will go next
+	uint16_t count = 0;						// Counts tries to find room in the buffer
+
+	portENTER_CRITICAL ();
+
+	// The buffer is full if putting in one more character would make the indices
+	// equal, as that would look like an empty buffer
+	while (true)
 	{
-		if (count > UART_TX_TOUT)
+		next_index = p_xmt->write_index + 1;
+		if (next_index >= p_xmt->size)
+		{
+			next_index = 0;
+		}
+		if (next_index != p_xmt->read_index)
+		{
+			break;
+		}
+
+		// Sleep while the ISR makes room, or make room here if the scheduler hasn't
+		// started, as interrupts may be off
+		if (tx_policy == RS232_TX_BLOCK)
 		{
+			if (xTaskGetSchedulerState () == taskSCHEDULER_RUNNING)
+			{
+				if (++count <= UART_TX_TOUT_TICKS)
+				{
+					portEXIT_CRITICAL ();
+					vTaskDelay (1);
+					portENTER_CRITICAL ();
+					continue;
+				}
+			}
+			else if (++count <= UART_TX_TOUT)
+			{
+				portEXIT_CRITICAL ();
+				send_from_buffer ();
+				portENTER_CRITICAL ();
+				continue;
+			}
+		}
+
+		// Throw away the new character or the oldest one in the buffer
+		tx_dropped++;
+		if (tx_policy != RS232_TX_OVERWRITE)
+		{
+			portEXIT_CRITICAL ();
 			return;
 		}
+		if (++(p_xmt->read_index) >= p_xmt->size)
+		{
+			p_xmt->read_index = 0;
+		}
 	}
 
-	// Clear the TXCn bit so it can be used to check if the serial port is busy.  This
-	// check needs to be done prior to putting the processor into sleep mode.  Oddly,
-	// the TXCn bit is cleared by writing a one to its bit location
-	*p_USR |= mask_TXC;
+	// Put the character in the buffer and make sure the ISR will send it
+	p_xmt->p_data[p_xmt->write_index] = chout;
+	p_xmt->write_index = next_index;
+	*p_UCR |= p_xmt->mask_UDRIE;
+
+	// Keep track of how full the buffer has been
+	uint16_t waiting = tx_waiting ();
+	if (waiting > tx_peak)
+	{
+		tx_peak = waiting;
+	}
+
+	portEXIT_CRITICAL ();
 
-	// The CTS line is 0 and the transmitter buffer is empty, so send the character
-	*p_UDR = chout;
+	// The simulated USART's data register is always empty, so the interrupt happens
+	// as soon as it's enabled, or as soon as interrupts are turned back on
+	#ifdef POSIX_HOST
+		#ifdef RSI_DATA_EMPTY_INT_1
+			vPortHostInterrupt (port_num ? RSI_DATA_EMPTY_INT_1 : RSI_DATA_EMPTY_INT_0);
+		#else
+			vPortHostInterrupt (RSI_DATA_EMPTY_INT_0);
+		#endif
+	#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends one character from the transmitter buffer if there's one waiting
+ *  and the USART is ready to take it. It's used to empty the buffer when the data
+ *  register empty interrupt can't, for example because interrupts are turned off 
+ *  while something is being printed before the scheduler starts. 
+ *  @return True if a character was sent and false if not
+ */
+
+bool rs232::send_from_buffer (void)
+{
+	bool sent = false;						// Whether a character was sent
+
+	portENTER_CRITICAL ();
+	if ((*p_USR & mask_UDRE) && p_xmt->read_index != p_xmt->write_index)
+	{
+		xmt_send (p_xmt);
+		sent = true;
+	}
+	portEXIT_CRITICAL ();
+
+	return (sent);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method finds how many characters are waiting in the transmitter buffer. The
+ *  indices are changed by the ISR and are two bytes long, so they're read in a 
+ *  critical section. 
+ *  @return The number of characters which haven't yet been sent
+ */
+
+uint16_t rs232::tx_waiting (void)
+{
+	uint16_t waiting;						// The number of characters waiting
+
+	portENTER_CRITICAL ();
+	if (p_xmt->write_index >= p_xmt->read_index)
+	{
+		waiting = p_xmt->write_index - p_xmt->read_index;
+	}
+	else
+	{
+		waiting = p_xmt->size - p_xmt->read_index + p_xmt->write_index;
+	}
+	portEXIT_CRITICAL ();
+
+	return (waiting);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method waits until every character in the transmitter buffer has been sent
+ *  and the USART has finished sending the last one. It is called when the format 
+ *  modifier \c send_now is inserted in a line of "<<" stuff, for example before the
+ *  processor is reset or put to sleep. If the buffer stops emptying for a long time,
+ *  the port is assumed to be stuck and the method gives up. 
+ */
+
+void rs232::transmit_now (void)
+{
+	uint16_t waiting;						// Characters still in the buffer
+	uint16_t last_waiting = 0;				// Characters there the last time we looked
+	uint16_t count = 0;						// Counts tries without any progress
+
+	while ((waiting = tx_waiting ()) != 0)
+	{
+		if (send_from_buffer () || waiting != last_waiting)
+		{
+			count = 0;
+		}
+		else if (++count > UART_TX_TOUT)
+		{
+			return;
+		}
+		last_waiting = waiting;
+	}
+
+	// Now wait for the last character to go out of the USART's shift register
+	for (count = 0; is_sending (); count++)
+	{
+		if (count > UART_TX_TOUT)
+		{
+			return;
+		}
+	}
 }
 
 
@@ -178,28 +519,17 @@ char rs232::getchar (void)
 	uint8_t recv_char;						// Character read from the queue
 
 	// Wait until there's a character in the receiver queue
-	#ifdef UCSR0A  // If this is a dual-port chip
+	#ifdef UCSR1A  // If this is a dual-port chip
 		if (port_num == 0)
 		{
-			while (rcv0_read_index == rcv0_write_index);
-			recv_char = rcv0_buffer[rcv0_read_index];
-			if (++rcv0_read_index >= RSINT_BUF_SIZE)
-				rcv0_read_index = 0;
+			while (!rcv0_ring.get (recv_char));
 		}
 		else  // This is port 1 of a dual-port chip
 		{
-		#if defined UCSR1A
-			while (rcv1_read_index == rcv1_write_index);
-			recv_char = rcv1_buffer[rcv1_read_index];
-			if (++rcv1_read_index >= RSINT_BUF_SIZE)
-				rcv1_read_index = 0;
-		#endif // UCSR1A
+			while (!rcv1_ring.get (recv_char));
 		}
 	#else  // This chip has only one serial port
-		while (rcv0_read_index == rcv0_write_index);
-		recv_char = rcv0_buffer[rcv0_read_index];
-		if (++rcv0_read_index >= RSINT_BUF_SIZE)
-			rcv0_read_index = 0;
+		while (!rcv0_ring.get (recv_char));
 	#endif
 
 	return (recv_char);
@@ -215,17 +545,131 @@ char rs232::getchar (void)
 
 bool rs232::check_for_char (void)
 {
+	// A character typed at the terminal is put into the simulated USART's data
+	// register, then the receive interrupt is run just as it would be on an AVR
+	#ifdef POSIX_HOST
+		char ch_in;
+		if (::read (STDIN_FILENO, &ch_in, 1) == 1)
+		{
+			*p_UDR = ch_in;
+			#ifdef RSI_CHAR_RECV_INT_1
+				vPortHostInterrupt (port_num ? RSI_CHAR_RECV_INT_1 : RSI_CHAR_RECV_INT_0);
+			#else
+				vPortHostInterrupt (RSI_CHAR_RECV_INT_0);
+			#endif
+		}
+	#endif
+
 	#ifdef UCSR1A							// If this is a dual-port chip
 		if (port_num == 0)
-			return (rcv0_read_index != rcv0_write_index);
+			return (!rcv0_ring.is_empty ());
 		else
-			return (rcv1_read_index != rcv1_write_index);
+			return (!rcv1_ring.is_empty ());
 	#else									// This chip has only one serial port
-		return (rcv0_read_index != rcv0_write_index);
+		return (!rcv0_ring.is_empty ());
 	#endif
 }
 
 
+//-------------------------------------------------------------------------------------
+/** This method returns the number of received characters which have been thrown away
+ *  because the receiver buffer was full when they arrived. If this number isn't zero,
+ *  the task which reads from the port should run more often or \c RSINT_BUF_SIZE 
+ *  should be made larger. 
+ *  @return The number of received characters which were lost
+ */
+
+uint16_t rs232::get_rx_dropped (void)
+{
+	#ifdef UCSR1A							// If this is a dual-port chip
+		if (port_num == 0)
+			return (rcv0_ring.get_overflows ());
+		else
+			return (rcv1_ring.get_overflows ());
+	#else									// This chip has only one serial port
+		return (rcv0_ring.get_overflows ());
+	#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sets a function to which the character received interrupt hands each
+ *  character from this port, instead of putting it into the receiver buffer. Data
+ *  such as a stream of frames can then be decoded as it arrives, with no buffer in
+ *  between to fill up and no task polling it. While a hook is set, \c getchar() and 
+ *  \c check_for_char() find no characters, except that on a PC \c check_for_char()
+ *  must still be called to read the terminal, which runs the interrupt. 
+ *  @param p_hook Pointer to the function, or NULL to use the receiver buffer again
+ */
+
+void rs232::set_rx_hook (rs232_rx_hook p_hook)
+{
+	#ifdef UCSR1A							// If this is a dual-port chip
+		if (port_num == 0)
+			rcv0_hook = p_hook;
+		else
+			rcv1_hook = p_hook;
+	#else									// This chip has only one serial port
+		rcv0_hook = p_hook;
+	#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method lets a task sleep in \c wait_for_rx() until characters arrive. The
+ *  receiver ISR wakes the task when the delimiter arrives or when at least 
+ *  \c threshold characters are waiting in the buffer, whichever comes first. If a 
+ *  hook function has been set, the hook decides when to wake the task instead. It 
+ *  should be called once, before the scheduler starts or by the task which reads the
+ *  port; only one task at a time can wait for each port. 
+ *  @param delimiter The character which wakes the task, such as a carriage return,
+ *                   or \c RS232_NO_DELIMITER (the default) if there isn't one
+ *  @param threshold The number of waiting characters which wakes the task, or 0 to
+ *                   wake it only at a delimiter. The default, 1, wakes the task at
+ *                   every character
+ */
+
+void rs232::enable_rx_wake (int16_t delimiter, uint8_t threshold)
+{
+	if (p_wake->signal == NULL)
+	{
+		SemaphoreHandle_t new_signal = xSemaphoreCreateBinary ();
+		if (new_signal == NULL)
+		{
+			*this << PMS ("rs232: No memory for receiver semaphore") << endl;
+			return;
+		}
+		p_wake->signal = new_signal;
+	}
+
+	portENTER_CRITICAL ();
+	p_wake->delimiter = delimiter;
+	p_wake->threshold = threshold;
+	portEXIT_CRITICAL ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts the calling task to sleep until the receiver ISR wakes it or the
+ *  timeout runs out. The ISR's signal is remembered, so a delimiter which arrived
+ *  while the task was busy wakes it at once the next time it waits. Characters 
+ *  which have arrived but haven't reached the delimiter or threshold don't wake the
+ *  task, so it should always read everything in the buffer when it wakes. If 
+ *  \c enable_rx_wake() hasn't been called, this method just checks the buffer. 
+ *  @param timeout The longest time to wait, in RTOS ticks (default: forever)
+ *  @return True if the task was woken by the ISR, false if the timeout ran out
+ */
+
+bool rs232::wait_for_rx (TickType_t timeout)
+{
+	if (p_wake->signal == NULL)
+	{
+		return (check_for_char ());
+	}
+	return (xSemaphoreTake (p_wake->signal, timeout) == pdTRUE);
+}
+
+
 //-------------------------------------------------------------------------------------
 /** This method sends the ASCII code to clear a display screen. It is called when the
  *  format modifier 'clrscr' is inserted in a line of "<<" stuff.
@@ -240,54 +684,64 @@ void rs232::clear_screen (void)
 //-------------------------------------------------------------------------------------
 /** \cond NOT_ENABLED  (This ISR is not to be documented by Doxygen)
  *  This interrupt service routine runs whenever a character has been received by the
- *  first serial port (number 0).  It saves that character into the receiver buffer.
+ *  first serial port (number 0).  It saves that character into the receiver buffer,
+ *  or hands it to the hook function if one has been set. If the buffer is full, the
+ *  new character is thrown away and counted. 
  */
 
 ISR (RSI_CHAR_RECV_INT_0)
 {
 	// When this ISR is triggered, there's a character waiting in the USART data reg-
-	// ister, and the write index indexes the place where that character should go
-
+	// ister. It must be read even if there's no room for it, to clear the interrupt
 	#if defined UCSR0A  // If this is a dual-serial-port chip (ATmega324P, 128, etc.)
-		rcv0_buffer[rcv0_write_index] = UDR0;
+		uint8_t data = UDR0;
 	#else  // If this chip has only a single serial port (ATmega8, 32, etc.)
-		rcv0_buffer[rcv0_write_index] = UDR;
+		uint8_t data = UDR;
 	#endif
 
-	// Increment the write pointer
-	if (++rcv0_write_index >= RSINT_BUF_SIZE)
-		rcv0_write_index = 0;
-
-	// If the write pointer is now equal to the read pointer, that means we've just
-	// overwritten the oldest data. Increment the read pointer so that it doesn't seem
-	// as if the buffer is empty
-	if (rcv0_write_index == rcv0_read_index)
-		if (++rcv0_read_index >= RSINT_BUF_SIZE)
-			rcv0_read_index = 0;
+	rcv_isr (data, rcv0_hook, rcv0_ring, rcv0_wake);
 }
 
 
 #ifdef UCSR1A // The second ISR is only compiled for processors with dual serial ports
 	//-------------------------------------------------------------------------------------
 	/** This interrupt service routine runs whenever a character has been received by the
-	*  first serial port (number 0).  It saves that character into the receiver buffer.
+	*  second serial port (number 1).  It saves that character into the receiver buffer,
+	*  or hands it to the hook function if one has been set.
 	*/
 
 	ISR (RSI_CHAR_RECV_INT_1)
 	{
 		// Read the character from the serial port receiver buffer
-		rcv1_buffer[rcv1_write_index] = UDR1;
-
-		// Increment the write pointer
-		if (++rcv1_write_index >= RSINT_BUF_SIZE)
-			rcv1_write_index = 0;
-
-		// If the write pointer is now equal to the read pointer, that means we've just
-		// overwritten the oldest data. Increment the read pointer so that it doesn't seem
-		// as if the buffer is empty
-		if (rcv1_write_index == rcv1_read_index)
-			if (++rcv1_read_index >= RSINT_BUF_SIZE)
-				rcv1_read_index = 0;
+		uint8_t data = UDR1;
+
+		rcv_isr (data, rcv1_hook, rcv1_ring, rcv1_wake);
+	}
+#endif // Dual serial ports
+
+
+//-------------------------------------------------------------------------------------
+/** This interrupt service routine runs whenever serial port 0 is ready to send a 
+ *  character and its data register empty interrupt is enabled. It sends the next
+ *  character from the transmitter buffer. 
+ */
+
+ISR (RSI_DATA_EMPTY_INT_0)
+{
+	xmt_isr (&xmt0);
+}
+
+
+#ifdef RSI_DATA_EMPTY_INT_1
+	//---------------------------------------------------------------------------------
+	/** This interrupt service routine runs whenever serial port 1 is ready to send a
+	 *  character and its data register empty interrupt is enabled. It sends the next
+	 *  character from the transmitter buffer. 
+	 */
+
+	ISR (RSI_DATA_EMPTY_INT_1)
+	{
+		xmt_isr (&xmt1);
 	}
 #endif // Dual serial ports
 /** \endcond  (End of section which is not to be documented by Doxygen) */
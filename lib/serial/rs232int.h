@@ -23,6 +23,11 @@
  *    \li 07-05-2008 JRR Changed from 1 to 2 stop bits to placate finicky receivers
  *    \li 12-22-2008 JRR Split off stuff in base232.h for efficiency
  *    \li 06-30-2009 JRR Received data interrupt and buffer added
+ *    \li 10-16-2026 ERR Transmitter interrupt and buffer added, with overflow policy
+ *    \li 10-16-2026 ERR Receiver buffers changed to lock-free \c SpscRing objects
+ *    \li 10-16-2026 ERR Received characters can be passed to a hook in the ISR
+ *    \li 10-16-2026 ERR Receiver ISR can wake a task at a delimiter or threshold
+ *    \li 10-16-2026 ERR A task blocked on a full transmitter buffer sleeps, not spins
  *
  *  License:
  *		This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -45,6 +50,8 @@
 #define _RS232_H_
 
 #include <avr/interrupt.h>					// Header for AVR interrupt programming
+#include "FreeRTOS.h"						// Header for the FreeRTOS RTOS
+#include "semphr.h"							// Semaphores which wake a waiting task
 #include "base232.h"						// Grab the base RS232-style header file
 #include "emstream.h"				// Pull in the base class header file
 
@@ -73,14 +80,104 @@
 	#endif
 #endif
 
+// The transmitter's data register empty interrupt is found in the same way as the
+// character received interrupt above
+#if defined USART_UDRE_vect
+	#define RSI_DATA_EMPTY_INT_0 USART_UDRE_vect
+#elif defined USART0_UDRE_vect
+	#define RSI_DATA_EMPTY_INT_0 USART0_UDRE_vect
+#else
+	#error Unable to determine data register empty interrupt vector for this chip
+#endif
+
+#if defined UCSR1A
+	#if defined USART1_UDRE_vect
+		#define RSI_DATA_EMPTY_INT_1 USART1_UDRE_vect
+	#endif
+#endif
+
 /** This is the size of the buffer which holds characters received by the serial port.
  *  It is usually set to something fairly large (~100 bytes) so that we don't miss
  *  incoming characters. However, when run on an AVR with very little RAM such as an
  *  ATmega8, ATmega32, ATmega324P or similar, it should usually be set smaller, for
- *  example 20 ~ 30 bytes or so. 
+ *  example 20 ~ 30 bytes or so. It must be a power of two, as the buffer is an
+ *  \c SpscRing; a size of 128 or less lets the buffer use one-byte indices. 
  */
 #define RSINT_BUF_SIZE		32
 
+/** This is the default size of the buffer which holds characters waiting to be sent
+ *  by the serial port. One place in the buffer is always left empty, so it holds one
+ *  character fewer than this. A different size can be given to each port when its 
+ *  \c rs232 object is constructed. 
+ */
+#define RSINT_TX_BUF_SIZE	64
+
+/** This is the longest time, in RTOS ticks, that a task sending with the policy
+ *  \c RS232_TX_BLOCK sleeps waiting for room in a full transmitter buffer before the
+ *  character is dropped. Even at 9600 baud the buffer empties in well under this time
+ *  unless the port is stuck. 
+ */
+#define UART_TX_TOUT_TICKS	(200 / portTICK_PERIOD_MS)
+
+
+/** This type is a function which the character received interrupt calls with each
+ *  character, instead of putting the character into the receiver buffer. It runs in
+ *  the ISR, so it must be quick and must never wait; a decoder which works on one
+ *  character at a time, such as a \c frame_decoder, is the sort of thing it's for. 
+ *  It returns true to wake the task waiting in \c rs232::wait_for_rx(), such as 
+ *  when a whole message has arrived. 
+ */
+typedef bool (*rs232_rx_hook) (uint8_t);
+
+/// A delimiter for \c rs232::enable_rx_wake() which means "don't wake on any character"
+#define RS232_NO_DELIMITER	(-1)
+
+
+/** This enumeration holds the things which \c rs232::putchar() can do when a char-
+ *  acter is to be sent but the transmitter buffer is full. 
+ */
+enum rs232_tx_policy
+{
+	RS232_TX_BLOCK,							///< Wait until there's room in the buffer
+	RS232_TX_DROP,							///< Throw away the new character
+	RS232_TX_OVERWRITE						///< Throw away the oldest waiting character
+};
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This structure holds a buffer of characters waiting to be sent by a serial
+ *  port, along with the things which the data register empty interrupt service 
+ *  routine needs to know in order to send them. There is one of these structures for
+ *  each serial port; it's shared by the \c rs232 object and the ISR. 
+ */
+
+struct rs232_tx_buffer
+{
+	uint8_t* p_data;						///< Memory in which characters wait
+	uint16_t size;							///< Size of the memory in characters
+	volatile uint16_t read_index;			///< Where the ISR gets the next character
+	volatile uint16_t write_index;			///< Where the next character will be put
+	volatile uint8_t* p_UDR;				///< Pointer to the USART data register
+	volatile uint8_t* p_USR;				///< Pointer to the USART status register
+	volatile uint8_t* p_UCR;				///< Pointer to the USART control register
+	uint8_t mask_TXC;						///< Bitmask for transmission complete, TXC
+	uint8_t mask_UDRIE;						///< Bitmask for data empty interrupt enable
+};
+
+
+//-------------------------------------------------------------------------------------
+/** \brief This structure holds what the character received interrupt service routine 
+ *  needs to know in order to wake a task which is waiting for characters. There is
+ *  one of these structures for each serial port.
+ */
+
+struct rs232_rx_wake
+{
+	SemaphoreHandle_t signal;				///< Given by the ISR; NULL if not in use
+	int16_t delimiter;						///< Character which wakes the task, or -1
+	uint8_t threshold;						///< Characters waiting which wake it, or 0
+};
+
 
 //-------------------------------------------------------------------------------------
 /** \brief This class controls a UART (Universal Asynchronous Receiver Transmitter), 
@@ -95,10 +192,34 @@
  *  In the version in files \c rs232int.* this class installs an interrupt service
  *  routine (ISR) for receiving characters. When characters arrive in the UART, they
  *  are placed in a buffer whose size is configurable with the macro \c RSINT_BUF_SIZE.
- *  Calls to \c getchar() will check the buffer for received characters. This method,
+ *  Calls to \c getchar() will check the buffer for received characters. The buffer
+ *  is an \c SpscRing, so the ISR and the task which reads characters never need to
+ *  turn interrupts off; characters which arrive when it's full are thrown away and 
+ *  counted (see \c get_rx_dropped() ). This method,
  *  as opposed to polling the receiver without using interrupts, allows much higher
- *  data rates to be reliably supported in a multitasking program. Sending of 
- *  characters is currently not interrupt based. 
+ *  data rates to be reliably supported in a multitasking program. 
+ * 
+ *  Characters to be sent are also put into a buffer, and the USART's data register
+ *  empty interrupt takes them out and sends them one at a time. A task which prints
+ *  a line of text therefore only waits as long as it takes to copy the text into the
+ *  buffer, not the tens of milliseconds needed to send it at 9600 baud. The size of 
+ *  the transmitter buffer can be chosen for each port. What happens when the buffer
+ *  is full depends on the port's \c rs232_tx_policy: the sending task can wait for 
+ *  room as it always had to in earlier versions (\c RS232_TX_BLOCK), or the new 
+ *  character (\c RS232_TX_DROP) or the oldest waiting one (\c RS232_TX_OVERWRITE) 
+ *  can be thrown away so that the task never waits. The number of characters thrown
+ *  away and the largest number which have ever been waiting in the buffer are kept
+ *  so that the buffer size can be tuned. Inserting \c send_now into a line of 
+ *  \c << stuff, or calling \c transmit_now(), waits until everything in the buffer
+ *  has been sent. 
+ * 
+ *  A task which reads the port doesn't have to keep waking up to check for charac-
+ *  ters. After \c enable_rx_wake() has been called, \c wait_for_rx() puts the task
+ *  to sleep until the receiver ISR sees a given delimiter, such as the end of a line,
+ *  or until a given number of characters are waiting. The ISR wakes the task right
+ *  away rather than at the next RTOS tick, so the delay between the last character
+ *  of a message arriving and the task handling it is a few microseconds, not a 
+ *  polling period. 
  * 
  *  \section Usage
  *  To create and use a serial port driver object requires only code such as the
@@ -121,18 +242,78 @@ class rs232 : public emstream, public base232
 	protected:
 		uint8_t port_num;					///< The USART number, 0 or 1
 
+		/// Pointer to the buffer and registers used to send characters through the port
+		rs232_tx_buffer* p_xmt;
+
+		/// Pointer to what the receiver ISR uses to wake a task waiting for characters
+		rs232_rx_wake* p_wake;
+
+		/// What to do with a new character when the transmitter buffer is full
+		rs232_tx_policy tx_policy;
+
+		/// The number of characters which were thrown away because the buffer was full
+		uint32_t tx_dropped;
+
+		/// The largest number of characters which have been waiting to be sent
+		uint16_t tx_peak;
+
+		// Send one character from the transmitter buffer if the USART is ready for it
+		bool send_from_buffer (void);
+
+		// Find how many characters are waiting in the transmitter buffer
+		uint16_t tx_waiting (void);
+
 	// Public methods can be called from anywhere in the program where there is a 
 	// pointer or reference to an object of this class
 	public:
 		// The constructor sets up the UART, saving its baud rate and port number
-		rs232 (uint16_t = 9600, uint8_t = 0);
+		rs232 (uint16_t = 9600, uint8_t = 0, uint16_t = RSINT_TX_BUF_SIZE, 
+			   rs232_tx_policy = RS232_TX_BLOCK);
 
 		// This method writes one character to the serial port.
 		void putchar (char);
 
 		bool check_for_char (void);         // Check if a character is in the buffer
 		char getchar (void);                // Get a character; wait if none is ready
+		uint16_t get_rx_dropped (void);     // How many received characters were lost
+		void set_rx_hook (rs232_rx_hook);   // Have the ISR hand characters to a function
+
+		// Have the receiver ISR wake a waiting task at a delimiter or threshold
+		void enable_rx_wake (int16_t delimiter = RS232_NO_DELIMITER, 
+							 uint8_t threshold = 1);
+
+		// Sleep until the receiver ISR wakes this task or a timeout runs out
+		bool wait_for_rx (TickType_t timeout = portMAX_DELAY);
 		void clear_screen (void);           // Send the 'clear display screen' code
+		void transmit_now (void);           // Wait until the buffer has been sent
+
+		/** This method changes what is done when a character is to be sent but the
+		 *  transmitter buffer is full. 
+		 *  @param new_policy The new policy, such as \c RS232_TX_DROP
+		 */
+		void set_tx_policy (rs232_tx_policy new_policy)
+		{
+			tx_policy = new_policy;
+		}
+
+		/** This method returns the number of characters which have been thrown away
+		 *  because they were sent when the transmitter buffer was full. 
+		 *  @return The number of characters dropped since the port was set up
+		 */
+		uint32_t get_tx_dropped (void)
+		{
+			return (tx_dropped);
+		}
+
+		/** This method returns the largest number of characters which have been
+		 *  waiting in the transmitter buffer at one time. If it's near the size of 
+		 *  the buffer, a larger buffer might stop tasks from waiting or dropping text.
+		 *  @return The peak number of characters in the transmitter buffer
+		 */
+		uint16_t get_tx_peak (void)
+		{
+			return (tx_peak);
+		}
 };
 
 #endif  // _RS232_H_
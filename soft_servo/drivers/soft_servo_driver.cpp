@@ -11,6 +11,10 @@
  *  @author Anthony Lombardi
  *
  *  Revisions: @ 5/5/2016 Initial version.
+ *             @ 10/16/2026 ERR pulses made by a sorted chain of compare match
+ *             interrupts on Timer 4, with the worst edge lateness measured
+ *             @ 10/16/2026 ERR set_pulse_us() keeps widths within the servo range,
+ *             and a frame due too soon after the last edge is started at once
  * 
  *  License:
  *    This file is copyright 2016 by Anthony Lombardi and released under the Lesser
@@ -58,9 +62,19 @@
 
 #include "soft_servo_driver.h"
 
+
+/// The length of a frame in Timer 4 counts
+#define FRAME_COUNTS ((uint16_t)(SOFT_SERVO_FRAME_US * SOFT_SERVO_COUNTS_PER_US))
+
+// The driver whose pulses are made by the Timer 4 compare match A interrupt
+soft_servo_driver* p_soft_servo = NULL;
+
 //-----------------------------------------------------------------------------
 /** @brief   This is the constructor for a software-driven servo driver task.
  *  @details The constructor sets up the servo driver itself, not the attached servos.
+ *           Timer 4 is started counting freely at F_CPU / 8 and its compare match A
+ *           interrupt is turned on; until servos are attached, each interrupt only
+ *           schedules the next frame. Only one of these drivers can be made.
  *  @param a_serial_port Pointer to the serial port that debug statements will go to.
  *  @param a_capacity Attached-servo capacity of the driver. Defaults to 8.
  */
@@ -73,6 +87,24 @@ soft_servo_driver::soft_servo_driver (
     servo_max = a_capacity;
     servs = new sserv[servo_max];
     servo_ins = 0;
+
+    edges = new servo_edge[servo_max];
+    edge_count = 0;
+    edge_index = 0;
+    dirty = false;
+    max_lateness = 0;
+
+    // Timer 4 in normal mode, counting freely; OCR4A is moved along each edge
+    portENTER_CRITICAL ();
+    p_soft_servo = this;
+    TCCR4A = 0;
+    TCCR4B = (1 << CS41);
+    frame_start = TCNT4;
+    OCR4A = frame_start + FRAME_COUNTS;
+    TIFR4 = (1 << OCF4A);
+    TIMSK4 |= (1 << OCIE4A);
+    portEXIT_CRITICAL ();
+
     DBG(serial, "Servo driver ready." << endl);
 }
 
@@ -93,12 +125,260 @@ uint8_t soft_servo_driver::attach (
         DBG(serial, "Servo attachment limit reached! Try increasing capacity." << endl);
         return -1;
     }
-    servs[servo_ins] = sserv(a_port,a_pin,a_duty_cycle,a_angle_max,a_angle_min);
+    sserv new_servo = sserv(a_port,a_pin,a_duty_cycle,a_angle_max,a_angle_min);
+    find_pulse (new_servo);
+
+    // the ISR reads the list, so keep it out while the servo is added
+    portENTER_CRITICAL ();
+    servs[servo_ins] = new_servo;
     servo_ins++;
+    dirty = true;
+    portEXIT_CRITICAL ();
     
     return servo_ins-1; // return the index of the new servo
 }
 
+//-----------------------------------------------------------------------------
+/** @brief   Find a servo's pulse width in timer counts from its angle.
+ *  @details The angle range from @c min to @c max given to attach() is spread
+ *           evenly over pulses from SOFT_SERVO_MIN_US to SOFT_SERVO_MAX_US.
+ *  @param servo The servo whose @c dcy angle is used and @c pulse is set
+ */
+void soft_servo_driver::find_pulse (sserv& servo)
+{
+    uint16_t angle = servo.dcy;
+    if (angle < servo.min) { angle = servo.min; }
+    if (angle > servo.max) { angle = servo.max; }
+
+    uint32_t pulse_us = SOFT_SERVO_MIN_US;
+    if (servo.max > servo.min)
+    {
+        pulse_us += (uint32_t)(angle - servo.min)
+                    * (SOFT_SERVO_MAX_US - SOFT_SERVO_MIN_US) / (servo.max - servo.min);
+    }
+    servo.pulse = (uint16_t)(pulse_us * SOFT_SERVO_COUNTS_PER_US);
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   Move a servo to an angle.
+ *  @details The new pulse width is used from the start of the next frame.
+ *  @param index The number returned by attach() for the servo
+ *  @param angle The angle, between the min and max given to attach()
+ */
+void soft_servo_driver::set_angle (uint8_t index, uint16_t angle)
+{
+    if (index >= servo_ins)
+    {
+        return;
+    }
+    sserv servo = servs[index];
+    servo.dcy = angle;
+    find_pulse (servo);
+
+    portENTER_CRITICAL ();
+    servs[index].dcy = angle;
+    if (servs[index].pulse != servo.pulse)
+    {
+        servs[index].pulse = servo.pulse;
+        dirty = true;
+    }
+    portEXIT_CRITICAL ();
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   Set a servo's pulse width directly.
+ *  @details The width is kept between SOFT_SERVO_MIN_US and SOFT_SERVO_MAX_US,
+ *           as widths found from angles are. The ISR counts on the first edge
+ *           of a frame being far enough from its start to sort the edges, and
+ *           the last one far enough from its end to set up the next frame.
+ *  @param index The number returned by attach() for the servo
+ *  @param pulse_us The pulse width in microseconds
+ */
+void soft_servo_driver::set_pulse_us (uint8_t index, uint16_t pulse_us)
+{
+    if (index >= servo_ins)
+    {
+        return;
+    }
+    if (pulse_us < SOFT_SERVO_MIN_US) { pulse_us = SOFT_SERVO_MIN_US; }
+    if (pulse_us > SOFT_SERVO_MAX_US) { pulse_us = SOFT_SERVO_MAX_US; }
+    uint16_t pulse = pulse_us * SOFT_SERVO_COUNTS_PER_US;
+
+    portENTER_CRITICAL ();
+    if (servs[index].pulse != pulse)
+    {
+        servs[index].pulse = pulse;
+        dirty = true;
+    }
+    portEXIT_CRITICAL ();
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   Sort the servos by pulse width into the list of edges.
+ *  @details This is an insertion sort, which is quick for the few servos one
+ *           processor can run and quicker still when the order hasn't changed,
+ *           as it usually hasn't. Servos on the same port whose pulses end at
+ *           the same time share one edge, so their pins drop together. It's
+ *           called by the ISR at most once per frame, and only when a pulse
+ *           width has changed.
+ */
+void soft_servo_driver::build_schedule (void)
+{
+    edge_count = 0;
+    for (uint8_t index = 0; index < servo_ins; index++)
+    {
+        volatile uint8_t* port = servs[index].port;
+        uint8_t mask = (1 << servs[index].pin);
+        uint16_t offset = servs[index].pulse;
+
+        // Find where the edge goes, merging it with one just like it
+        uint8_t place = edge_count;
+        bool merged = false;
+        for (uint8_t scan = 0; scan < edge_count; scan++)
+        {
+            if (edges[scan].offset == offset && edges[scan].port == port)
+            {
+                edges[scan].mask |= mask;
+                merged = true;
+                break;
+            }
+            if (edges[scan].offset > offset && place == edge_count)
+            {
+                place = scan;
+            }
+        }
+        if (merged)
+        {
+            continue;
+        }
+
+        for (uint8_t move = edge_count; move > place; move--)
+        {
+            edges[move] = edges[move - 1];
+        }
+        edges[place].port = port;
+        edges[place].mask = mask;
+        edges[place].offset = offset;
+        edge_count++;
+    }
+    dirty = false;
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   Make the next edge or start a new frame.
+ *  @details At the start of a frame every pin is raised, one edge's worth at a
+ *           time, and if any pulse width has changed the edges are sorted
+ *           again; the first falling edge is at least SOFT_SERVO_MIN_US away,
+ *           so there's plenty of time. After that each interrupt drops the pins
+ *           of one edge. Edges due within SOFT_SERVO_MIN_LEAD counts are made in
+ *           the same interrupt by waiting for each one, since the compare match
+ *           for an edge can't be set up once its time has nearly come. Then
+ *           OCR4A is set to the time of the next edge, or the next frame. If
+ *           the edges were so late that the next frame is also too near, this
+ *           waits for it and starts it at once, rather than missing the compare
+ *           match and starting it a whole timer period late.
+ *
+ *           How late each edge is made is measured from Timer 4 and the worst is
+ *           kept. Raising the pins takes about 10 cycles per edge, so the last
+ *           pin in a frame rises about 0.6 us per channel after the first. A
+ *           falling edge is late by the interrupt latency, about 4 us, plus the
+ *           longest time another interrupt or critical section holds off this
+ *           one; with N servos there are at most N + 1 short interrupts per frame.
+ */
+void soft_servo_driver::isr (void)
+{
+    uint16_t due = OCR4A;
+
+    if (edge_index >= edge_count)
+    {
+        // A new frame: raise all the pins, then sort the edges if need be
+        frame_start = due;
+        for (uint8_t index = 0; index < edge_count; index++)
+        {
+            *(edges[index].port) |= edges[index].mask;
+        }
+        uint16_t late = TCNT4 - due;
+        if (late > max_lateness)
+        {
+            max_lateness = late;
+        }
+        if (dirty)
+        {
+            build_schedule ();
+        }
+        edge_index = 0;
+    }
+    else
+    {
+        // The next falling edge, plus any others due too soon to wait for
+        do
+        {
+            due = frame_start + edges[edge_index].offset;
+            while ((int16_t)(due - TCNT4) > 0)
+            {
+            }
+            *(edges[edge_index].port) &= ~(edges[edge_index].mask);
+
+            uint16_t late = TCNT4 - due;
+            if (late > max_lateness)
+            {
+                max_lateness = late;
+            }
+            edge_index++;
+        }
+        while (edge_index < edge_count
+               && (int16_t)(frame_start + edges[edge_index].offset - TCNT4)
+                  < SOFT_SERVO_MIN_LEAD);
+    }
+
+    uint16_t next = frame_start + ((edge_index < edge_count)
+                                   ? edges[edge_index].offset : FRAME_COUNTS);
+    OCR4A = next;
+
+    if (edge_index >= edge_count && (int16_t)(next - TCNT4) < SOFT_SERVO_MIN_LEAD)
+    {
+        // Wait until the match is surely past, so its flag can be cleared
+        // rather than running this ISR again as soon as it returns
+        while ((int16_t)(next - TCNT4) >= 0)
+        {
+        }
+        TIFR4 = (1 << OCF4A);
+        isr ();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   Get the latest any edge has been made since measuring began.
+ *  @return  The worst lateness in microseconds
+ */
+uint16_t soft_servo_driver::get_max_lateness_us (void)
+{
+    portENTER_CRITICAL ();
+    uint16_t late = max_lateness;
+    portEXIT_CRITICAL ();
+
+    return (late / SOFT_SERVO_COUNTS_PER_US);
+}
+
+
+//-----------------------------------------------------------------------------
+/** @brief   This is the Timer 4 compare match A interrupt, which makes all the
+ *           edges of the software servo pulses.
+ */
+ISR (TIMER4_COMPA_vect)
+{
+    if (p_soft_servo != NULL)
+    {
+        p_soft_servo->isr ();
+    }
+}
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   This overloaded operator prints information about a software servo driver.
  *  @details It prints out appropriate information about the servo driver being delivered in the parameter.
@@ -111,7 +391,9 @@ emstream& operator << (emstream &serpt, soft_servo_driver &servo)
 {
     // Prints info to serial
     serpt   << PMS ("Software Servo Driver Says hi with ") << servo.get_count() 
-            << PMS (" of ") << servo.get_max() << PMS ("servos attached.") << endl;
+            << PMS (" of ") << servo.get_max() << PMS ("servos attached.") << endl
+            << PMS ("Worst edge lateness: ") << servo.get_max_lateness_us()
+            << PMS (" us") << endl;
     
     return (serpt);
 }
@@ -3,11 +3,17 @@
  *  @brief     This is the header file for the software servo driver task class.
  *
  *  @details   This is the header for a class that will control the operation of
- *             servo motors using a software PWM task.
+ *             servo motors using a software PWM task. The pulses for all the
+ *             servos are made by one chain of Timer 4 compare match interrupts:
+ *             one at the start of each 20 ms frame which raises every servo pin,
+ *             then one for each different pulse width, in order from shortest
+ *             to longest, which drops the pins whose pulses are done.
  *
  *  @author Anthony Lombardi
  *
  *  Revisions: @ 5/5/2016 Initial version
+ *             @ 10/16/2026 ERR pulses made by a sorted chain of compare match
+ *             interrupts on Timer 4, with the worst edge lateness measured
  *  License:
  *    This file is copyright 2016 by Anthony Lombardi and released under the Lesser
  *    GNU
@@ -48,6 +54,20 @@
 #include "queue.h"                          // Header for FreeRTOS queues
 #include "semphr.h"                         // Header for FreeRTOS semaphores
 
+
+/// The length of one frame, from the start of one set of pulses to the next
+#define SOFT_SERVO_FRAME_US     20000
+/// The pulse width at the low end of a servo's range
+#define SOFT_SERVO_MIN_US       1000
+/// The pulse width at the high end of a servo's range
+#define SOFT_SERVO_MAX_US       2000
+/// Timer 4 runs at F_CPU / 8, which is 2 counts per microsecond at 16 MHz
+#define SOFT_SERVO_COUNTS_PER_US (F_CPU / 8000000UL)
+/** Edges due within this many timer counts of the current one are made in the
+ *  same interrupt, waiting for each one, because there isn't time to leave the
+ *  ISR and come back; 40 counts is 20 us. */
+#define SOFT_SERVO_MIN_LEAD     40
+
 //-------------------------------------------------------------------------------------
 /** @brief   This class will create a servo motor driver task.
  *  @details This class sets up a driver for software-driven servos.
@@ -63,6 +83,8 @@ class soft_servo_driver
                 volatile uint8_t* port;
                 uint8_t  pin;
                 uint16_t cycle_prog, dcy, max, min;
+                /// pulse width in Timer 4 counts, found from dcy
+                uint16_t pulse;
                 sserv(uint8_t*, uint8_t, uint16_t, uint16_t, uint16_t, uint16_t);
                 // represents a single servo object
                 sserv (
@@ -79,6 +101,7 @@ class soft_servo_driver
                     dcy = a_duty_cycle;
                     max = a_angle_max;
                     min = a_angle_min;
+                    pulse = 0;
                 }
                 // parameterless constructor
                 sserv ()
@@ -95,6 +118,32 @@ class soft_servo_driver
         /// Remembers the maximum size of the array.
         uint8_t servo_max;
 
+        /// One falling edge: the pins on one port whose pulses end together
+        struct servo_edge
+        {
+            volatile uint8_t* port;
+            uint8_t mask;
+            uint16_t offset;                ///< Timer counts after frame start
+        };
+        /// The falling edges, sorted from the shortest pulse to the longest
+        servo_edge* edges;
+        /// How many edges are in the list
+        uint8_t edge_count;
+        /// The next edge to be made; edge_count means the next frame start
+        uint8_t edge_index;
+        /// The Timer 4 count at which the current frame started
+        uint16_t frame_start;
+        /// Set when a pulse width changes, so the edges are sorted again
+        volatile bool dirty;
+        /// The latest any edge has been made, in timer counts
+        uint16_t max_lateness;
+
+        // Sort the servos by pulse width into the list of edges
+        void build_schedule (void);
+
+        // Find a servo's pulse width from its angle
+        void find_pulse (sserv& servo);
+
         ///set the public constructor and the public methods
     public:
         soft_servo_driver (
@@ -111,6 +160,21 @@ class soft_servo_driver
         );
         uint8_t get_count () { return servo_ins; }
         uint8_t get_max () { return servo_max; }
+
+        // Move a servo to an angle between the min and max given to attach()
+        void set_angle (uint8_t index, uint16_t angle);
+
+        // Set a servo's pulse width directly, in microseconds
+        void set_pulse_us (uint8_t index, uint16_t pulse_us);
+
+        // Make the next edge or start a frame; called only by the Timer 4 ISR
+        void isr (void);
+
+        // Get the latest any edge has been made, in microseconds
+        uint16_t get_max_lateness_us (void);
+
+        /// Start measuring edge lateness over again
+        void clear_lateness (void) { max_lateness = 0; }
         
     /*
     /// pointer to the comp register
@@ -141,6 +205,9 @@ class soft_servo_driver
  *                            together things to write with @c << operators
  */
 emstream& operator << (emstream& serpt, soft_servo_driver& srvdrv);
+
+/// Pointer to the software servo driver run by the Timer 4 interrupt
+extern soft_servo_driver* p_soft_servo;
 //closes the removal of the code
 #endif // SOFT_SERVO
 
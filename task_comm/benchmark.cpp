@@ -0,0 +1,504 @@
+//**************************************************************************************
+/** \file benchmark.cpp
+ *    This file contains functions which measure how many processor cycles are taken
+ *    by the inter-task communication classes in the ME405 library. Each operation is
+ *    run many times at the highest task priority, and the time taken by an empty loop
+ *    is subtracted. The scheduler can't simply be suspended, as the RTOS tick count
+ *    which the time stamps use doesn't advance while it is. Interrupts are left on,
+ *    so the tick interrupt's time is included in each result, but it adds only a few
+ *    percent. When the program is run on a PC through the POSIX host port, processor
+ *    cycles can't be counted, so times are given in nanoseconds instead; only the
+ *    ratios between those numbers matter.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, with a comparison of share reading and writing
+ *    \li 10-16-2026 ERR Added a test of how fast text queues carry characters
+ *    \li 10-16-2026 ERR Added a comparison of time stamps with the fast clock
+ *    \li 10-16-2026 ERR Added a comparison of floating and fixed-point sensor scaling
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // FreeRTOS inter-task communication queues
+#include "time_stamp.h"                     // Class to implement a microsecond timer
+#include "taskshare.h"                      // Header for thread-safe shared data
+#include "textqueue.h"                      // Header for a "<<" queue class
+#include "vector3q.h"                       // Fixed-point vectors and scale factors
+
+#include "benchmark.h"                      // Header for this file
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   A share which works the way @c TaskShare did before @c ShareData existed.
+ *  @details This class is only used as a reference against which the time taken by
+ *           the current shares is compared. Both reading and writing its data are
+ *           done inside critical sections.
+ */
+
+template <class DataType> class CriticalShare
+{
+	protected:
+		DataType the_data;					///< Holds the data to be shared
+
+	public:
+		/** @brief   Put data into the share inside a critical section.
+		 *  @param   new_data The data which is to be written
+		 */
+		void put (DataType new_data)
+		{
+			portENTER_CRITICAL ();
+			the_data = new_data;
+			portEXIT_CRITICAL ();
+		}
+
+		/** @brief   Read data from the share inside a critical section.
+		 *  @return  The current value of the shared data item
+		 */
+		DataType get (void)
+		{
+			DataType temporary_copy;
+
+			portENTER_CRITICAL ();
+			temporary_copy = the_data;
+			portEXIT_CRITICAL ();
+
+			return (temporary_copy);
+		}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   A text queue which works the way @c TextQueue did before it had a buffer.
+ *  @details This class is only used as a reference against which the speed of the
+ *           current text queue is compared. Every character goes through its own
+ *           call to @c xQueueSendToBack() and @c xQueueReceive().
+ */
+
+class CharQueue : public emstream
+{
+	protected:
+		QueueHandle_t the_queue;			///< The handle for the queue we use
+
+	public:
+		/** @brief   Create a FreeRTOS queue which holds characters.
+		 *  @param   queue_size The number of characters which can be stored
+		 */
+		CharQueue (uint16_t queue_size) : emstream ()
+		{
+			the_queue = xQueueCreate (queue_size, sizeof (char));
+		}
+
+		/** @brief   Send one character to the back of the queue.
+		 *  @param   a_char The character to be sent to the queue
+		 */
+		void putchar (char a_char)
+		{
+			xQueueSendToBack (the_queue, &a_char, portMAX_DELAY);
+		}
+
+		/** @brief   Check if a character is in the queue.
+		 *  @return  True for character available, false for no character available
+		 */
+		bool check_for_char (void)
+		{
+			return (uxQueueMessagesWaiting (the_queue));
+		}
+
+		/** @brief   Read one character from the queue.
+		 *  @return  The character which was received from the queue
+		 */
+		char getchar (void)
+		{
+			char recv_char;
+
+			xQueueReceive (the_queue, &recv_char, portMAX_DELAY);
+			return (recv_char);
+		}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This function finds the number of microseconds since a given time.
+ *  @param start The time at which the measurement began
+ *  @return The number of microseconds since @c start
+ */
+
+static uint32_t microsec_since (time_stamp& start)
+{
+	time_stamp duration;					// Time since the start
+
+	duration.set_to_now ();
+	duration -= start;
+
+	return (duration.get_seconds () * 1000000UL + duration.get_microsec ());
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints the number of processor cycles taken by one run of an
+ *  operation, with one digit after the decimal point. On a PC the number printed is
+ *  the number of nanoseconds instead.
+ *  @param p_ser_dev Pointer to a serial device on which to print the result
+ *  @param op_us The time taken by @c BENCH_RUNS runs of the operation
+ *  @param empty_us The time taken by @c BENCH_RUNS runs of an empty loop
+ */
+
+static void print_cycles (emstream* p_ser_dev, uint32_t op_us, uint32_t empty_us)
+{
+	uint32_t tenths = 0;					// Tenths of a cycle per operation
+
+	if (op_us > empty_us)
+	{
+		#ifdef POSIX_HOST
+			tenths = (op_us - empty_us) * 10000UL / BENCH_RUNS;
+		#else
+			tenths = (op_us - empty_us) * (configCPU_CLOCK_HZ / 100000UL) / BENCH_RUNS;
+		#endif
+	}
+	*p_ser_dev << '\t' << (tenths / 10) << '.' << (uint8_t)(tenths % 10);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function times reading and writing one type of data in a current share and
+ *  in a share which uses critical sections, then prints a line with the results.
+ *  @param p_ser_dev Pointer to a serial device on which to print the results
+ *  @param type_name The name of the data type, which begins the printed line
+ */
+
+template <class DataType>
+static void bench_share_type (emstream* p_ser_dev, const char* type_name)
+{
+	CriticalShare<DataType> old_share;		// A share as they used to be
+	ShareData<DataType> new_share;			// The way the data in shares is kept now
+	volatile DataType result;				// Holds data so it isn't optimized away
+	time_stamp start;						// Time at which each measurement begins
+	uint32_t empty_us, old_get_us, new_get_us, old_put_us, new_put_us;
+
+	old_share.put (0);
+	new_share.put (0);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = (DataType)count;
+	}
+	empty_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = old_share.get ();
+	}
+	old_get_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = new_share.get ();
+	}
+	new_get_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		old_share.put ((DataType)count);
+	}
+	old_put_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		new_share.put ((DataType)count);
+	}
+	new_put_us = microsec_since (start);
+
+	(void)result;
+
+	*p_ser_dev << type_name;
+	print_cycles (p_ser_dev, old_get_us, empty_us);
+	print_cycles (p_ser_dev, new_get_us, empty_us);
+	print_cycles (p_ser_dev, old_put_us, empty_us);
+	print_cycles (p_ser_dev, new_put_us, empty_us);
+	*p_ser_dev << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function compares the time taken to read and write shares holding data of
+ *  several sizes. The "old" columns are for shares which use critical sections for
+ *  both reading and writing, as all shares once did; the "new" columns are for the
+ *  @c ShareData storage now used by @c TaskShare.
+ *  @param p_ser_dev Pointer to a serial device on which to print the results
+ */
+
+void bench_shares (emstream* p_ser_dev)
+{
+	#ifdef POSIX_HOST
+		*p_ser_dev << PMS ("Share timing, host nanoseconds per call") << endl;
+	#else
+		*p_ser_dev << PMS ("Share timing, CPU cycles per call") << endl;
+	#endif
+	*p_ser_dev << PMS ("Type\told get\tnew get\told put\tnew put") << endl
+			   << PMS ("----\t-------\t-------\t-------\t-------") << endl;
+
+	// Keep other tasks from running so that only the code being tested is timed
+	UBaseType_t old_priority = uxTaskPriorityGet (NULL);
+	vTaskPrioritySet (NULL, configMAX_PRIORITIES - 1);
+
+	bench_share_type<uint8_t> (p_ser_dev, "uint8_t");
+	bench_share_type<int16_t> (p_ser_dev, "int16_t");
+	bench_share_type<int32_t> (p_ser_dev, "int32_t");
+	bench_share_type<float> (p_ser_dev, "float");
+
+	vTaskPrioritySet (NULL, old_priority);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function sends lines of text through a text queue and reads them back out,
+ *  counting the characters which came through. Each line is like the error message
+ *  printed by the data sink task.
+ *  @param p_queue Pointer to the queue which is being tested
+ *  @return The number of characters which were sent through the queue
+ */
+
+static uint32_t send_test_lines (emstream* p_queue)
+{
+	uint32_t chars = 0;						// Number of characters received
+
+	for (uint16_t line = 0; line < BENCH_LINES; line++)
+	{
+		*p_queue << PMS ("ERROR in queue, got ") << hex << (uint32_t)0x12345678
+				 << dec << endl;
+		while (p_queue->check_for_char ())
+		{
+			p_queue->getchar ();
+			chars++;
+		}
+	}
+
+	return (chars);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints the number of characters per second carried by a queue.
+ *  @param p_ser_dev Pointer to a serial device on which to print the result
+ *  @param chars The number of characters sent through the queue
+ *  @param time_us The number of microseconds taken to send them
+ */
+
+static void print_chars_per_sec (emstream* p_ser_dev, uint32_t chars, uint32_t time_us)
+{
+	uint32_t chars_per_sec = 0;				// The result to be printed
+
+	// A 64-bit product is needed, as a million times the characters won't fit in 32
+	if (time_us > 0)
+	{
+		chars_per_sec = (uint32_t)((uint64_t)chars * 1000000UL / time_us);
+	}
+	*p_ser_dev << '\t' << chars_per_sec;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function compares how fast characters can be sent through a text queue and
+ *  read out again. The "old" queue sends each character with its own call to
+ *  @c xQueueSendToBack(), as @c TextQueue once did; the "new" queue is a
+ *  @c TextQueue, which copies each string or number into its buffer as one block.
+ *  Both queues are made once, the first time this function is run, and kept, as
+ *  queues can't be deleted.
+ *  @param p_ser_dev Pointer to a serial device on which to print the results
+ */
+
+void bench_text_queue (emstream* p_ser_dev)
+{
+	static CharQueue* p_old_queue = NULL;	// Queue which sends single characters
+	static TextQueue* p_new_queue = NULL;	// Queue which sends blocks of characters
+	time_stamp start;						// Time at which each measurement begins
+	uint32_t old_chars, new_chars, old_us, new_us;
+
+	if (p_old_queue == NULL)
+	{
+		p_old_queue = new CharQueue (64);
+		p_new_queue = new TextQueue (64, "Benchmark");
+	}
+
+	// Keep other tasks from running so that only the queues are timed
+	UBaseType_t old_priority = uxTaskPriorityGet (NULL);
+	vTaskPrioritySet (NULL, configMAX_PRIORITIES - 1);
+
+	start.set_to_now ();
+	old_chars = send_test_lines (p_old_queue);
+	old_us = microsec_since (start);
+
+	start.set_to_now ();
+	new_chars = send_test_lines (p_new_queue);
+	new_us = microsec_since (start);
+
+	vTaskPrioritySet (NULL, old_priority);
+
+	*p_ser_dev << PMS ("Text queue speed, characters per second") << endl
+			   << PMS ("Chars\told\tnew") << endl
+			   << PMS ("-----\t---\t---") << endl
+			   << new_chars;
+	print_chars_per_sec (p_ser_dev, old_chars, old_us);
+	print_chars_per_sec (p_ser_dev, new_chars, new_us);
+	*p_ser_dev << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function compares the time taken to read the time in microseconds in three
+ *  ways. The "stamp" column is for filling a @c time_stamp and getting microseconds
+ *  from its seconds and microseconds, which needs several 32-bit divisions; "us64" is
+ *  for @c get_time_us(), which returns 64-bit microseconds using only multiplications
+ *  by constants; and "raw" is for @c get_raw_time() followed by @c raw_time_to_us(),
+ *  the cheapest way to time an interval. 
+ *  @param p_ser_dev Pointer to a serial device on which to print the results
+ */
+
+void bench_clock (emstream* p_ser_dev)
+{
+	volatile uint64_t result;				// Holds times so they aren't optimized away
+	time_stamp start;						// Time at which each measurement begins
+	time_stamp now;							// Time stamp read by the old method
+	uint32_t empty_us, stamp_us, us64_us, raw_us;
+	uint32_t raw_start;						// Raw time at the beginning of a loop
+
+	#ifdef POSIX_HOST
+		*p_ser_dev << PMS ("Clock timing, host nanoseconds per call") << endl;
+	#else
+		*p_ser_dev << PMS ("Clock timing, CPU cycles per call") << endl;
+	#endif
+	*p_ser_dev << PMS ("\tstamp\tus64\traw") << endl
+			   << PMS ("\t-----\t----\t---") << endl;
+
+	// Keep other tasks from running so that only the clock reading code is timed
+	UBaseType_t old_priority = uxTaskPriorityGet (NULL);
+	vTaskPrioritySet (NULL, configMAX_PRIORITIES - 1);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = count;
+	}
+	empty_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		now.set_to_now ();
+		result = now.get_seconds () * 1000000UL + now.get_microsec ();
+	}
+	stamp_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = get_time_us ();
+	}
+	us64_us = microsec_since (start);
+
+	raw_start = get_raw_time ();
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		result = raw_time_to_us (get_raw_time () - raw_start);
+	}
+	raw_us = microsec_since (start);
+
+	vTaskPrioritySet (NULL, old_priority);
+
+	(void)result;
+
+	print_cycles (p_ser_dev, stamp_us, empty_us);
+	print_cycles (p_ser_dev, us64_us, empty_us);
+	print_cycles (p_ser_dev, raw_us, empty_us);
+	*p_ser_dev << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function compares the time taken to scale one raw sensor count, such as an
+ *  acceleration from a BNO055 at 100 counts per m/s^2, into useful units. The "div"
+ *  column is for dividing by 100.0 in floating point, as @c bno055_driver once did;
+ *  "mul" is for multiplying by the constant 1.0 / 100.0, and "Q7" is for making a
+ *  fixed-point number with @c FixedScale, which needs only an integer multiply and
+ *  shift. 
+ *  @param p_ser_dev Pointer to a serial device on which to print the results
+ */
+
+void bench_fixed_point (emstream* p_ser_dev)
+{
+	volatile double float_result;			// Holds results so they aren't optimized
+	volatile int16_t fixed_result;			// away by the compiler
+	time_stamp start;						// Time at which each measurement begins
+	uint32_t empty_us, div_us, mul_us, fixed_us;
+
+	#ifdef POSIX_HOST
+		*p_ser_dev << PMS ("Sensor scaling, host nanoseconds per axis") << endl;
+	#else
+		*p_ser_dev << PMS ("Sensor scaling, CPU cycles per axis") << endl;
+	#endif
+	*p_ser_dev << PMS ("\tdiv\tmul\tQ7") << endl
+			   << PMS ("\t---\t---\t--") << endl;
+
+	// Keep other tasks from running so that only the arithmetic is timed
+	UBaseType_t old_priority = uxTaskPriorityGet (NULL);
+	vTaskPrioritySet (NULL, configMAX_PRIORITIES - 1);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		fixed_result = (int16_t)count;
+	}
+	empty_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		float_result = (double)(int16_t)count / 100.0;
+	}
+	div_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		float_result = (double)(int16_t)count * (1.0 / 100.0);
+	}
+	mul_us = microsec_since (start);
+
+	start.set_to_now ();
+	for (uint32_t count = 0; count < BENCH_RUNS; count++)
+	{
+		fixed_result = FixedScale<100, 7, 15>::to_q ((int16_t)count);
+	}
+	fixed_us = microsec_since (start);
+
+	vTaskPrioritySet (NULL, old_priority);
+
+	(void)float_result;
+	(void)fixed_result;
+
+	print_cycles (p_ser_dev, div_us, empty_us);
+	print_cycles (p_ser_dev, mul_us, empty_us);
+	print_cycles (p_ser_dev, fixed_us, empty_us);
+	*p_ser_dev << endl;
+}
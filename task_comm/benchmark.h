@@ -0,0 +1,70 @@
+//**************************************************************************************
+/** \file benchmark.h
+ *    This file contains the headers for functions which measure how many processor
+ *    cycles are taken by the inter-task communication classes in the ME405 library.
+ *
+ *  Revisions:
+ *    \li 10-16-2026 ERR Original file, with a comparison of share reading and writing
+ *    \li 10-16-2026 ERR Added a test of how fast text queues carry characters
+ *    \li 10-16-2026 ERR Added a comparison of time stamps with the fast clock
+ *    \li 10-16-2026 ERR Added a comparison of floating and fixed-point sensor scaling
+ *
+ *  License:
+ *    This file is copyright 2026 by its authors and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUEN-
+ *    TIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ *    OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include "emstream.h"                       // Base for text-type serial port objects
+
+
+/** This constant sets how many times each operation is run while it's being timed.
+ *  The number must be large enough that the time measured is much longer than the
+ *  resolution of the time stamp, about half a microsecond, but the whole run must
+ *  take less than a second. A PC is so much faster than an AVR that it needs many
+ *  more runs.
+ */
+#ifdef POSIX_HOST
+	const uint32_t BENCH_RUNS = 1000000UL;
+#else
+	const uint32_t BENCH_RUNS = 10000UL;
+#endif
+
+
+/** This constant sets how many lines of text are sent through each text queue when
+ *  the speed of text queues is being measured.
+ */
+#ifdef POSIX_HOST
+	const uint16_t BENCH_LINES = 20000;
+#else
+	const uint16_t BENCH_LINES = 200;
+#endif
+
+
+// This function compares the time taken to read and write shares of several sizes
+void bench_shares (emstream* p_ser_dev);
+
+// This function compares how fast characters go through two kinds of text queue
+void bench_text_queue (emstream* p_ser_dev);
+
+// This function compares the time taken to read the time in microseconds three ways
+void bench_clock (emstream* p_ser_dev);
+
+// This function compares floating point and fixed-point scaling of sensor counts
+void bench_fixed_point (emstream* p_ser_dev);
+
+#endif // _BENCHMARK_H_
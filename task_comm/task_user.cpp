@@ -8,6 +8,7 @@
  *    \li 10-05-2012 JRR Split into multiple files, one for each task
  *    \li 10-25-2012 JRR Changed to a more fully C++ version with class task_user
  *    \li 11-04-2012 JRR Modified from the data acquisition example to the test suite
+ *    \li 10-16-2026 ERR Added the 'b' command which runs timing benchmarks
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -29,6 +30,7 @@
 #include <avr/wdt.h>                        // Watchdog timer header
 
 #include "task_user.h"                      // Header for this file
+#include "benchmark.h"                      // Timing tests of communication classes
 
 
 /** This constant sets how many RTOS ticks the task delays if the user's not talking.
@@ -105,6 +107,14 @@ void task_user::run (void)
 					show_status ();
 					break;
 
+				// The 'b' command times communication classes, clocks and arithmetic
+				case 'b':
+					bench_shares (p_serial);
+					bench_text_queue (p_serial);
+					bench_clock (p_serial);
+					bench_fixed_point (p_serial);
+					break;
+
 				// A '?' or 'h' is a plea for help; respond with a help message
 				case '?':
 				case 'h':
@@ -168,6 +178,7 @@ void task_user::print_help_message (void)
 	*p_serial << PMS (" n:  Show the real time NOW") << endl;
 	*p_serial << PMS (" v:  Show program version and setup") << endl;
 	*p_serial << PMS (" s:  Dump all tasks' stacks") << endl;
+	*p_serial << PMS (" b:  Run communication, clock and math benchmarks") << endl;
 	*p_serial << PMS (" h:  Print this help message") << endl;
 	*p_serial << PMS (" +:  Increment test shared var.") << endl;
 	*p_serial << PMS (" -:  Decrement test shared var.") << endl;